@@ -18,196 +18,284 @@
 */
 
 #include "exportfuncs.h"
+#include <QtEndian>
+#include <cstring>
+#include <cfloat>
+#include <cmath>
 
 using namespace std;
 
-void writeBytes(fstream *file, const char* data, size_t length )
+// The file formats store everything big-endian. Multi-byte values are
+// written as a whole block, which keeps the stream calls per value at one
+// instead of one per byte.
+
+#define IO_CHUNK 256
+
+void writeBytes(ostream *file, const char* data, size_t length)
 {
-    for(size_t i = 0; i < length; i++) {
-        file->write(data+length-1-i, 1);
+    char buffer[IO_CHUNK];
+    while(length) {
+        size_t n = length < IO_CHUNK ? length : IO_CHUNK;
+        for(size_t i = 0; i < n; ++i) {
+            buffer[i] = data[length-1-i];
+        }
+        file->write(buffer, n);
+        length -= n;
     }
 }
 
-void writeNulls(fstream *file , size_t length )
+void writeNulls(ostream *file, size_t length)
 {
-    char data[1] = {0x00};
-    for(size_t i = 0; i < length; i++) {
-        writeBytes(file, data, 1);
+    static const char nulls[IO_CHUNK] = {0};
+    while(length) {
+        size_t n = length < IO_CHUNK ? length : IO_CHUNK;
+        file->write(nulls, n);
+        length -= n;
     }
 }
 
-string readString(fstream *file, size_t length)
+void writeFloats(ostream *file, const float* data, size_t count)
 {
-    string temp = "";
-    char c;
-    for(size_t i = 0; i < length; ++i) {
-        file->get(c);
-        temp.append(1, c);
+    uchar buffer[IO_CHUNK*4];
+    while(count) {
+        size_t n = count < IO_CHUNK ? count : IO_CHUNK;
+        for(size_t i = 0; i < n; ++i) {
+            quint32 temp;
+            memcpy(&temp, data+i, 4);
+            qToBigEndian(temp, buffer+4*i);
+        }
+        file->write((const char*)buffer, 4*n);
+        data += n;
+        count -= n;
     }
-    return temp;
 }
 
-bool readNulls(fstream *file, size_t length)
+static string readString(istream *file, size_t length)
 {
-    char c;
-    for(size_t i = 0; i < length; ++i) {
-        file->get(c);
-    }
-    return true;
+    string temp(length, '\0');
+    if(length) file->read(&temp[0], length);
+    return temp;
 }
 
-glm::vec3 readVec3(fstream *file)
+static void readFloats(istream *file, float* data, size_t count)
 {
-    glm::vec3 temp(readFloat(file), readFloat(file), readFloat(file));
-    return temp;
+    uchar buffer[IO_CHUNK*4];
+    while(count) {
+        size_t n = count < IO_CHUNK ? count : IO_CHUNK;
+        file->read((char*)buffer, 4*n);
+        for(size_t i = 0; i < n; ++i) {
+            quint32 temp = qFromBigEndian<quint32>(buffer+4*i);
+            memcpy(data+i, &temp, 4);
+        }
+        data += n;
+        count -= n;
+    }
 }
 
-float readFloat(fstream *file)
+static float readFloat(istream *file)
 {
-    union {
-        char c[4];
-        float f;
-    } temp;
-    file->get(temp.c[3]);
-    file->get(temp.c[2]);
-    file->get(temp.c[1]);
-    file->get(temp.c[0]);
-    return temp.f;
+    uchar buffer[4] = {0, 0, 0, 0};
+    file->read((char*)buffer, 4);
+    quint32 temp = qFromBigEndian<quint32>(buffer);
+    float value;
+    memcpy(&value, &temp, 4);
+    return value;
 }
 
-int readInt(fstream *file)
+static int readInt(istream *file)
 {
-    union {
-        char c[4];
-        int i;
-    } temp;
-    file->get(temp.c[3]);
-    file->get(temp.c[2]);
-    file->get(temp.c[1]);
-    file->get(temp.c[0]);
-    return temp.i;
+    uchar buffer[4] = {0, 0, 0, 0};
+    file->read((char*)buffer, 4);
+    return qFromBigEndian<qint32>(buffer);
 }
 
-bool readBool(fstream *file)
+static bool readBool(istream *file)
 {
-    char temp;
+    char temp = 0;
     file->get(temp);
     return temp != 0;
 }
 
-void readBytes(fstream *file, void* _ptr, size_t length)
+static void readBytes(istream *file, void* _ptr, size_t length)
 {
-    for(size_t i = 0; i < length; i++) {
-        file->read((char*)_ptr+length-1-i, 1);
+    char* data = (char*)_ptr;
+    file->read(data, length);
+    for(size_t i = 0; i < length/2; ++i) {
+        char temp = data[i];
+        data[i] = data[length-1-i];
+        data[length-1-i] = temp;
     }
 }
 
+// vectors are written as one 12 byte block by writeBytes(), which reverses the whole block, so z
+// comes first in the file
+static glm::vec3 readVec3(istream *file)
+{
+    float temp[3];
+    readFloats(file, temp, 3);
+    return glm::vec3(temp[2], temp[1], temp[0]);
+}
 
-void writeBytes(stringstream *file, const char* data, size_t length )
+
+string readString(fstream *file, size_t length)
 {
-    for(size_t i = 0; i < length; i++) {
-        file->write(data+length-1-i, 1);
-    }
+    return readString(static_cast<istream*>(file), length);
 }
 
-void writeNulls(stringstream *file , size_t length )
+bool readNulls(fstream *file, size_t length)
 {
-    char data[1] = {0x00};
-    for(size_t i = 0; i < length; i++) {
-        writeBytes(file, data, 1);
-    }
+    file->ignore(length);
+    return true;
+}
+
+glm::vec3 readVec3(fstream *file)
+{
+    return readVec3(static_cast<istream*>(file));
+}
+
+float readFloat(fstream *file)
+{
+    return readFloat(static_cast<istream*>(file));
 }
 
+void readFloats(fstream *file, float* data, size_t count)
+{
+    readFloats(static_cast<istream*>(file), data, count);
+}
+
+int readInt(fstream *file)
+{
+    return readInt(static_cast<istream*>(file));
+}
+
+bool readBool(fstream *file)
+{
+    return readBool(static_cast<istream*>(file));
+}
+
+void readBytes(fstream *file, void* _ptr, size_t length)
+{
+    readBytes(static_cast<istream*>(file), _ptr, length);
+}
+
+
 string readString(stringstream *file, size_t length)
 {
-    string temp = "";
-    char c;
-    for(size_t i = 0; i < length; ++i) {
-        file->get(c);
-        temp.append(1, c);
-    }
-    return temp;
+    return readString(static_cast<istream*>(file), length);
 }
 
 bool readNulls(stringstream *file, size_t length)
 {
-    char c;
-    for(size_t i = 0; i < length; ++i) {
-        file->get(c);
-        //if(c) return false;
-    }
+    file->ignore(length);
     return true;
 }
 
 glm::vec3 readVec3(stringstream *file)
 {
-    glm::vec3 temp(readFloat(file), readFloat(file), readFloat(file));
-    return temp;
+    return readVec3(static_cast<istream*>(file));
 }
 
 float readFloat(stringstream *file)
 {
-    union {
-        char c[4];
-        float f;
-    } temp;
-    file->get(temp.c[3]);
-    file->get(temp.c[2]);
-    file->get(temp.c[1]);
-    file->get(temp.c[0]);
-    return temp.f;
+    return readFloat(static_cast<istream*>(file));
+}
+
+void readFloats(stringstream *file, float* data, size_t count)
+{
+    readFloats(static_cast<istream*>(file), data, count);
 }
 
 int readInt(stringstream *file)
 {
-    union {
-        char c[4];
-        int i;
-    } temp;
-    file->get(temp.c[3]);
-    file->get(temp.c[2]);
-    file->get(temp.c[1]);
-    file->get(temp.c[0]);
-    return temp.i;
+    return readInt(static_cast<istream*>(file));
 }
 
 bool readBool(stringstream *file)
 {
-    char temp;
-    file->get(temp);
-    return temp != 0;
+    return readBool(static_cast<istream*>(file));
 }
 
 void readBytes(stringstream *file, void* _ptr, size_t length)
 {
-    for(size_t i = 0; i < length; i++) {
-        file->read((char*)_ptr+length-1-i, 1);
-    }
+    readBytes(static_cast<istream*>(file), _ptr, length);
 }
 
-void writeToExportFile(std::fstream *file, QList<bezier_t*> &bezList)
+void writeToExportFile(std::fstream *file, const QVector<bezier_t> &bezList)
 {
     for(int i = 0; i < bezList.size(); ++i) {
-        writeBytes(file, (const char*)&bezList[i]->Kp1.x, 4);
-        writeBytes(file, (const char*)&bezList[i]->Kp1.y, 4);
-        writeBytes(file, (const char*)&bezList[i]->Kp1.z, 4);
-
-        writeBytes(file, (const char*)&bezList[i]->Kp2.x, 4);
-        writeBytes(file, (const char*)&bezList[i]->Kp2.y, 4);
-        writeBytes(file, (const char*)&bezList[i]->Kp2.z, 4);
-
-        writeBytes(file, (const char*)&bezList[i]->P1.x, 4);
-        writeBytes(file, (const char*)&bezList[i]->P1.y, 4);
-        writeBytes(file, (const char*)&bezList[i]->P1.z, 4);
-
-        writeBytes(file, (const char*)&bezList[i]->roll, 4);
-
-        char cTemp = 0xFF;
-        writeBytes(file, &cTemp, 1); // CONT ROLL
-        cTemp = bezList[i]->relRoll ? 0xFF : 0x00;
-        writeBytes(file, &cTemp, 1); // REL ROLL
-        cTemp = 0x00;
-        writeBytes(file, &cTemp, 1); // equal dist CP
-        writeNulls(file, 7); // were 5
+        const bezier_t* cur = &bezList[i];
+        float data[10] = {cur->Kp1.x, cur->Kp1.y, cur->Kp1.z,
+                          cur->Kp2.x, cur->Kp2.y, cur->Kp2.z,
+                          cur->P1.x, cur->P1.y, cur->P1.z,
+                          cur->roll};
+        writeFloats(file, data, 10);
+
+        char flags[10] = {0};
+        flags[0] = (char)0xFF; // CONT ROLL
+        flags[1] = cur->relRoll ? (char)0xFF : 0x00; // REL ROLL
+        flags[2] = 0x00; // equal dist CP, followed by 7 nulls (were 5)
+        file->write(flags, 10);
+    }
+}
+
+bool exportStep(exportprogress_t* progress, int done, int total)
+{
+    if(!progress) return true;
+    progress->total.store(total);
+    progress->done.store(done);
+    return !progress->canceled.load();
+}
+
+// appends value like printf("%.8e"), nine significant digits always read back as the same float
+void appendFloat(QByteArray& out, float value)
+{
+    char buffer[24];
+    char* p = buffer;
+    double v = value;
+
+    if(v != v) {
+        out.append("nan");
+        return;
+    }
+    if(v < 0.0 || (v == 0.0 && 1.f/value < 0.f)) {
+        *p++ = '-';
+        v = -v;
     }
+    if(v > FLT_MAX) {
+        memcpy(p, "inf", 3);
+        out.append(buffer, (int)(p - buffer) + 3);
+        return;
+    }
+
+    int exponent = 0;
+    quint64 digits = 0;
+    if(v > 0.0) {
+        exponent = (int)floor(log10(v));
+        digits = (quint64)(v*pow(10.0, 8-exponent) + 0.5);
+        if(digits >= 1000000000ULL) {
+            digits = (digits + 5)/10;
+            ++exponent;
+        } else if(digits < 100000000ULL) {
+            --exponent;
+            digits = (quint64)(v*pow(10.0, 8-exponent) + 0.5);
+        }
+    }
+
+    char mantissa[9];
+    for(int i = 8; i >= 0; --i) {
+        mantissa[i] = '0' + (char)(digits % 10);
+        digits /= 10;
+    }
+    *p++ = mantissa[0];
+    *p++ = '.';
+    memcpy(p, mantissa + 1, 8);
+    p += 8;
+    *p++ = 'e';
+    *p++ = exponent < 0 ? '-' : '+';
+    if(exponent < 0) exponent = -exponent;
+    if(exponent >= 100) *p++ = '0' + (char)(exponent/100);
+    *p++ = '0' + (char)(exponent/10%10);
+    *p++ = '0' + (char)(exponent%10);
+
+    out.append(buffer, (int)(p - buffer));
 }
@@ -22,11 +22,26 @@
 
 #include <fstream>
 #include <sstream>
+#include <QByteArray>
+#include <QAtomicInt>
 #include "mnode.h"
 
-void writeBytes(std::fstream *file, const char* data, size_t length );
+// shared with a running export, the exporter reports its steps and stops once canceled is set
+typedef struct {
+    QAtomicInt done;
+    QAtomicInt total;
+    QAtomicInt canceled;
+} exportprogress_t;
+
+// sets the steps done so far, returns false if the export should stop
+bool exportStep(exportprogress_t* progress, int done, int total);
+
+void writeBytes(std::ostream *file, const char* data, size_t length);
+
+void writeNulls(std::ostream *file, size_t length);
+
+void writeFloats(std::ostream *file, const float* data, size_t count);
 
-void writeNulls(std::fstream *file , size_t length );
 
 std::string readString(std::fstream *file, size_t length);
 
@@ -36,6 +51,8 @@ glm::vec3 readVec3(std::fstream *file);
 
 float readFloat(std::fstream *file);
 
+void readFloats(std::fstream *file, float* data, size_t count);
+
 int readInt(std::fstream *file);
 
 bool readBool(std::fstream *file);
@@ -43,10 +60,6 @@ bool readBool(std::fstream *file);
 void readBytes(std::fstream *file, void* _ptr, size_t length);
 
 
-void writeBytes(std::stringstream *file, const char* data, size_t length );
-
-void writeNulls(std::stringstream *file , size_t length );
-
 std::string readString(std::stringstream *file, size_t length);
 
 bool readNulls(std::stringstream *file, size_t length);
@@ -55,13 +68,17 @@ glm::vec3 readVec3(std::stringstream *file);
 
 float readFloat(std::stringstream *file);
 
+void readFloats(std::stringstream *file, float* data, size_t count);
+
 int readInt(std::stringstream *file);
 
 bool readBool(std::stringstream *file);
 
 void readBytes(std::stringstream *file, void* _ptr, size_t length);
 
-void writeToExportFile(std::fstream *file, QList<bezier_t*> &bezList);
+void writeToExportFile(std::fstream *file, const QVector<bezier_t> &bezList);
+
+void appendFloat(QByteArray& out, float value);
 
 
 #endif // EXPORTFUNCS_H
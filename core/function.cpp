@@ -148,7 +148,7 @@ float func::changeLength(float newlength, int index)
     return getMaxArgument();
 }
 
-void func::saveFunction(std::fstream& file)
+void func::saveFunction(std::ostream& file)
 {
     file << "FUNC";
     int size = funcList.size();
@@ -57,7 +57,7 @@ public:
 
     int getSubfuncNumber(subfunc* _sub);
 
-    void saveFunction(std::fstream& file);
+    void saveFunction(std::ostream& file);
     void loadFunction(std::fstream& file);
     void legacyLoadFunction(std::fstream& file);
     void saveFunction(std::stringstream& file);
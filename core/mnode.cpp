@@ -142,11 +142,11 @@ glm::vec3 mnode::vDirHeart(float fHeart)
     return glm::normalize(vDir + vLat*(float)(fRollSpeedPerMeter*F_PI*fHeart/180.f));
 }
 
-void mnode::exportNode(QList<bezier_t*> &bezList, mnode *last, mnode*, mnode* anchor, float fHeart, float fRollThresh)
+void mnode::exportNode(QVector<bezier_t> &bezList, mnode *last, mnode*, mnode* anchor, float fHeart, float fRollThresh)
 {
     #define SCALING 3.f
 
-    bezList.append(new bezier_t);
+    bezList.append(bezier_t());
 
     float realDist = this->fTotalLength - last->fTotalLength;
 
@@ -166,14 +166,14 @@ void mnode::exportNode(QList<bezier_t*> &bezList, mnode *last, mnode*, mnode* an
         fThreshold = 0.998f*2.f/3.f*realDist/2.f;
     }
 
-    bezList.last()->P1 = anchorBase*(this->vPosHeart(fHeart) - anchor->vPosHeart(fHeart));
+    bezList.last().P1 = anchorBase*(this->vPosHeart(fHeart) - anchor->vPosHeart(fHeart));
 
     if(bezList.size() > 1) {
-        bezList.last()->Kp1 = bezList[bezList.size()-2]->P1 + anchorBase*(fThreshold * last->vDirHeart(fHeart));
+        bezList.last().Kp1 = bezList[bezList.size()-2].P1 + anchorBase*(fThreshold * last->vDirHeart(fHeart));
     } else {
-        bezList.last()->Kp1 = anchorBase*(last->vPosHeart(fHeart) - anchor->vPosHeart(fHeart) + fThreshold * last->vDirHeart(fHeart));
+        bezList.last().Kp1 = anchorBase*(last->vPosHeart(fHeart) - anchor->vPosHeart(fHeart) + fThreshold * last->vDirHeart(fHeart));
     }
-    bezList.last()->Kp2 = bezList.last()->P1 - anchorBase*(fThreshold * this->vDirHeart(fHeart));
+    bezList.last().Kp2 = bezList.last().P1 - anchorBase*(fThreshold * this->vDirHeart(fHeart));
 
 
     temp = 0.f;
@@ -190,12 +190,12 @@ void mnode::exportNode(QList<bezier_t*> &bezList, mnode *last, mnode*, mnode* an
         }
     }
 
-    bezList.last()->roll = temp;
+    bezList.last().roll = temp;
 
     if(fabs(this->vDirHeart(fHeart).y) < fRollThresh) {
-        bezList.last()->relRoll = false;
+        bezList.last().relRoll = false;
     } else {
-        bezList.last()->relRoll = true;
+        bezList.last().relRoll = true;
     }
 }
 
@@ -20,6 +20,7 @@
 */
 
 #include <QList>
+#include <QVector>
 #include <sstream>
 #include <fstream>
 #include "lenassert.h"
@@ -53,21 +54,21 @@ public:
     void updateNorm() { vNorm = glm::cross(vDir, vLat); }
     void changePitch(float dAngle, bool inverted);
     void changeYaw(float dAngle);
-    float getPitchChange() { return fPitchFromLast*F_HZ; }
-    float getYawChange() { return fYawFromLast*F_HZ; }
-    float fPosHeartx(float fHeart) { return vPos.x+vNorm.x*fHeart; }
-    float fPosHearty(float fHeart) { return vPos.y+vNorm.y*fHeart; }
-    float fPosHeartz(float fHeart) { return vPos.z+vNorm.z*fHeart; }
+    float getPitchChange() const { return fPitchFromLast*F_HZ; }
+    float getYawChange() const { return fYawFromLast*F_HZ; }
+    float fPosHeartx(float fHeart) const { return vPos.x+vNorm.x*fHeart; }
+    float fPosHearty(float fHeart) const { return vPos.y+vNorm.y*fHeart; }
+    float fPosHeartz(float fHeart) const { return vPos.z+vNorm.z*fHeart; }
     glm::vec3 vLatHeart(float fHeart);
     glm::vec3 vDirHeart(float fHeart);
     glm::vec3 vPosHeart(float fHeart) { return vPos + fHeart*vNorm; }
 
     glm::vec3 vRelPos(float y, float x, float z = 0.f) { return vPos - y*vNorm + x*vLatHeart(-y) + z*vDirHeart(-y); }
 
-    void exportNode(QList<bezier_t*> &bezList, mnode* last, mnode* mid, mnode* anchor, float fHeart, float fRollThresh);
+    void exportNode(QVector<bezier_t> &bezList, mnode* last, mnode* mid, mnode* anchor, float fHeart, float fRollThresh);
 
-    float getPitch() { return glm::atan(vDir.y, glm::sqrt(vDir.x*vDir.x+vDir.z*vDir.z))*180/F_PI; }
-    float getDirection() { return glm::atan(-vDir.x, -vDir.z)*180/F_PI; }
+    float getPitch() const { return glm::atan(vDir.y, glm::sqrt(vDir.x*vDir.x+vDir.z*vDir.z))*180/F_PI; }
+    float getDirection() const { return glm::atan(-vDir.x, -vDir.z)*180/F_PI; }
 
 
     void saveNode(std::fstream& file);
@@ -95,7 +96,7 @@ public:
     float fYawFromLast;
     float fRollSpeed;
     float fSmoothSpeed;
-    float fFlexion() { return fDistFromLast <= 0.0 ? 0.0f : fTrackAngleFromLast / fDistFromLast; }
+    float fFlexion() const { return fDistFromLast <= 0.0 ? 0.0f : fTrackAngleFromLast / fDistFromLast; }
     float fTotalLength;
     float fTotalHeartLength;
 };
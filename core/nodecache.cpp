@@ -0,0 +1,428 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "undohandler.h"
+#include "mainwindow.h"
+
+#include "nodecache.h"
+#include "section.h"
+#include "seccurved.h"
+#include "track.h"
+#include "smoothhandler.h"
+#include "exportfuncs.h"
+#include <sstream>
+#include <cstring>
+
+// entries within the most recently used ones stay uncompressed
+#define HOT_ENTRIES 8
+
+// bump when the section key or the layout of the persisted track cache changes.
+// 2: sections are keyed by their saved parameters only, see hashSection()
+#define SECTION_KEY_VERSION 2
+#define TRACK_CACHE_VERSION 2
+#define MNODE_FLOATS (sizeof(mnode)/sizeof(float))
+
+static void hashBytes(quint64& hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= Q_UINT64_C(1099511628211);
+    }
+}
+
+template <typename T> static void hashValue(quint64& hash, const T& value)
+{
+    hashBytes(hash, &value, sizeof(T));
+}
+
+nodeCache::nodeCache(qint64 _budget, bool _compressCold)
+{
+    budget = _budget;
+    compressCold = _compressCold;
+    usage = 0;
+    hits = 0;
+    misses = 0;
+}
+
+nodeCache::~nodeCache()
+{
+    clear();
+}
+
+// saveSection writes every parameter the user can set: fAngle, fRadius, fLeadIn/Out,
+// fDirection and bOrientation of curved sections, fHLength of straight ones, iTime,
+// bOrientation and bArgument of forced and geometric ones. Members that only hold
+// results of updateSection are left out, so computing a section doesn't change its key.
+static void hashSection(quint64& hash, section* _section)
+{
+    hashValue(hash, (int)SECTION_KEY_VERSION);
+
+    std::stringstream data;
+    _section->saveSection(data);
+    std::string str = data.str();
+    hashBytes(hash, str.data(), str.size());
+
+    hashValue(hash, _section->type);
+    if(_section->type == forced) {  // not part of its stringstream save
+        hashValue(hash, _section->bSpeed);
+        hashValue(hash, _section->fVel);
+    }
+
+    func* funcs[3] = {_section->rollFunc, _section->normForce, _section->latForce};
+    for(int i = 0; i < 3; ++i) {
+        if(funcs[i] == NULL) continue;
+        for(int j = 0; j < funcs[i]->funcList.size(); ++j) {
+            subfunc* cur = funcs[i]->funcList[j];
+            for(int k = 0; k < cur->pointList.size(); ++k) {
+                hashValue(hash, cur->pointList[k].x);
+                hashValue(hash, cur->pointList[k].y);
+            }
+            for(int k = 0; k < cur->valueList.size(); ++k) {
+                hashValue(hash, cur->valueList[k]);
+            }
+        }
+    }
+}
+
+void nodeCache::capture(section* _section, nodeCacheEntry* entry)
+{
+    entry->nodes = _section->lNodes;
+    entry->numNodes = entry->nodes.size();
+    entry->length = _section->length;
+    entry->iTime = _section->iTime;
+    entry->fHLength = _section->fHLength;
+    entry->fAngle = _section->fAngle;
+
+    entry->funcState.clear();
+    func* funcs[3] = {_section->rollFunc, _section->normForce, _section->latForce};
+    for(int i = 0; i < 3; ++i) {
+        if(funcs[i] == NULL) continue;
+        for(int j = 0; j < funcs[i]->funcList.size(); ++j) {
+            entry->funcState.append(funcs[i]->funcList[j]->startValue);
+            entry->funcState.append(funcs[i]->funcList[j]->symArg);
+        }
+    }
+
+    entry->lAngles.clear();
+    if(_section->type == curved) {
+        entry->lAngles = ((seccurved*)_section)->lAngles;
+    }
+}
+
+static int funcStateSize(section* _section)
+{
+    int size = 0;
+    func* funcs[3] = {_section->rollFunc, _section->normForce, _section->latForce};
+    for(int i = 0; i < 3; ++i) {
+        if(funcs[i] != NULL) size += 2*funcs[i]->funcList.size();
+    }
+    return size;
+}
+
+void nodeCache::apply(nodeCacheEntry* entry, section* _section)
+{
+    _section->lNodes = entry->nodes;
+    _section->length = entry->length;
+    _section->iTime = entry->iTime;
+    _section->fHLength = entry->fHLength;
+    _section->fAngle = entry->fAngle;
+
+    int n = 0;
+    func* funcs[3] = {_section->rollFunc, _section->normForce, _section->latForce};
+    for(int i = 0; i < 3; ++i) {
+        if(funcs[i] == NULL) continue;
+        for(int j = 0; j < funcs[i]->funcList.size(); ++j) {
+            funcs[i]->funcList[j]->startValue = entry->funcState[n++];
+            funcs[i]->funcList[j]->symArg = entry->funcState[n++];
+        }
+    }
+
+    if(_section->type == curved) {
+        ((seccurved*)_section)->lAngles = entry->lAngles;
+    }
+}
+
+quint64 nodeCache::getKey(section* _section)
+{
+    // bezier sections write their results back into bezList, so they are always recomputed
+    if(budget <= 0 || _section->type == bezier || _section->lNodes.isEmpty()) return 0;
+
+    quint64 hash = Q_UINT64_C(14695981039346656037);
+    hashSection(hash, _section);
+
+    track* parent = _section->parent;
+    hashValue(hash, parent->fHeart);
+    hashValue(hash, parent->fFriction);
+    hashValue(hash, parent->fResistance);
+    hashValue(hash, parent->anchorNode->fVel);
+    bool isLast = parent->lSections.last() == _section;
+    hashValue(hash, isLast);
+
+    hashBytes(hash, _section->lNodes.constData(), sizeof(mnode));
+
+    return hash ? hash : 1;
+}
+
+bool nodeCache::restore(section* _section, quint64 key)
+{
+    if(!key) return false;
+
+    nodeCacheEntry* entry = entries.value(key, NULL);
+    if(entry == NULL) {
+        ++misses;
+        return false;
+    }
+    ++hits;
+    touch(key);
+    unpack(entry);
+    apply(entry, _section);
+
+    if(compressCold) compressColdEntries();
+    evict();
+    return true;
+}
+
+void nodeCache::store(section* _section, quint64 key)
+{
+    if(!key) return;
+
+    nodeCacheEntry* entry = entries.value(key, NULL);
+    if(entry != NULL) {
+        touch(key);
+        return;
+    }
+
+    entry = new nodeCacheEntry;
+    capture(_section, entry);
+
+    entry->bytes = sizeof(nodeCacheEntry) + entry->numNodes*(qint64)sizeof(mnode) + (entry->funcState.size() + entry->lAngles.size())*(qint64)sizeof(float);
+    if(entry->bytes > budget) {
+        delete entry;
+        return;
+    }
+
+    entries.insert(key, entry);
+    lruList.prepend(key);
+    usage += entry->bytes;
+
+    if(compressCold) compressColdEntries();
+    evict();
+}
+
+quint64 nodeCache::getTrackKey(track* _track)
+{
+    quint64 hash = Q_UINT64_C(14695981039346656037);
+
+    hashValue(hash, (int)TRACK_CACHE_VERSION);
+    hashValue(hash, (int)sizeof(mnode));
+    hashValue(hash, _track->startPos);
+    hashValue(hash, _track->startPitch);
+    hashValue(hash, _track->startYaw);
+    hashValue(hash, _track->anchorNode->fRoll);
+    hashValue(hash, _track->anchorNode->fVel);
+    hashValue(hash, _track->anchorNode->forceNormal);
+    hashValue(hash, _track->anchorNode->forceLateral);
+    hashValue(hash, _track->fHeart);
+    hashValue(hash, _track->fFriction);
+    hashValue(hash, _track->fResistance);
+
+    int size = _track->lSections.size();
+    hashValue(hash, size);
+    for(int i = 0; i < size; ++i) {
+        hashSection(hash, _track->lSections[i]);
+    }
+    return hash;
+}
+
+QByteArray nodeCache::packTrack(track* _track)
+{
+    // smoothed nodes can't be told apart from integrated ones, so don't store them
+    for(int i = 0; i < _track->smoothList.size(); ++i) {
+        if(_track->smoothList[i]->active) return QByteArray();
+    }
+
+    std::stringstream data;
+    int size = _track->lSections.size();
+    writeBytes(&data, (const char*)&size, sizeof(int));
+
+    for(int i = 0; i < size; ++i) {
+        section* cur = _track->lSections[i];
+        int type = cur->type;
+        writeBytes(&data, (const char*)&type, sizeof(int));
+        if(cur->type == bezier) continue;
+
+        nodeCacheEntry entry;
+        capture(cur, &entry);
+
+        writeBytes(&data, (const char*)&entry.numNodes, sizeof(int));
+        writeBytes(&data, (const char*)&entry.length, sizeof(float));
+        writeBytes(&data, (const char*)&entry.iTime, sizeof(int));
+        writeBytes(&data, (const char*)&entry.fHLength, sizeof(float));
+        writeBytes(&data, (const char*)&entry.fAngle, sizeof(float));
+
+        int count = entry.funcState.size();
+        writeBytes(&data, (const char*)&count, sizeof(int));
+        for(int j = 0; j < count; ++j) {
+            writeBytes(&data, (const char*)&entry.funcState[j], sizeof(float));
+        }
+        count = entry.lAngles.size();
+        writeBytes(&data, (const char*)&count, sizeof(int));
+        for(int j = 0; j < count; ++j) {
+            writeBytes(&data, (const char*)&entry.lAngles[j], sizeof(float));
+        }
+
+        writeFloats(&data, (const float*)entry.nodes.constData(), entry.numNodes*MNODE_FLOATS);
+    }
+
+    std::string str = data.str();
+    QByteArray packed = qCompress((const uchar*)str.data(), str.size(), 1);
+
+    std::stringstream chunk;
+    quint64 hash = getTrackKey(_track);
+    writeBytes(&chunk, (const char*)&hash, sizeof(quint64));
+    chunk.write(packed.constData(), packed.size());
+    str = chunk.str();
+    return QByteArray(str.data(), str.size());
+}
+
+bool nodeCache::unpackTrack(track* _track, const QByteArray& chunk)
+{
+    if(chunk.size() <= (int)sizeof(quint64)) return false;
+
+    std::stringstream head(std::string(chunk.constData(), sizeof(quint64)));
+    quint64 hash;
+    readBytes(&head, &hash, sizeof(quint64));
+    if(hash != getTrackKey(_track)) return false;
+
+    QByteArray raw = qUncompress((const uchar*)chunk.constData()+sizeof(quint64), chunk.size()-sizeof(quint64));
+    if(raw.isEmpty()) return false;
+    std::stringstream data(std::string(raw.constData(), raw.size()));
+
+    // read everything before touching the track, so a broken chunk changes nothing
+    int size = readInt(&data);
+    if(size != _track->lSections.size()) return false;
+
+    QList<nodeCacheEntry> list;
+    for(int i = 0; i < size; ++i) {
+        section* cur = _track->lSections[i];
+        nodeCacheEntry entry;
+        entry.numNodes = 0;
+        if(readInt(&data) != cur->type) return false;
+        if(cur->type != bezier) {
+            entry.numNodes = readInt(&data);
+            entry.length = readFloat(&data);
+            entry.iTime = readInt(&data);
+            entry.fHLength = readFloat(&data);
+            entry.fAngle = readFloat(&data);
+
+            int count = readInt(&data);
+            if(count != funcStateSize(cur)) return false;
+            for(int j = 0; j < count; ++j) {
+                entry.funcState.append(readFloat(&data));
+            }
+            count = readInt(&data);
+            if(count < 0) return false;
+            for(int j = 0; j < count; ++j) {
+                entry.lAngles.append(readFloat(&data));
+            }
+
+            if(entry.numNodes <= 0 || !data) return false;
+            entry.nodes.resize(entry.numNodes);
+            readFloats(&data, (float*)entry.nodes.data(), entry.numNodes*MNODE_FLOATS);
+            if(!data) return false;
+        }
+        list.append(entry);
+    }
+
+    for(int i = 0; i < size; ++i) {
+        section* cur = _track->lSections[i];
+        if(cur->type == bezier) {
+            if(i) cur->lNodes.prepend(_track->lSections[i-1]->lNodes.last());
+            cur->updateSection(0);
+        } else {
+            apply(&list[i], cur);
+        }
+    }
+    return true;
+}
+
+void nodeCache::clear()
+{
+    qDeleteAll(entries);
+    entries.clear();
+    lruList.clear();
+    usage = 0;
+}
+
+void nodeCache::setBudget(qint64 _budget)
+{
+    budget = _budget;
+    evict();
+}
+
+void nodeCache::touch(quint64 key)
+{
+    if(lruList.first() == key) return;
+    lruList.removeOne(key);
+    lruList.prepend(key);
+}
+
+void nodeCache::evict()
+{
+    while(usage > budget && !lruList.isEmpty()) {
+        nodeCacheEntry* entry = entries.take(lruList.takeLast());
+        usage -= entry->bytes;
+        delete entry;
+    }
+}
+
+void nodeCache::compressColdEntries()
+{
+    for(int i = HOT_ENTRIES; i < lruList.size(); ++i) {
+        pack(entries.value(lruList[i]));
+    }
+}
+
+void nodeCache::pack(nodeCacheEntry* entry)
+{
+    if(!entry->packed.isEmpty() || entry->numNodes == 0) return;
+
+    qint64 rawSize = entry->numNodes*(qint64)sizeof(mnode);
+    entry->packed = qCompress((const uchar*)entry->nodes.constData(), rawSize, 1);
+    entry->nodes = QVector<mnode>();
+
+    usage -= entry->bytes;
+    entry->bytes += entry->packed.size() - rawSize;
+    usage += entry->bytes;
+}
+
+void nodeCache::unpack(nodeCacheEntry* entry)
+{
+    if(entry->packed.isEmpty()) return;
+
+    qint64 rawSize = entry->numNodes*(qint64)sizeof(mnode);
+    QByteArray raw = qUncompress(entry->packed);
+    entry->nodes.resize(entry->numNodes);
+    memcpy(entry->nodes.data(), raw.constData(), rawSize);
+
+    usage -= entry->bytes;
+    entry->bytes += rawSize - entry->packed.size();
+    usage += entry->bytes;
+    entry->packed.clear();
+}
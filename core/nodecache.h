@@ -0,0 +1,85 @@
+#ifndef NODECACHE_H
+#define NODECACHE_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QByteArray>
+#include "mnode.h"
+
+class section;
+class track;
+
+typedef struct {
+    QVector<mnode> nodes;
+    QByteArray packed;      // qCompress'd nodes of a cold entry, nodes is empty then
+    int numNodes;
+    float length;
+    int iTime;
+    float fHLength;
+    float fAngle;
+    QList<float> funcState; // startValue/symArg of every subfunc, in func order
+    QList<float> lAngles;
+    qint64 bytes;
+} nodeCacheEntry;
+
+class nodeCache
+{
+public:
+    nodeCache(qint64 _budget, bool _compressCold);
+    ~nodeCache();
+
+    quint64 getKey(section* _section);
+    bool restore(section* _section, quint64 key);
+    void store(section* _section, quint64 key);
+    void clear();
+
+    // persisted node arrays of a whole track, see the NODC project chunk
+    static quint64 getTrackKey(track* _track);
+    static QByteArray packTrack(track* _track);
+    static bool unpackTrack(track* _track, const QByteArray& chunk);
+
+    void setBudget(qint64 _budget);
+    qint64 getBudget() const { return budget; }
+    qint64 getUsage() const { return usage; }
+    int getSize() const { return entries.size(); }
+
+    bool compressCold;
+    quint64 hits;
+    quint64 misses;
+
+private:
+    static void capture(section* _section, nodeCacheEntry* entry);
+    static void apply(nodeCacheEntry* entry, section* _section);
+
+    void touch(quint64 key);
+    void evict();
+    void compressColdEntries();
+    void pack(nodeCacheEntry* entry);
+    void unpack(nodeCacheEntry* entry);
+
+    QHash<quint64, nodeCacheEntry*> entries;
+    QList<quint64> lruList;   // most recently used first
+    qint64 budget;
+    qint64 usage;
+};
+
+#endif // NODECACHE_H
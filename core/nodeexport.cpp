@@ -0,0 +1,187 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "nodeexport.h"
+#include "track.h"
+#include "exportfuncs.h"
+#include <QtEndian>
+#include <QByteArray>
+#include <cstring>
+
+#define NODE_CHUNK 4096     // values or csv rows buffered per write
+
+static const char* nodeColumns[] = {
+    "time", "distance", "heartDistance",
+    "posX", "posY", "posZ",
+    "heartX", "heartY", "heartZ",
+    "dirX", "dirY", "dirZ",
+    "latX", "latY", "latZ",
+    "normX", "normY", "normZ",
+    "velocity", "energy",
+    "normalForce", "lateralForce",
+    "roll", "rollSpeed", "pitch", "yaw",
+    "pitchChange", "yawChange", "flexion",
+    "smoothNormal", "smoothLateral", "smoothSpeed"
+};
+
+static const int nodeColumnCount = sizeof(nodeColumns)/sizeof(nodeColumns[0]);
+
+static float nodeValue(const mnode& node, int column, float fHeart, float time)
+{
+    switch(column) {
+    case 0: return time;
+    case 1: return node.fTotalLength;
+    case 2: return node.fTotalHeartLength;
+    case 3: return node.vPos.x;
+    case 4: return node.vPos.y;
+    case 5: return node.vPos.z;
+    case 6: return node.fPosHeartx(fHeart);
+    case 7: return node.fPosHearty(fHeart);
+    case 8: return node.fPosHeartz(fHeart);
+    case 9: return node.vDir.x;
+    case 10: return node.vDir.y;
+    case 11: return node.vDir.z;
+    case 12: return node.vLat.x;
+    case 13: return node.vLat.y;
+    case 14: return node.vLat.z;
+    case 15: return node.vNorm.x;
+    case 16: return node.vNorm.y;
+    case 17: return node.vNorm.z;
+    case 18: return node.fVel;
+    case 19: return node.fEnergy;
+    case 20: return node.forceNormal;
+    case 21: return node.forceLateral;
+    case 22: return node.fRoll;
+    case 23: return node.fRollSpeed;
+    case 24: return node.getPitch();
+    case 25: return node.getDirection();
+    case 26: return node.getPitchChange();
+    case 27: return node.getYawChange();
+    case 28: return node.fFlexion();
+    case 29: return node.smoothNormal;
+    case 30: return node.smoothLateral;
+    default: return node.fSmoothSpeed;
+    }
+}
+
+// walks the nodes of the selected sections in place, the first node of every following
+// section repeats the last one of its predecessor and is skipped. Nodes are only read through
+// constData(), so the node vectors an export snapshot shares with the live track never detach
+struct nodeCursor {
+    track* data;
+    int fromIndex, toIndex;
+    int sec, node, index;
+
+    nodeCursor(track* _track, int _from, int _to) : data(_track), fromIndex(_from), toIndex(_to) { reset(); }
+    void reset() { sec = fromIndex; node = 0; index = 0; }
+    const mnode* next() {
+        while(sec <= toIndex && node >= data->lSections.at(sec)->lNodes.size()) {
+            ++sec;
+            node = 1;
+        }
+        if(sec > toIndex) return NULL;
+        ++index;
+        return data->lSections.at(sec)->lNodes.constData() + node++;
+    }
+};
+
+static bool writeColumns(FILE* file, nodeCursor& cursor, int numNodes, float fHeart, exportprogress_t* progress)
+{
+    quint32 header[6];
+    memcpy(header, "FVDN", 4);
+    header[1] = qToLittleEndian<quint32>(NODE_EXPORT_VERSION);
+    header[2] = qToLittleEndian<quint32>(nodeColumnCount);
+    header[3] = qToLittleEndian<quint32>(numNodes);
+    float rate = F_HZ;
+    memcpy(header+4, &rate, 4);
+    header[4] = qToLittleEndian<quint32>(header[4]);
+
+    quint32 dataOffset = sizeof(header) + nodeColumnCount*NODE_EXPORT_NAME;
+    dataOffset = (dataOffset + 63) & ~63u;
+    header[5] = qToLittleEndian<quint32>(dataOffset);
+
+    QByteArray names(dataOffset - sizeof(header), '\0');
+    for(int i = 0; i < nodeColumnCount; ++i) {
+        strncpy(names.data() + i*NODE_EXPORT_NAME, nodeColumns[i], NODE_EXPORT_NAME-1);
+    }
+    if(fwrite(header, sizeof(header), 1, file) != 1) return false;
+    if(fwrite(names.constData(), names.size(), 1, file) != 1) return false;
+
+    // one pass over the nodes per column keeps every array contiguous without a copy of the track
+    uchar buffer[NODE_CHUNK*4];
+    for(int column = 0; column < nodeColumnCount; ++column) {
+        cursor.reset();
+        int n = 0;
+        const mnode* node;
+        while((node = cursor.next())) {
+            float value = nodeValue(*node, column, fHeart, (cursor.index-1)/F_HZ);
+            quint32 temp;
+            memcpy(&temp, &value, 4);
+            qToLittleEndian(temp, buffer+4*n);
+            if(++n == NODE_CHUNK) {
+                if(fwrite(buffer, 4, n, file) != (size_t)n) return false;
+                if(!exportStep(progress, column*numNodes + cursor.index, nodeColumnCount*numNodes)) return false;
+                n = 0;
+            }
+        }
+        if(n && fwrite(buffer, 4, n, file) != (size_t)n) return false;
+    }
+    return true;
+}
+
+static bool writeRows(FILE* file, nodeCursor& cursor, int numNodes, float fHeart, exportprogress_t* progress)
+{
+    QByteArray out;
+    for(int column = 0; column < nodeColumnCount; ++column) {
+        if(column) out.append(',');
+        out.append(nodeColumns[column]);
+    }
+    out.append('\n');
+
+    cursor.reset();
+    int rows = 0;
+    const mnode* node;
+    while((node = cursor.next())) {
+        for(int column = 0; column < nodeColumnCount; ++column) {
+            if(column) out.append(',');
+            appendFloat(out, nodeValue(*node, column, fHeart, (cursor.index-1)/F_HZ));
+        }
+        out.append('\n');
+        if(++rows == NODE_CHUNK) {
+            if(fwrite(out.constData(), 1, out.size(), file) != (size_t)out.size()) return false;
+            if(!exportStep(progress, cursor.index, numNodes)) return false;
+            out.clear();
+            rows = 0;
+        }
+    }
+    return fwrite(out.constData(), 1, out.size(), file) == (size_t)out.size();
+}
+
+int exportNodeData(FILE* file, track* _track, int fromIndex, int toIndex, bool csv, exportprogress_t* progress)
+{
+    if(fromIndex < 0 || toIndex >= _track->lSections.size() || fromIndex > toIndex) return -1;
+
+    int numNodes = 0;
+    for(int i = fromIndex; i <= toIndex; ++i) {
+        numNodes += _track->lSections.at(i)->lNodes.size() - (i == fromIndex ? 0 : 1);
+    }
+
+    nodeCursor cursor(_track, fromIndex, toIndex);
+    bool success = csv ? writeRows(file, cursor, numNodes, _track->fHeart, progress) : writeColumns(file, cursor, numNodes, _track->fHeart, progress);
+    return success ? numNodes : -1;
+}
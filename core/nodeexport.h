@@ -0,0 +1,37 @@
+#ifndef NODEEXPORT_H
+#define NODEEXPORT_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdio>
+#include "exportfuncs.h"
+
+class track;
+
+// binary layout, all values little-endian:
+//   char[4] "FVDN", uint32 version, uint32 column count, uint32 node count,
+//   float32 sample rate, uint32 data offset, column count x char[NODE_EXPORT_NAME] names,
+//   zero padding up to the data offset (64 byte aligned), then one float32 array per column
+#define NODE_EXPORT_VERSION 1
+#define NODE_EXPORT_NAME 24
+
+// streams every node of sections fromIndex to toIndex, returns the number of nodes written or -1
+int exportNodeData(FILE* file, track* _track, int fromIndex, int toIndex, bool csv, exportprogress_t* progress = NULL);
+
+#endif // NODEEXPORT_H
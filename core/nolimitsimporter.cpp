@@ -21,6 +21,9 @@
 #include "exportfuncs.h"
 #include "secbezier.h"
 #include "trackwidget.h"
+#include <QFile>
+#include <QtEndian>
+#include <cstring>
 
 using namespace std;
 
@@ -30,176 +33,306 @@ noLimitsImporter::noLimitsImporter(trackHandler* _track, QString _fileName)
     fileName = _fileName;
 }
 
+// NoLimits 1 tracks are a sequence of chunks: a four letter tag, the payload size and the payload
+
+typedef struct
+{
+    const uchar* data;
+    int pos;
+    int end;
+    bool ok;
+} nlCursor;
+
+typedef struct
+{
+    int tag;
+    int offset;
+} nlChunk;
+
+enum nlTag { tagSEGM, tagBEZR, tagFUND, tagFREN, tagTUBE, tagUnknown };
+
+static const char nlTags[5][5] = {"SEGM", "BEZR", "FUND", "FREN", "TUBE"};
+
+static bool nlAvail(nlCursor* cur, int bytes)
+{
+    if(!cur->ok || cur->pos + bytes > cur->end) {
+        cur->ok = false;
+        return false;
+    }
+    return true;
+}
+
+static void nlSkip(nlCursor* cur, int bytes)
+{
+    if(nlAvail(cur, bytes)) cur->pos += bytes;
+}
+
+static int nlInt(nlCursor* cur)
+{
+    if(!nlAvail(cur, 4)) return 0;
+    int value = qFromBigEndian<qint32>(cur->data + cur->pos);
+    cur->pos += 4;
+    return value;
+}
+
+static float nlFloat(nlCursor* cur)
+{
+    if(!nlAvail(cur, 4)) return 0.f;
+    quint32 temp = qFromBigEndian<quint32>(cur->data + cur->pos);
+    float value;
+    memcpy(&value, &temp, 4);
+    cur->pos += 4;
+    return value;
+}
+
+static bool nlBool(nlCursor* cur)
+{
+    if(!nlAvail(cur, 1)) return false;
+    return cur->data[cur->pos++] != 0;
+}
+
+static int nlTagAt(const uchar* data, int pos)
+{
+    for(int t = 0; t < 5; ++t) {
+        if(memcmp(data + pos, nlTags[t], 4) == 0) return t;
+    }
+    return tagUnknown;
+}
+
+static bool nlValidTag(const uchar* data, int pos)
+{
+    for(int i = 0; i < 4; ++i) {
+        uchar c = data[pos+i];
+        if(!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) return false;
+    }
+    return true;
+}
+
+// walks chunk headers by their sizes, unknown chunks that start with a chunk header are walked as containers
+static bool nlWalkChunks(const uchar* data, int from, int to, QList<nlChunk>& chunks, int depth = 0)
+{
+    int pos = from;
+    while(pos < to) {
+        if(pos + 8 > to || !nlValidTag(data, pos)) return false;
+        int size = qFromBigEndian<qint32>(data + pos + 4);
+        if(size < 0 || size > to - pos - 8) return false;
+
+        nlChunk chunk;
+        chunk.tag = nlTagAt(data, pos);
+        chunk.offset = pos;
+        if(chunk.tag != tagUnknown) {
+            chunks.append(chunk);
+        } else if(depth < 8 && size >= 8 && nlValidTag(data, pos + 8)) {
+            QList<nlChunk> inner;
+            if(nlWalkChunks(data, pos + 8, pos + 8 + size, inner, depth + 1)) chunks.append(inner);
+        }
+        pos += 8 + size;
+    }
+    return true;
+}
+
+// fallback for layouts the walker doesn't understand: look for the tags at every byte like older versions did
+static void nlScanChunks(const uchar* data, int length, QList<nlChunk>& chunks)
+{
+    for(int i = 0; i + 4 <= length; ++i) {
+        switch(data[i]) {
+        case 'S': case 'B': case 'F': case 'T':
+            break;
+        default:
+            continue;
+        }
+        nlChunk chunk;
+        chunk.tag = nlTagAt(data, i);
+        chunk.offset = i;
+        if(chunk.tag != tagUnknown) chunks.append(chunk);
+    }
+}
+
 bool noLimitsImporter::importAsNlTrack()
 {
-    fstream fin(fileName.toLocal8Bit().data(), ios::in | ios::binary);
-    if(!fin)
+    QFile fin(fileName);
+    if(!fin.open(QIODevice::ReadOnly))
     {
         return false;
     }
 
+    QByteArray buffer;
+    const uchar* data = fin.map(0, fin.size());
+    if(data == NULL) {
+        buffer = fin.readAll();
+        data = (const uchar*)buffer.constData();
+    }
+    int length = (int)fin.size();
+
+    QList<nlChunk> chunks;
+    bool walked = nlWalkChunks(data, 0, length, chunks);
+    bool hasBezier = false;
+    for(int i = 0; i < chunks.size(); ++i) {
+        if(chunks[i].tag == tagBEZR) hasBezier = true;
+    }
+
+    if(walked && hasBezier) {
+        // segments and tubes refer to the beziers and nodes, so read those first
+        int order[5] = {tagBEZR, tagSEGM, tagFUND, tagFREN, tagTUBE};
+        QList<nlChunk> sorted;
+        for(int t = 0; t < 5; ++t) {
+            for(int i = 0; i < chunks.size(); ++i) {
+                if(chunks[i].tag == order[t]) sorted.append(chunks[i]);
+            }
+        }
+        chunks = sorted;
+    } else {
+        qWarning("unknown NL Track layout, scanning for chunks");
+        chunks.clear();
+        nlScanChunks(data, length, chunks);
+    }
+
     inTrack->trackData->fHeart = 0.f;
     inTrack->trackWidgetItem->addSection(bezier);
 
-    fin.seekg (0, ios::end);
-
-    int length = fin.tellg();
-    string temp;
-    QList<bezier_t*> *bList = &inTrack->trackData->activeSection->bezList;
+    QVector<bezier_t> *bList = &inTrack->trackData->activeSection->bezList;
 
     QList<glm::vec3> *lineList = &inTrack->trackData->activeSection->supList;
 
     QList<glm::vec3> TubeNodes[3];
 
-    int bezCount, fundCount, freeCount, tubeCount;
     glm::vec3 anchor;
     bool closeTrack = false;
 
-    for(int i = 0; i < length; ++i)
+    for(int c = 0; c < chunks.size(); ++c)
     {
-        fin.seekg(i);
-        temp = readString(&fin, 4);
-        if(temp == "SEGM")
+        nlCursor cur;
+        cur.data = data;
+        cur.pos = chunks[c].offset + 8;
+        cur.end = length;
+        cur.ok = true;
+
+        if(chunks[c].tag == tagSEGM)
         {
-            readNulls(&fin, 4);
-            int segCount = readInt(&fin);
-            closeTrack = readBool(&fin);
-            readNulls(&fin, 16);
-            for(int i = 0; i < segCount; ++i)
+            int segCount = nlInt(&cur);
+            closeTrack = nlBool(&cur);
+            nlSkip(&cur, 16);
+            for(int i = 0; i < segCount && cur.ok; ++i)
             {
-                int type = readInt(&fin);
-                readNulls(&fin, 29);
+                int type = nlInt(&cur);
+                nlSkip(&cur, 29);
+                float fVel = 0.f;
                 if(type == 0)
                 {
-                    readNulls(&fin, 4);
-                    bList->at(i)->fVel = 0.f;
+                    nlSkip(&cur, 4);
                 }
                 else if(type == 1)   // station
                 {
-                    readNulls(&fin, 54);
-                    bList->at(i)->fVel = readFloat(&fin);
-                    readNulls(&fin, 72);
+                    nlSkip(&cur, 54);
+                    fVel = nlFloat(&cur);
+                    nlSkip(&cur, 72);
                 }
                 else if(type == 2) // lift
                 {
-                    readNulls(&fin, 8);
-                    bList->at(i)->fVel = readFloat(&fin);
-                    readNulls(&fin, 28);
+                    nlSkip(&cur, 8);
+                    fVel = nlFloat(&cur);
+                    nlSkip(&cur, 28);
                 }
                 else if(type == 3) // transport
                 {
-                    readNulls(&fin, 4);
-                    bList->at(i)->fVel = readFloat(&fin);
-                    readNulls(&fin, 24);
+                    nlSkip(&cur, 4);
+                    fVel = nlFloat(&cur);
+                    nlSkip(&cur, 24);
                 }
                 else if(type == 4) // brake
                 {
-                    readNulls(&fin, 4);
-                    bList->at(i)->fVel = readFloat(&fin);
-                    readNulls(&fin, 46);
+                    nlSkip(&cur, 4);
+                    fVel = nlFloat(&cur);
+                    nlSkip(&cur, 46);
                 }
                 else
                 {
                     qWarning("something wrong importing NL Track");
                 }
-                if(bList->at(i)->fVel != bList->at(i)->fVel)
+                if(fVel != fVel)
                 {
                     qWarning("read nan while importing NL Track");
                 }
-
+                if(i < bList->size()) (*bList)[i].fVel = fVel;
             }
         }
-        if(temp == "BEZR")
+        else if(chunks[c].tag == tagBEZR)
         {
-            readInt(&fin);  // size
-            readNulls(&fin, 16);
-            bezCount = readInt(&fin);
-            for(int b = 0; b < bezCount; ++b)
+            nlSkip(&cur, 16);
+            int bezCount = nlInt(&cur);
+            if(bezCount > 0 && bezCount <= (cur.end - cur.pos)/60) bList->reserve(bList->size() + bezCount);
+            for(int b = 0; b < bezCount && nlAvail(&cur, 60); ++b)
             {
-                bList->append(new bezier_t);
-                bList->at(b)->P1.x = readFloat(&fin);
-                bList->at(b)->P1.y = readFloat(&fin);
-                bList->at(b)->P1.z = readFloat(&fin);
-                bList->at(b)->Kp1.x = readFloat(&fin);
-                bList->at(b)->Kp1.y = readFloat(&fin);
-                bList->at(b)->Kp1.z = readFloat(&fin);
-                bList->at(b)->Kp2.x = readFloat(&fin);
-                bList->at(b)->Kp2.y = readFloat(&fin);
-                bList->at(b)->Kp2.z = readFloat(&fin);
-                bList->at(b)->roll = readFloat(&fin);
-                bList->at(b)->contRoll = readBool(&fin);
-                bList->at(b)->equalDist = readBool(&fin);
-                bList->at(b)->relRoll = readBool(&fin);
-                readNulls(&fin, 17);
-                if(b == 0) anchor = bList->at(b)->P1;
-                bList->at(b)->P1 -= anchor;
-                bList->at(b)->Kp1 -= anchor;
-                bList->at(b)->Kp2 -= anchor;
-
-                bList->at(b)->ptf = 0.f;
-                bList->at(b)->fvdRoll = 0.f;
-                bList->at(b)->fVel = 0.f;
+                bezier_t bez;
+                float values[10];
+                for(int i = 0; i < 10; ++i) values[i] = nlFloat(&cur);
+                bez.P1 = glm::vec3(values[0], values[1], values[2]);
+                bez.Kp1 = glm::vec3(values[3], values[4], values[5]);
+                bez.Kp2 = glm::vec3(values[6], values[7], values[8]);
+                bez.roll = values[9];
+                bez.contRoll = nlBool(&cur);
+                bez.equalDist = nlBool(&cur);
+                bez.relRoll = nlBool(&cur);
+                nlSkip(&cur, 17);
+                if(bList->isEmpty()) anchor = bez.P1;
+                bez.P1 -= anchor;
+                bez.Kp1 -= anchor;
+                bez.Kp2 -= anchor;
+
+                bez.ptf = 0.f;
+                bez.fvdRoll = 0.f;
+                bez.fVel = 0.f;
+                bList->append(bez);
             }
         }
-        if(temp == "FUND")
+        else if(chunks[c].tag == tagFUND)
         {
-            readInt(&fin);  //size
-            readNulls(&fin, 16);
-            fundCount = readInt(&fin);
-            for(int b = 0; b < fundCount; ++b)
+            nlSkip(&cur, 16);
+            int fundCount = nlInt(&cur);
+            for(int b = 0; b < fundCount && nlAvail(&cur, 92); ++b)
             {
                 glm::vec3 temp;
-                /*for(int i = 0; i < 4; ++i)
-                {
-                    temp.x = readFloat(&fin);
-                }*/
-                readNulls(&fin, 16);
-                temp.x = readFloat(&fin);
-                temp.y = readFloat(&fin);
-                temp.z = readFloat(&fin);
-                readNulls(&fin, 64);
+                nlSkip(&cur, 16);
+                temp.x = nlFloat(&cur);
+                temp.y = nlFloat(&cur);
+                temp.z = nlFloat(&cur);
+                nlSkip(&cur, 64);
                 TubeNodes[0].append(temp);
-                /*for(int i = 0; i < 12; ++i)
-                {
-                    temp.x = readFloat(&fin);
-                }*/
             }
         }
-        if(temp == "FREN")
+        else if(chunks[c].tag == tagFREN)
         {
-            readInt(&fin);  // size
-            readNulls(&fin, 16);
-            freeCount = readInt(&fin);
-            for(int b = 0; b < freeCount; ++b)
+            nlSkip(&cur, 16);
+            int freeCount = nlInt(&cur);
+            for(int b = 0; b < freeCount && nlAvail(&cur, 28); ++b)
             {
                 glm::vec3 temp;
-                temp.x = readFloat(&fin);
-                temp.y = readFloat(&fin);
-                temp.z = readFloat(&fin);
+                temp.x = nlFloat(&cur);
+                temp.y = nlFloat(&cur);
+                temp.z = nlFloat(&cur);
                 TubeNodes[1].append(temp);
-                readNulls(&fin, 16);
+                nlSkip(&cur, 16);
             }
         }
-        if(temp == "TUBE")
+        else if(chunks[c].tag == tagTUBE)
         {
             int type, index;
-            readInt(&fin);  // size
-            readNulls(&fin, 16);
-            tubeCount = readInt(&fin);
-            for(int b = 0; b < tubeCount; ++b)
+            nlSkip(&cur, 16);
+            int tubeCount = nlInt(&cur);
+            for(int b = 0; b < tubeCount && nlAvail(&cur, 48); ++b)
             {
-                type = readInt(&fin);
-                readInt(&fin);  // segment
-                index = readInt(&fin);
-                if(type != 3)
+                type = nlInt(&cur);
+                nlInt(&cur);  // segment
+                index = nlInt(&cur);
+                if(type >= 1 && type < 3 && index >= 0 && index < TubeNodes[type-1].size())
                 {
                     lineList->append(TubeNodes[type-1][index] - anchor);
                 }
-                readNulls(&fin, 4);
-                type = readInt(&fin);
-                readInt(&fin);  // segment
-                index = readInt(&fin);
-                if(type != 3 && lineList->size()%2)
+                nlSkip(&cur, 4);
+                type = nlInt(&cur);
+                nlInt(&cur);  // segment
+                index = nlInt(&cur);
+                if(type >= 1 && type < 3 && index >= 0 && index < TubeNodes[type-1].size() && lineList->size()%2)
                 {
                     lineList->append(TubeNodes[type-1][index] - anchor);
                 }
@@ -207,91 +340,163 @@ bool noLimitsImporter::importAsNlTrack()
                 {
                     lineList->removeLast();
                 }
-                readNulls(&fin, 20);
+                nlSkip(&cur, 20);
             }
         }
+        if(!cur.ok) qWarning("NL Track chunk ends early");
     }
+    fin.close();
 
-    if(closeTrack)
+    if(closeTrack && !bList->isEmpty())
     {
-        bList->append(new bezier_t);
-        bList->last()->P1 = bList->at(0)->P1;
-        bList->last()->Kp1 = bList->at(0)->Kp1;
-        bList->last()->Kp2 = bList->at(0)->Kp2;
-        bList->last()->roll = bList->at(0)->roll;
-        bList->last()->contRoll = bList->at(0)->contRoll;
-        bList->last()->equalDist = bList->at(0)->equalDist;
-        bList->last()->relRoll = bList->at(0)->relRoll;
-        bList->last()->ptf = 0.f;
-        bList->last()->fvdRoll = 0.f;
+        bezier_t first = bList->at(0);
+        first.ptf = 0.f;
+        first.fvdRoll = 0.f;
+        bList->append(first);
     }
 
     inTrack->trackData->updateTrack(0, 0);
-    fin.close();
     return true;
 }
 
-bool noLimitsImporter::importAsTxt()
+// locale independent number parser for point lists, handles [+-]digits[.digits][(e|E)[+-]digits]
+static bool parseNumber(const char*& p, const char* end, float& value)
 {
-    fstream fin(fileName.toLocal8Bit().data(), ios::in);
-    if(!fin)
-    {
-        return false;
-    }
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char* c = p;
+    bool negative = false;
+    if(c < end && (*c == '-' || *c == '+')) negative = *c++ == '-';
 
-    inTrack->trackData->fHeart = 0.f;
-    inTrack->trackWidgetItem->addSection(bezier);
+    quint64 mantissa = 0;
+    int exponent = 0, digits = 0;
+    for(; c < end && *c >= '0' && *c <= '9'; ++c, ++digits) {
+        if(mantissa < 100000000000000000ULL) mantissa = mantissa*10 + (*c - '0');
+        else ++exponent;
+    }
+    if(c < end && *c == '.') {
+        for(++c; c < end && *c >= '0' && *c <= '9'; ++c, ++digits) {
+            if(mantissa < 100000000000000000ULL) {
+                mantissa = mantissa*10 + (*c - '0');
+                --exponent;
+            }
+        }
+    }
+    if(digits == 0) return false;
 
-    fin.seekg (0, ios::end);
+    if(c < end && (*c == 'e' || *c == 'E')) {
+        const char* e = c+1;
+        bool negExp = false;
+        if(e < end && (*e == '-' || *e == '+')) negExp = *e++ == '-';
+        if(e < end && *e >= '0' && *e <= '9') {
+            int exp = 0;
+            for(; e < end && *e >= '0' && *e <= '9'; ++e) {
+                if(exp < 10000) exp = exp*10 + (*e - '0');
+            }
+            exponent += negExp ? -exp : exp;
+            c = e;
+        }
+    }
 
-    QList<bezier_t*> *bList = &inTrack->trackData->activeSection->bezList;
+    double result = (double)mantissa;
+    if(exponent < 0) result = -exponent <= 22 ? result / powers[-exponent] : result * pow(10., exponent);
+    else if(exponent > 0) result = exponent <= 22 ? result * powers[exponent] : result * pow(10., exponent);
+    value = (float)(negative ? -result : result);
+    p = c;
+    return true;
+}
 
-    fin.seekg(0);
+// drops points where the track turns by less than tolerance degrees, measured against the last kept point
+static void decimatePoints(QVector<glm::vec3>& points, float tolerance)
+{
+    if(tolerance <= 0.f || points.size() < 3) return;
+    float minCos = cos(tolerance*F_PI/180.f);
 
-    float x, y, z;
-    int b = 0;
+    int kept = 1;
+    for(int i = 1; i < points.size()-1; ++i) {
+        glm::vec3 in = points[i] - points[kept-1];
+        glm::vec3 out = points[i+1] - points[i];
+        float inLen = glm::length(in), outLen = glm::length(out);
+        if(inLen < 1e-6f) continue;     // duplicate point
+        if(outLen > 1e-6f && glm::dot(in, out) >= minCos*inLen*outLen) continue;
+        points[kept++] = points[i];
+    }
+    points[kept++] = points.last();
+    points.resize(kept);
+}
 
-    while(!fin.eof())
+bool noLimitsImporter::importAsTxt(float tolerance)
+{
+    QFile fin(fileName);
+    if(!fin.open(QIODevice::ReadOnly))
     {
-        fin >> z;
-        fin >> x;
-        fin >> y;
-        bList->append(new bezier_t);
-        bList->at(b)->P1.x = x;
-        bList->at(b)->P1.y = y;
-        bList->at(b)->P1.z = z;
-        b++;
+        return false;
     }
 
-    glm::vec3 anchor = bList->at(0)->P1;
-    bList->at(0)->Kp2 = 2.f/3.f * bList->at(0)->P1 + 1.f/3.f * bList->at(1)->P1;
-    bList->at(0)->Kp1 = 2.f*bList->at(0)->P1 - bList->at(0)->Kp2;
-
-    bList->last()->Kp1 = 2.f/3.f * bList->last()->P1 + 1.f/3.f * bList->at(bList->size()-2)->P1;
-    bList->last()->Kp2 = 2.f*bList->last()->P1 - bList->last()->Kp1;
+    QByteArray buffer;
+    const char* data = (const char*)fin.map(0, fin.size());
+    if(data == NULL) {
+        buffer = fin.readAll();
+        data = buffer.constData();
+    }
+    const char* end = data + fin.size();
 
-    for(b = 1; b < bList->size()-1; ++b)
+    // every line holds z x y, anything that isn't a number separates values
+    QVector<glm::vec3> points;
+    points.reserve((int)(fin.size()/24));
+    float values[3];
+    int numValues = 0;
+    for(const char* p = data; p < end; )
     {
-        bList->at(b)->Kp1 = 2.f/3.f * bList->at(b)->P1 + 1.f/3.f * bList->at(b-1)->P1;
-        bList->at(b)->Kp2 = 2.f/3.f * bList->at(b)->P1 + 1.f/3.f * bList->at(b+1)->P1;
-        bList->at(b)->roll = 0.f;
-        bList->at(b)->contRoll = true;
-        bList->at(b)->equalDist = true;
-        bList->at(b)->relRoll = false;
-        bList->at(b)->ptf = 0.f;
-        bList->at(b)->fvdRoll = 0.f;
-        bList->at(b)->fVel = 0.f;
+        if(parseNumber(p, end, values[numValues])) {
+            if(++numValues == 3) {
+                points.append(glm::vec3(values[1], values[2], values[0]));
+                numValues = 0;
+            }
+        } else {
+            ++p;
+        }
     }
+    fin.close();
 
-    for(b = 0; b < bList->size(); ++b)
+    if(points.size() < 2) return false;
+
+    decimatePoints(points, tolerance);
+
+    inTrack->trackData->fHeart = 0.f;
+    inTrack->trackWidgetItem->addSection(bezier);
+
+    QVector<bezier_t> *bList = &inTrack->trackData->activeSection->bezList;
+
+    int numPoints = points.size();
+    bList->resize(numPoints);
+    glm::vec3 anchor = points[0];
+    for(int b = 0; b < numPoints; ++b)
     {
-        //bList->at(b)->P1 = 0.5f*(bList->at(b)->Kp1 + bList->at(b)->Kp2);
-        bList->at(b)->P1 -= anchor;
-        bList->at(b)->Kp1 -= anchor;
-        bList->at(b)->Kp2 -= anchor;
+        bezier_t& bez = (*bList)[b];
+        bez.P1 = points[b];
+        if(b == 0) {
+            bez.Kp2 = 2.f/3.f * points[0] + 1.f/3.f * points[1];
+            bez.Kp1 = 2.f*points[0] - bez.Kp2;
+        } else if(b == numPoints-1) {
+            bez.Kp1 = 2.f/3.f * points[b] + 1.f/3.f * points[b-1];
+            bez.Kp2 = 2.f*points[b] - bez.Kp1;
+        } else {
+            bez.Kp1 = 2.f/3.f * points[b] + 1.f/3.f * points[b-1];
+            bez.Kp2 = 2.f/3.f * points[b] + 1.f/3.f * points[b+1];
+        }
+        bez.P1 -= anchor;
+        bez.Kp1 -= anchor;
+        bez.Kp2 -= anchor;
+        bez.roll = 0.f;
+        bez.contRoll = true;
+        bez.equalDist = true;
+        bez.relRoll = false;
+        bez.ptf = 0.f;
+        bez.fvdRoll = 0.f;
+        bez.fVel = 0.f;
     }
 
     inTrack->trackData->updateTrack(0, 0);
-    fin.close();
     return true;
 }
@@ -28,7 +28,7 @@ public:
     noLimitsImporter(trackHandler* _track, QString _fileName);
 
     bool importAsNlTrack();
-    bool importAsTxt();
+    bool importAsTxt(float tolerance = 0.f);
 
 private:
     trackHandler* inTrack;
@@ -0,0 +1,58 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QVector>
+#include <QtConcurrent>
+
+template <typename Fn> struct chunkRunner {
+    typedef void result_type;
+
+    const Fn* fn;
+    int count;
+    int chunkSize;
+
+    void operator()(const int& chunk) const {
+        int from = chunk*chunkSize;
+        (*fn)(chunk, from, qMin(from+chunkSize, count));
+    }
+};
+
+// splits [0, count) into chunks of chunkSize and calls fn(chunk, from, to) for each,
+// on the thread pool if there is more than one chunk. Returns the number of chunks.
+template <typename Fn> int parallelChunks(int count, int chunkSize, const Fn& fn)
+{
+    chunkRunner<Fn> runner;
+    runner.fn = &fn;
+    runner.count = count;
+    runner.chunkSize = chunkSize;
+
+    int numChunks = count > 0 ? (count+chunkSize-1)/chunkSize : 0;
+    if(numChunks > 1) {
+        QVector<int> chunks(numChunks);
+        for(int i = 0; i < numChunks; ++i) chunks[i] = i;
+        QtConcurrent::blockingMap(chunks, runner);
+    } else if(numChunks) {
+        runner(0);
+    }
+    return numChunks;
+}
+
+#endif // PARALLEL_H
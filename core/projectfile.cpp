@@ -0,0 +1,160 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "undohandler.h"
+#include "mainwindow.h"
+
+#include "projectfile.h"
+#include "exportfuncs.h"
+
+using namespace std;
+
+chunkWriter::chunkWriter(ostream* _file, bool withToc)
+{
+    file = _file;
+    tocPos = -1;
+    if(withToc) {
+        tocPos = file->tellp();
+        writeNulls(file, sizeof(int));  // patched in finish()
+    }
+}
+
+void chunkWriter::beginChunk(const char* tag, int track, int section)
+{
+    current.tag = string(tag, 4);
+    current.track = track;
+    current.section = section;
+    current.offset = file->tellp();
+    current.length = 0;
+
+    file->write(tag, 4);
+    writeNulls(file, sizeof(int));  // patched in endChunk()
+}
+
+void chunkWriter::endChunk()
+{
+    int end = file->tellp();
+    current.length = end - current.offset - 4 - (int)sizeof(int);
+
+    file->seekp(current.offset+4);
+    writeBytes(file, (const char*)&current.length, sizeof(int));
+    file->seekp(end);
+
+    toc.append(current);
+}
+
+// copies chunks written by another chunkWriter, moved to the given track
+void chunkWriter::appendBlock(const chunkBlock_t& block, int track)
+{
+    int base = file->tellp();
+    file->write(block.data.constData(), block.data.size());
+    for(int i = 0; i < block.toc.size(); ++i) {
+        chunk_t chunk = block.toc[i];
+        chunk.offset += base;
+        if(chunk.track != -1) chunk.track = track;
+        toc.append(chunk);
+    }
+}
+
+void chunkWriter::finish()
+{
+    int pos = file->tellp();
+
+    *file << "TOC";
+    int size = toc.size();
+    writeBytes(file, (const char*)&size, sizeof(int));
+    for(int i = 0; i < size; ++i) {
+        file->write(toc[i].tag.data(), 4);
+        writeBytes(file, (const char*)&toc[i].track, sizeof(int));
+        writeBytes(file, (const char*)&toc[i].section, sizeof(int));
+        writeBytes(file, (const char*)&toc[i].offset, sizeof(int));
+        writeBytes(file, (const char*)&toc[i].length, sizeof(int));
+    }
+    *file << "EOP";
+
+    int end = file->tellp();
+    file->seekp(tocPos);
+    writeBytes(file, (const char*)&pos, sizeof(int));
+    file->seekp(end);
+}
+
+chunkBlock_t makeBlock(const stringstream& stream, const QList<chunk_t>& toc)
+{
+    chunkBlock_t block;
+    string data = stream.str();
+    block.data = QByteArray(data.data(), data.size());
+    block.toc = toc;
+    return block;
+}
+
+bool readToc(fstream& file, QList<chunk_t>& toc)
+{
+    toc.clear();
+
+    int pos = readInt(&file);
+    if(!file || pos <= 0) return false;
+
+    file.seekg(pos);
+    if(readString(&file, 3) != "TOC") return false;
+
+    int size = readInt(&file);
+    for(int i = 0; i < size && file; ++i) {
+        chunk_t chunk;
+        chunk.tag = readString(&file, 4);
+        chunk.track = readInt(&file);
+        chunk.section = readInt(&file);
+        chunk.offset = readInt(&file);
+        chunk.length = readInt(&file);
+        toc.append(chunk);
+    }
+    return !file.fail();
+}
+
+bool seekChunk(fstream& file, const chunk_t& chunk)
+{
+    file.clear();
+    file.seekg(chunk.offset);
+    if(readString(&file, 4) != chunk.tag) return false;
+    return readInt(&file) == chunk.length && file;
+}
+
+const chunk_t* findChunk(const QList<chunk_t>& chunks, const char* tag)
+{
+    for(int i = 0; i < chunks.size(); ++i) {
+        if(chunks[i].tag == tag) return &chunks[i];
+    }
+    return NULL;
+}
+
+QList<chunk_t> trackChunks(const QList<chunk_t>& toc, int track)
+{
+    QList<chunk_t> chunks;
+    for(int i = 0; i < toc.size(); ++i) {
+        if(toc[i].track == track) chunks.append(toc[i]);
+    }
+    return chunks;
+}
+
+int numTracks(const QList<chunk_t>& toc)
+{
+    int count = 0;
+    for(int i = 0; i < toc.size(); ++i) {
+        if(toc[i].track >= count) count = toc[i].track+1;
+    }
+    return count;
+}
@@ -0,0 +1,72 @@
+#ifndef PROJECTFILE_H
+#define PROJECTFILE_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QList>
+#include <QByteArray>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// chunked project format: "FVD", version, offset of the table of contents,
+// then chunks of [4 byte tag][int length][payload], then the table itself.
+// Readers seek through the table and skip chunks they don't know.
+#define CHUNK_VERSION "v1.00"
+
+typedef struct {
+    std::string tag;
+    int track;      // -1 for project wide chunks
+    int section;    // -1 for chunks that don't belong to a section
+    int offset;     // of the chunk header
+    int length;     // of the payload
+} chunk_t;
+
+// chunks serialized ahead of time, offsets relative to the start of data
+typedef struct {
+    QByteArray data;
+    QList<chunk_t> toc;
+} chunkBlock_t;
+
+class chunkWriter
+{
+public:
+    chunkWriter(std::ostream* _file, bool withToc = true);
+    void beginChunk(const char* tag, int track = -1, int section = -1);
+    void endChunk();
+    void appendBlock(const chunkBlock_t& block, int track = -1);
+    void finish();
+
+    std::ostream* file;
+    QList<chunk_t> toc;
+
+private:
+    int tocPos;
+    chunk_t current;
+};
+
+chunkBlock_t makeBlock(const std::stringstream& stream, const QList<chunk_t>& toc);
+
+bool readToc(std::fstream& file, QList<chunk_t>& toc);
+bool seekChunk(std::fstream& file, const chunk_t& chunk);
+const chunk_t* findChunk(const QList<chunk_t>& chunks, const char* tag);
+QList<chunk_t> trackChunks(const QList<chunk_t>& toc, int track);
+int numTracks(const QList<chunk_t>& toc);
+
+#endif // PROJECTFILE_H
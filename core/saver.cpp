@@ -19,6 +19,8 @@
 #include "saver.h"
 
 #include <fstream>
+#include <sstream>
+#include <QSaveFile>
 #include "exportfuncs.h"
 
 using namespace std;
@@ -55,3 +57,34 @@ QString saver::doLoad()
     fin.close();
     return temp;
 }
+
+// puts the blocks of projectWidget::backupChunks() together, touches no project data
+// so it runs on a worker thread
+QString saver::writeBlocks(const QString& fileName, const QList<chunkBlock_t>& blocks)
+{
+    stringstream stream(ios::in | ios::out | ios::binary);
+    stream << "FVD";
+    stream << CHUNK_VERSION;
+
+    chunkWriter writer(&stream);
+    for(int i = 0; i < blocks.size(); ++i) {
+        writer.appendBlock(blocks[i], i-1);
+    }
+    writer.finish();
+
+    std::string data = stream.str();
+    return writeFile(fileName, QByteArray(data.data(), data.size()));
+}
+
+QString saver::writeFile(const QString& fileName, const QByteArray& data)
+{
+    // QSaveFile writes to a temporary file and renames it on commit
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly)) {
+        return QString("Error: could not open ").append(fileName);
+    }
+    if(file.write(data) != data.size() || !file.commit()) {
+        return QString("Error: could not write ").append(fileName);
+    }
+    return QString("Project Saved!");
+}
@@ -20,8 +20,10 @@
 */
 
 #include "projectwidget.h"
+#include "projectfile.h"
 #include "track.h"
 #include <QString>
+#include <QByteArray>
 
 class projectWidget;
 class QMainWindow;
@@ -32,6 +34,8 @@ public:
     saver(const QString& fileName, projectWidget* _project, QMainWindow *_parent);
     QString doSave();
     QString doLoad();
+    static QString writeBlocks(const QString& fileName, const QList<chunkBlock_t>& blocks);
+    static QString writeFile(const QString& fileName, const QByteArray& data);
 
     track* saveTo;
     projectWidget* project;
@@ -18,6 +18,7 @@
 
 #include "secbezier.h"
 #include "exportfuncs.h"
+#include "parallel.h"
 
 secbezier::secbezier(track* getParent, mnode* first) : section(getParent, bezier, first)
 {
@@ -29,16 +30,96 @@ secbezier::secbezier(track* getParent, mnode* first) : section(getParent, bezier
 
 secbezier::~secbezier()
 {
-    for(int i = 0; i < bezList.size(); ++i)
+}
+
+#define LUT_STEP 0.05f      // meters of control polygon per table entry
+#define LUT_MIN 16
+#define LUT_MAX 1024
+#define LUT_CHUNK 8         // segments per job
+
+// derivative of the segment divided by 3, like the node directions below
+static glm::vec3 bezierDir(const glm::vec3* P, float t)
+{
+    float t1 = 1.f-t;
+    return t1*t1*(P[1]-P[0]) + 2.f*t1*t*(P[2]-P[1]) + t*t*(P[3]-P[2]);
+}
+
+// fills the cumulative arc length table of one segment, three point gauss quadrature per entry
+static void buildArcLut(arclut_t& lut)
+{
+    if(!lut.dirty) return;
+    float polygon = glm::distance(lut.P[0], lut.P[1]) + glm::distance(lut.P[1], lut.P[2]) + glm::distance(lut.P[2], lut.P[3]);
+    int entries = qBound(LUT_MIN, (int)(polygon/LUT_STEP), LUT_MAX);
+
+    static const float gaussT[3] = {0.1127016654f, 0.5f, 0.8872983346f};
+    static const float gaussW[3] = {5.f/18.f, 8.f/18.f, 5.f/18.f};
+
+    lut.length.resize(entries+1);
+    lut.length[0] = 0.f;
+    float step = 1.f/entries;
+    for(int i = 0; i < entries; ++i) {
+        float sum = 0.f;
+        for(int g = 0; g < 3; ++g) {
+            sum += gaussW[g]*glm::length(bezierDir(lut.P, (i + gaussT[g])*step));
+        }
+        lut.length[i+1] = lut.length[i] + 3.f*sum*step;
+    }
+    lut.dirty = false;
+}
+
+struct arcLutBuilder {
+    arclut_t* luts;
+
+    void operator()(int, int from, int to) const {
+        for(int b = from; b < to; ++b) buildArcLut(luts[b]);
+    }
+};
+
+void secbezier::updateArcLuts()
+{
+    int segments = qMax(bezList.size()-1, 0);
+    arcLuts.resize(segments);
+
+    int dirty = 0;
+    for(int b = 0; b < segments; ++b)
+    {
+        glm::vec3 P[4] = {bezList[b].P1, bezList[b].Kp2, bezList[b+1].Kp1, bezList[b+1].P1};
+        arclut_t& lut = arcLuts[b];
+        if(lut.length.isEmpty() || lut.P[0] != P[0] || lut.P[1] != P[1] || lut.P[2] != P[2] || lut.P[3] != P[3])
+        {
+            for(int i = 0; i < 4; ++i) lut.P[i] = P[i];
+            lut.dirty = true;
+            ++dirty;
+        }
+    }
+
+    // segments are independent, so bigger rebuilds go to the thread pool
+    arcLutBuilder builder;
+    builder.luts = arcLuts.data();
+    if(dirty > LUT_CHUNK)
+    {
+        parallelChunks(segments, LUT_CHUNK, builder);
+    }
+    else
     {
-        delete bezList[i];
+        builder(0, 0, segments);
     }
 }
 
+// bezier parameter at arc length s, cursor only moves forward while a segment is sampled
+static float arcLutParam(const arclut_t& lut, float s, int& cursor)
+{
+    int last = lut.length.size()-1;
+    while(cursor < last-1 && lut.length[cursor+1] <= s) ++cursor;
+    float segLength = lut.length[cursor+1] - lut.length[cursor];
+    float f = segLength > 0.f ? (s - lut.length[cursor])/segLength : 0.f;
+    return (cursor + qBound(0.f, f, 1.f))/last;
+}
+
 int secbezier::updateSection(int node)
 {
     Q_UNUSED(node);
-    QList<float> tList;
+    QVector<float> tList;
     while(lNodes.size() > 1)
     {
 		/*if(lNodes.size() > 2 || this->parent->lSections.at(this->parent->lSections.size()-1) == this)
@@ -50,14 +131,20 @@ int secbezier::updateSection(int node)
 	lNodes[0].updateNorm();
 
 
+    updateArcLuts();
+
 	int cur = 0, lastcur = 0;
-    float t = 0.f;
+    float s = 0.f;      // arc length into the current segment, nodes are placed vel/F_HZ apart
 
 	mnode* curNode = &lNodes[0], *prevNode = NULL;
     for(int b = 0; b < bezList.size()-1; ++b)
     {
-        while(t < 1.f)
+        const arclut_t& lut = arcLuts[b];
+        float segLength = lut.length.last();
+        int cursor = 0;
+        while(s < segLength || (s == 0.f && segLength <= 0.f))
         {
+            float t = arcLutParam(lut, s, cursor);
             tList.append(t);
 
             int bnext = (b+1)%bezList.size();
@@ -69,21 +156,13 @@ int secbezier::updateSection(int node)
 			prevNode = &lNodes[glm::max(cur-1, 0)];
 			curNode = &lNodes[cur];
             curNode->fEnergy = prevNode->fEnergy;
-			curNode->vPos = t1*t1*t1*bezList[b]->P1 + 3.f*t1*t1*t*bezList[b]->Kp2 + 3.f*t1*t*t*bezList[bnext]->Kp1 + t*t*t*bezList[bnext]->P1;
+			curNode->vPos = t1*t1*t1*lut.P[0] + 3.f*t1*t1*t*lut.P[1] + 3.f*t1*t*t*lut.P[2] + t*t*t*lut.P[3];
 
 
-			curNode->fRoll = t1*bezList[b]->fvdRoll + t*bezList[bnext]->fvdRoll;
+			curNode->fRoll = t1*bezList[b].fvdRoll + t*bezList[bnext].fvdRoll;
             curNode->fRoll *= 180.f/F_PI;
 
-			glm::vec3 diff1 = bezList[b]->Kp2-bezList[b]->P1;
-			glm::vec3 diff2 = bezList[bnext]->Kp1-bezList[b]->Kp2;
-			glm::vec3 diff3 = bezList[bnext]->P1-bezList[bnext]->Kp1;
-
-            curNode->vDir = t1*t1*diff1 + 2*t1*t*diff2 + t*t*diff3;
-
-            float lengthDir = glm::length(curNode->vDir);
-
-            curNode->vDir = glm::normalize(curNode->vDir);
+            curNode->vDir = glm::normalize(bezierDir(lut.P, t));
 
             curNode->vLat.x = -curNode->vDir.z;
             curNode->vLat.y = 0;
@@ -105,7 +184,7 @@ int secbezier::updateSection(int node)
                 curNode->fTotalLength = prevNode->fTotalLength + curNode->fDistFromLast;
             }
 
-			float vel = bezList[b]->fVel;
+			float vel = bezList[b].fVel;
             if(vel == 0.f)
             {
                 //float heightDiff = curNode->vPosHeart(parent->fHeart*0.9f).y - prevNode->vPosHeart(parent->fHeart*0.9f).y;
@@ -129,12 +208,12 @@ int secbezier::updateSection(int node)
                 curNode->fEnergy = 0.5*vel*vel + F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y + curNode->fTotalLength*parent->fFriction);
             }
             curNode->fVel = vel;
-            t += 1.f/(3000.f*lengthDir/vel);
+            s += vel/F_HZ;
             ++cur;
         }
-        t -= 1.f;
-		bezList[b]->length = lNodes[cur-1].fTotalHeartLength - lNodes[lastcur].fTotalHeartLength;
-		bezList[b]->numNodes = cur-1-lastcur;
+        s -= segLength;
+		bezList[b].length = lNodes[cur-1].fTotalHeartLength - lNodes[lastcur].fTotalHeartLength;
+		bezList[b].numNodes = cur-1-lastcur;
         lastcur = cur-1;
     }
 
@@ -143,7 +222,7 @@ int secbezier::updateSection(int node)
     int b = 0;
     float correction = 0;
 
-	bezList[0]->fvdRoll = bezList[0]->roll;
+	bezList[0].fvdRoll = bezList[0].roll;
 
     for(int i = 0; i < lNodes.size(); ++i)
     {
@@ -151,25 +230,25 @@ int secbezier::updateSection(int node)
         if(i && tList[i] < tList[i-1])
         {
             ++b;
-			if(bezList[b]->relRoll)
+			if(bezList[b].relRoll)
             {
-				bezList[b]->fvdRoll = bezList[b-1]->fvdRoll + correction*F_PI/180.f + bezList[b]->roll;
-				bezList[b-1]->ptf = bezList[b]->roll;
+				bezList[b].fvdRoll = bezList[b-1].fvdRoll + correction*F_PI/180.f + bezList[b].roll;
+				bezList[b-1].ptf = bezList[b].roll;
             }
             else
             {
-				bezList[b]->fvdRoll = bezList[b]->roll;
-				bezList[b-1]->ptf = bezList[b]->fvdRoll - bezList[b-1]->fvdRoll - correction*F_PI/180.f;
-				if(fabs(bezList[b-1]->ptf) > F_PI)
+				bezList[b].fvdRoll = bezList[b].roll;
+				bezList[b-1].ptf = bezList[b].fvdRoll - bezList[b-1].fvdRoll - correction*F_PI/180.f;
+				if(fabs(bezList[b-1].ptf) > F_PI)
                 {
-					bezList[b-1]->ptf += bezList[b-1]->ptf > 0.f ? -2.f*F_PI : 2.f*F_PI;
+					bezList[b-1].ptf += bezList[b-1].ptf > 0.f ? -2.f*F_PI : 2.f*F_PI;
                 }
             }
             correction = 0.f;
         }
 		correction -= glm::dot(lNodes[i].vDir, glm::vec3(0.f, -1.f, 0.f))*lNodes[i].fYawFromLast;
 
-		float fRoll = bezList[b]->fvdRoll*180.f/F_PI;
+		float fRoll = bezList[b].fvdRoll*180.f/F_PI;
 
 		lNodes[i].setRoll(fRoll + correction);
     }
@@ -198,15 +277,15 @@ int secbezier::updateSection(int node)
 
             startVal = endVal;
 
-			if(bezList[bNext]->contRoll)
+			if(bezList[bNext].contRoll)
             {
-				endVal = (bezList[b]->length*bezList[b]->ptf + bezList[bNext]->length*bezList[bNext]->ptf)/(bezList[b]->length + bezList[bNext]->length);//*(tNext - tList[i]);
+				endVal = (bezList[b].length*bezList[b].ptf + bezList[bNext].length*bezList[bNext].ptf)/(bezList[b].length + bezList[bNext].length);//*(tNext - tList[i]);
             }
             else
             {
                 endVal = 0.f;
             }
-			area = bezList[b]->ptf;
+			area = bezList[b].ptf;
 
             a1 = 3.f*startVal + 3.f*endVal - 6.f*area;
             b1 = 6.f*area - 4.f*startVal - 2.f*endVal;
@@ -216,15 +295,15 @@ int secbezier::updateSection(int node)
         {
             startVal = 0.f;
             value = 0.f;
-			if(bezList.size() > 1 && bezList[1]->contRoll)
+			if(bezList.size() > 1 && bezList[1].contRoll)
             {
-				endVal = (bezList[b]->length*bezList[b]->ptf + bezList[bNext]->length*bezList[bNext]->ptf)/(bezList[b]->length + bezList[bNext]->length);//*(tNext - tList[i]);
+				endVal = (bezList[b].length*bezList[b].ptf + bezList[bNext].length*bezList[bNext].ptf)/(bezList[b].length + bezList[bNext].length);//*(tNext - tList[i]);
             }
             else
             {
                 endVal = 0.f;
             }
-			area = bezList[0]->ptf;
+			area = bezList[0].ptf;
 
             a1 = 3.f*startVal + 3.f*endVal - 6.f*area;
             b1 = 6.f*area - 4.f*startVal - 2.f*endVal;
@@ -278,7 +357,7 @@ int secbezier::updateSection(int node)
     return node;
 }
 
-void secbezier::saveSection(std::fstream& file)
+void secbezier::saveSection(std::ostream& file)
 {
     file << "BEZ";
     int namelength = sName.length();
@@ -291,12 +370,12 @@ void secbezier::saveSection(std::fstream& file)
     writeBytes(&file, (const char*)&bezcount, sizeof(int));
     for(int i = 0; i < bezcount; ++i)
     {
-		writeBytes(&file, (const char*)&bezList[i]->P1, sizeof(glm::vec3));
-		writeBytes(&file, (const char*)&bezList[i]->Kp1, sizeof(glm::vec3));
-		writeBytes(&file, (const char*)&bezList[i]->Kp2, sizeof(glm::vec3));
-		writeBytes(&file, (const char*)&bezList[i]->contRoll, sizeof(bool));
-		writeBytes(&file, (const char*)&bezList[i]->relRoll, sizeof(bool));
-		writeBytes(&file, (const char*)&bezList[i]->roll, sizeof(float));
+		writeBytes(&file, (const char*)&bezList[i].P1, sizeof(glm::vec3));
+		writeBytes(&file, (const char*)&bezList[i].Kp1, sizeof(glm::vec3));
+		writeBytes(&file, (const char*)&bezList[i].Kp2, sizeof(glm::vec3));
+		writeBytes(&file, (const char*)&bezList[i].contRoll, sizeof(bool));
+		writeBytes(&file, (const char*)&bezList[i].relRoll, sizeof(bool));
+		writeBytes(&file, (const char*)&bezList[i].roll, sizeof(float));
     }
 
     int supcount = supList.size();
@@ -315,14 +394,14 @@ void secbezier::loadSection(std::fstream& file)
     int bezcount = readInt(&file);
     for(int i = 0; i < bezcount; ++i)
     {
-        bezList.append(new bezier_t);
-		bezList[i]->P1 = readVec3(&file);
-		bezList[i]->Kp1 = readVec3(&file);
-		bezList[i]->Kp2 = readVec3(&file);
-		bezList[i]->contRoll = readBool(&file);
-		bezList[i]->relRoll = readBool(&file);
-		bezList[i]->roll = readFloat(&file);
-		bezList[i]->fVel = 0;
+        bezList.append(bezier_t());
+		bezList[i].P1 = readVec3(&file);
+		bezList[i].Kp1 = readVec3(&file);
+		bezList[i].Kp2 = readVec3(&file);
+		bezList[i].contRoll = readBool(&file);
+		bezList[i].relRoll = readBool(&file);
+		bezList[i].roll = readFloat(&file);
+		bezList[i].fVel = 0;
     }
 
     int supcount = readInt(&file);
@@ -340,14 +419,14 @@ void secbezier::legacyLoadSection(std::fstream& file)
     int bezcount = readInt(&file);
     for(int i = 0; i < bezcount; ++i)
     {
-        bezList.append(new bezier_t);
-		bezList[i]->P1 = readVec3(&file);
-		bezList[i]->Kp1 = readVec3(&file);
-		bezList[i]->Kp2 = readVec3(&file);
-		bezList[i]->contRoll = readBool(&file);
-		bezList[i]->relRoll = readBool(&file);
-		bezList[i]->roll = readFloat(&file);
-		bezList[i]->fVel = 0;
+        bezList.append(bezier_t());
+		bezList[i].P1 = readVec3(&file);
+		bezList[i].Kp1 = readVec3(&file);
+		bezList[i].Kp2 = readVec3(&file);
+		bezList[i].contRoll = readBool(&file);
+		bezList[i].relRoll = readBool(&file);
+		bezList[i].roll = readFloat(&file);
+		bezList[i].fVel = 0;
     }
 
     int supcount = readInt(&file);
@@ -370,12 +449,12 @@ void secbezier::saveSection(std::stringstream& file)
     writeBytes(&file, (const char*)&bezcount, sizeof(int));
     for(int i = 0; i < bezcount; ++i)
     {
-		writeBytes(&file, (const char*)&bezList[i]->P1, sizeof(glm::vec3));
-		writeBytes(&file, (const char*)&bezList[i]->Kp1, sizeof(glm::vec3));
-		writeBytes(&file, (const char*)&bezList[i]->Kp2, sizeof(glm::vec3));
-		writeBytes(&file, (const char*)&bezList[i]->contRoll, sizeof(bool));
-		writeBytes(&file, (const char*)&bezList[i]->relRoll, sizeof(bool));
-		writeBytes(&file, (const char*)&bezList[i]->roll, sizeof(float));
+		writeBytes(&file, (const char*)&bezList[i].P1, sizeof(glm::vec3));
+		writeBytes(&file, (const char*)&bezList[i].Kp1, sizeof(glm::vec3));
+		writeBytes(&file, (const char*)&bezList[i].Kp2, sizeof(glm::vec3));
+		writeBytes(&file, (const char*)&bezList[i].contRoll, sizeof(bool));
+		writeBytes(&file, (const char*)&bezList[i].relRoll, sizeof(bool));
+		writeBytes(&file, (const char*)&bezList[i].roll, sizeof(float));
     }
 
     int supcount = supList.size();
@@ -394,14 +473,14 @@ void secbezier::loadSection(std::stringstream& file)
     int bezcount = readInt(&file);
     for(int i = 0; i < bezcount; ++i)
     {
-        bezList.append(new bezier_t);
-		bezList[i]->P1 = readVec3(&file);
-		bezList[i]->Kp1 = readVec3(&file);
-		bezList[i]->Kp2 = readVec3(&file);
-		bezList[i]->contRoll = readBool(&file);
-		bezList[i]->relRoll = readBool(&file);
-		bezList[i]->roll = readFloat(&file);
-		bezList[i]->fVel = 0;
+        bezList.append(bezier_t());
+		bezList[i].P1 = readVec3(&file);
+		bezList[i].Kp1 = readVec3(&file);
+		bezList[i].Kp2 = readVec3(&file);
+		bezList[i].contRoll = readBool(&file);
+		bezList[i].relRoll = readBool(&file);
+		bezList[i].roll = readFloat(&file);
+		bezList[i].fVel = 0;
     }
 
     int supcount = readInt(&file);
@@ -22,13 +22,21 @@
 #include "track.h"
 #include "section.h"
 
+// cumulative arc length of one bezier segment at evenly spaced parameters
+typedef struct arclut_s
+{
+    glm::vec3 P[4];     // control points the table was built for
+    QVector<float> length;
+    bool dirty;
+} arclut_t;
+
 class secbezier : public section
 {
 public:
     secbezier(track* getParent, mnode* first);
     ~secbezier();
     virtual int updateSection(int node = 0);
-    virtual void saveSection(std::fstream& file);
+    virtual void saveSection(std::ostream& file);
     virtual void loadSection(std::fstream& file);
     virtual void legacyLoadSection(std::fstream& file);
     virtual void saveSection(std::stringstream& file);
@@ -38,6 +46,8 @@ public:
     virtual bool isInFunction(int index, subfunc* func);
 
 private:
+    void updateArcLuts();
+    QVector<arclut_t> arcLuts;
 };
 
 #endif // SECBEZIER_H
@@ -193,7 +193,7 @@ float seccurved::getMaxArgument()
     return rollFunc->getMaxArgument();
 }
 
-void seccurved::saveSection(std::fstream& file)
+void seccurved::saveSection(std::ostream& file)
 {
     file << "CUR";
     writeBytes(&file, (const char*)&bSpeed, sizeof(bool));
@@ -28,7 +28,7 @@ public:
     seccurved(track* getParent, mnode* first, float getAngle, float getRadius);
     void changecurve(float newAngle, float newRadius, float newDirection);
     virtual int updateSection(int node = 0);
-    virtual void saveSection(std::fstream& file);
+    virtual void saveSection(std::ostream& file);
     virtual void loadSection(std::fstream& file);
     virtual void legacyLoadSection(std::fstream& file);
     virtual void saveSection(std::stringstream& file);
@@ -38,6 +38,7 @@ public:
     virtual bool isInFunction(int index, subfunc* func);
 
 private:
+    friend class nodeCache;
     QList<float> lAngles;
 };
 
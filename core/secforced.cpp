@@ -339,7 +339,7 @@ float secforced::getMaxArgument()
     return min;
 }
 
-void secforced::saveSection(std::fstream& file)
+void secforced::saveSection(std::ostream& file)
 {
     file << "FRC";
     writeBytes(&file, (const char*)&bSpeed, sizeof(bool));
@@ -447,6 +447,25 @@ bool secforced::isInFunction(int index, subfunc* func)
     return false;
 }
 
+// isInFunction sums up the distance from the first node, so the range is found in a single pass
+void secforced::getFunctionRange(subfunc* func, int& from, int& to)
+{
+    if(func == NULL || bArgument != DISTANCE) {
+        section::getFunctionRange(func, from, to);
+        return;
+    }
+    from = lNodes.size();
+    to = from;
+    float dist = 0;
+    for(int i = 0; i < lNodes.size(); ++i) {
+        if(i) dist += lNodes[i].fHeartDistFromLast;
+        if(dist > func->maxArgument) break;
+        if(dist < func->minArgument) continue;
+        if(from > i) from = i;
+        to = i;
+    }
+}
+
 bool secforced::isLockable(func* _func)
 {
     if(_func == rollFunc) {
@@ -29,7 +29,7 @@ public:
     secforced(track* getParent, mnode* first, float getlength = 10.0);
     virtual int updateSection(int node = 0);
     int updateDistanceSection(int node = 0);
-    virtual void saveSection(std::fstream& file);
+    virtual void saveSection(std::ostream& file);
     virtual void loadSection(std::fstream& file);
     virtual void legacyLoadSection(std::fstream& file);
     virtual void saveSection(std::stringstream& file);
@@ -37,6 +37,7 @@ public:
     virtual float getMaxArgument();
     virtual bool isLockable(func* _func);
     virtual bool isInFunction(int index, subfunc* func);
+    virtual void getFunctionRange(subfunc* func, int& from, int& to);
 };
 
 #endif // SECFORCED_H
@@ -399,7 +399,7 @@ float secgeometric::getMaxArgument()
     return min;
 }
 
-void secgeometric::saveSection(std::fstream& file)
+void secgeometric::saveSection(std::ostream& file)
 {
     file << "GEO";
     writeBytes(&file, (const char*)&bSpeed, sizeof(bool));
@@ -510,6 +510,25 @@ bool secgeometric::isInFunction(int index, subfunc* func)
     return false;
 }
 
+// isInFunction sums up the distance from the first node, so the range is found in a single pass
+void secgeometric::getFunctionRange(subfunc* func, int& from, int& to)
+{
+    if(func == NULL || bArgument != DISTANCE) {
+        section::getFunctionRange(func, from, to);
+        return;
+    }
+    from = lNodes.size();
+    to = from;
+    float dist = 0;
+    for(int i = 0; i < lNodes.size(); ++i) {
+        if(i) dist += lNodes[i].fHeartDistFromLast;
+        if(dist > func->maxArgument) break;
+        if(dist < func->minArgument) continue;
+        if(from > i) from = i;
+        to = i;
+    }
+}
+
 bool secgeometric::isLockable(func* _func)
 {
     if(_func == rollFunc) {
@@ -3,24 +3,76 @@
 #include <fstream>
 #include <QFile>
 #include <QDebug>
+#include "parallel.h"
 
 using namespace std;
 
+#define CSV_CHUNK 16384     // output nodes per resampling job
+
+// output distances only grow, so each chunk of samples binary searches its first csv node
+// and walks on from there with a cursor, interpolating just position, direction and lateral
+struct csvResampler {
+    const csvpoints_t* csvPoints;
+    float nodeDist;
+    glm::vec3* samples;     // vPos, vDir, vLat per output node
+
+    void operator()(int, int from, int to) const {
+        const float* totalLength = csvPoints->fTotalLength.constData();
+        const glm::vec3* pos = csvPoints->vPos.constData();
+        const glm::vec3* dir = csvPoints->vDir.constData();
+        const glm::vec3* lat = csvPoints->vLat.constData();
+        int last = csvPoints->fTotalLength.size() - 1;
+
+        int left = 0, right = last;
+        float start = from * nodeDist;
+        while(left < right) {
+            int mid = (left + right) / 2;
+            if(totalLength[mid] <= start) left = mid + 1;
+            else right = mid;
+        }
+        int cur = left > 0 ? left - 1 : 0;
+
+        for(int i = from; i < to; i++) {
+            float distance = i * nodeDist;
+            while(cur < last && totalLength[cur + 1] <= distance) cur++;
+
+            glm::vec3* sample = samples + 3*i;
+            if(cur >= last) {
+                sample[0] = pos[last];
+                sample[1] = dir[last];
+                sample[2] = lat[last];
+                continue;
+            }
+
+            float t = 0;
+            float nodesDistanceDiff = totalLength[cur + 1] - totalLength[cur];
+            float distanceDiff = distance - totalLength[cur];
+
+            if (nodesDistanceDiff > std::numeric_limits<float>::epsilon()) {
+                t = fmax(fmin(distanceDiff / nodesDistanceDiff, 1.0f), 0.0f);
+            } else t = 0.5f;
+
+            sample[0] = pos[cur] + ((pos[cur + 1] - pos[cur]) * t);
+            sample[1] = dir[cur] + ((dir[cur + 1] - dir[cur]) * t);
+            sample[2] = lat[cur] + ((lat[cur + 1] - lat[cur]) * t);
+        }
+    }
+};
+
+
 secnlcsv::secnlcsv(track* getParent, mnode* first) : section(getParent, nolimitscsv, first) {}
 
 int secnlcsv::updateSection(int node)
 {
     Q_UNUSED(node);
 
-    initDistances();
-
     while(lNodes.size() > 1) {
         lNodes.removeLast();
     }
 
     lNodes[0].updateNorm();
 
-    if(!csvNodes.size())
+    if(!csvPoints.vPos.size())
         return 0;
 
     float velocity = parent->anchorNode->fVel;
@@ -28,24 +80,32 @@ int secnlcsv::updateSection(int node)
 
     int numNode = 0;
 
-    float trackLength = csvNodes.last().fTotalLength;
+    float trackLength = csvPoints.fTotalLength.last();
 
     int totalNumOfNodes = floor(trackLength / nodeDist);
+    if(totalNumOfNodes < 1) totalNumOfNodes = 1;
     nodeDist = trackLength / totalNumOfNodes;
 
     length = 0.0f;
 
-    for(int i=0; i <= totalNumOfNodes; i++) {
-        mnode node = getNodeAtDistance(i * nodeDist);
+    QVector<glm::vec3> samples(3*(totalNumOfNodes + 1));
+    csvResampler resampler;
+    resampler.csvPoints = &csvPoints;
+    resampler.nodeDist = nodeDist;
+    resampler.samples = samples.data();
+    parallelChunks(totalNumOfNodes + 1, CSV_CHUNK, resampler);
 
+    lNodes.reserve(totalNumOfNodes + 1);
+
+    for(int i=0; i <= totalNumOfNodes; i++) {
         if(numNode) {
             lNodes.append(lNodes.back());
         }
 
         mnode *currentNode = &lNodes[numNode];
-        currentNode->vPos = node.vPos;
-        currentNode->vDir = node.vDir;
-        currentNode->vLat = node.vLat;
+        currentNode->vPos = samples[3*i];
+        currentNode->vDir = samples[3*i+1];
+        currentNode->vLat = samples[3*i+2];
         currentNode->fVel = velocity;
         currentNode->fDistFromLast = 0.0f;
 
@@ -74,152 +134,125 @@ int secnlcsv::updateSection(int node)
 }
 
 void secnlcsv::initDistances() {
+    int size = csvPoints.vPos.size();
     float len = 0.0f;
 
-    glm::vec3 lastPos = csvNodes.first().vPos;
+    csvPoints.fTotalLength.resize(size);
+    if(!size) return;
 
-    for(int i=0; i < csvNodes.size(); i++) {
-        glm::vec3 pos = csvNodes[i].vPos;
+    glm::vec3 lastPos = csvPoints.vPos.first();
+
+    for(int i=0; i < size; i++) {
+        glm::vec3 pos = csvPoints.vPos[i];
 
         len += glm::distance(lastPos, pos);
-        csvNodes[i].fTotalLength = len;
+        csvPoints.fTotalLength[i] = len;
 
         lastPos = pos;
     }
 }
 
-mnode secnlcsv::getNodeAtDistance(float distance) {
-    int left = 0;
-    int right = csvNodes.size() - 1;
-    float range;
-    int pos;
-
-    if(!csvNodes.size()) return mnode();
-
-    while(distance >= csvNodes.at(left).fTotalLength && distance <= csvNodes.at(right).fTotalLength) {
-        range = csvNodes.at(right).fTotalLength - csvNodes.at(left).fTotalLength;
-
-        pos = left + (int)(((double)right - left) * (distance - csvNodes.at(left).fTotalLength) / range);
+void secnlcsv::clearPoints() {
+    csvPoints.vPos.clear();
+    csvPoints.vDir.clear();
+    csvPoints.vLat.clear();
+    csvPoints.fTotalLength.clear();
+}
 
-        if(distance > csvNodes.at(pos).fTotalLength) left = pos + 1;
-        else if(distance < csvNodes.at(pos).fTotalLength) right = pos - 1;
-        else break;
-    }
+// projects store pos, dir and lat interleaved as 9 floats per node
+void secnlcsv::readPoints(const float* data, int size) {
+    csvPoints.vPos.resize(size);
+    csvPoints.vDir.resize(size);
+    csvPoints.vLat.resize(size);
 
-    if(pos >= csvNodes.size() - 1) {
-        return csvNodes.last();
+    for(int i=0; i < size; i++) {
+        const float* cur = data + 9*i;
+        csvPoints.vPos[i] = glm::vec3(cur[0], cur[1], cur[2]);
+        csvPoints.vDir[i] = glm::vec3(cur[3], cur[4], cur[5]);
+        csvPoints.vLat[i] = glm::vec3(cur[6], cur[7], cur[8]);
     }
 
-    mnode currentNode = csvNodes.at(pos);
-    mnode nextNode = csvNodes.at(pos + 1);
-
-    float t = 0;
-    float nodesDistanceDiff = nextNode.fTotalLength - currentNode.fTotalLength;
-    float distanceDiff = distance - currentNode.fTotalLength;
+    initDistances();
+}
 
-    if (nodesDistanceDiff > std::numeric_limits<float>::epsilon()) {
-        t = fmax(fmin(distanceDiff / nodesDistanceDiff, 1.0f), 0.0f);
-    } else t = 0.5f;
+void secnlcsv::writePoints(QVector<float>& data) {
+    int size = csvPoints.vPos.size();
+    data.resize(9*size);
 
-    mnode resultNode;
-    resultNode.vPos = currentNode.vPos + ((nextNode.vPos - currentNode.vPos) * t);
-    resultNode.vDir = currentNode.vDir + ((nextNode.vDir - currentNode.vDir) * t);
-    resultNode.vLat = currentNode.vLat + ((nextNode.vLat - currentNode.vLat) * t);
-    return resultNode;
+    for(int i=0; i < size; i++) {
+        float* cur = data.data() + 9*i;
+        cur[0] = csvPoints.vPos[i].x; cur[1] = csvPoints.vPos[i].y; cur[2] = csvPoints.vPos[i].z;
+        cur[3] = csvPoints.vDir[i].x; cur[4] = csvPoints.vDir[i].y; cur[5] = csvPoints.vDir[i].z;
+        cur[6] = csvPoints.vLat[i].x; cur[7] = csvPoints.vLat[i].y; cur[8] = csvPoints.vLat[i].z;
+    }
 }
 
-void secnlcsv::saveSection(fstream &file)
+void secnlcsv::saveSection(ostream &file)
 {
-    int size = csvNodes.size();
+    int size = csvPoints.vPos.size();
 
     file << "CSV";
 
     writeBytes(&file, (const char*)&size, sizeof(int));
 
-    for(int i=0; i < csvNodes.size(); i++) {
-        writeBytes(&file, (const char*)&csvNodes[i].vPos.x, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vPos.y, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vPos.z, sizeof(float));
-
-        writeBytes(&file, (const char*)&csvNodes[i].vDir.x, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vDir.y, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vDir.z, sizeof(float));
-
-        writeBytes(&file, (const char*)&csvNodes[i].vLat.x, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vLat.y, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vLat.z, sizeof(float));
-    }
+    QVector<float> data;
+    writePoints(data);
+    writeFloats(&file, data.constData(), data.size());
 }
 
 void secnlcsv::loadSection(fstream &file)
 {
-    csvNodes.clear();
+    clearPoints();
 
     int size = readInt(&file);
 
-    for(int i=0; i < size; i++) {
-        mnode node;
-        node.vPos = readVec3(&file);
-        node.vDir = readVec3(&file);
-        node.vLat = readVec3(&file);
+    if(size <= 0) return;
 
-        csvNodes.append(node);
-    }
+    QVector<float> data(9*size);
+    readFloats(&file, data.data(), data.size());
+
+    readPoints(data.constData(), size);
 }
 
 void secnlcsv::legacyLoadSection(fstream &file)
 {
-    csvNodes.clear();
+    clearPoints();
 
     int size = readInt(&file);
 
-    for(int i=0; i < size; i++) {
-        mnode node;
-        node.vPos = readVec3(&file);
-        node.vDir = readVec3(&file);
-        node.vLat = readVec3(&file);
+    if(size <= 0) return;
 
-        csvNodes.append(node);
-    }
+    QVector<float> data(9*size);
+    readFloats(&file, data.data(), data.size());
+
+    readPoints(data.constData(), size);
 }
 
 void secnlcsv::saveSection(stringstream &file)
 {
-    int size = csvNodes.size();
+    int size = csvPoints.vPos.size();
 
     file << "CSV";
 
     writeBytes(&file, (const char*)&size, sizeof(int));
 
-    for(int i=0; i < csvNodes.size(); i++) {
-        writeBytes(&file, (const char*)&csvNodes[i].vPos.x, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vPos.y, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vPos.z, sizeof(float));
-
-        writeBytes(&file, (const char*)&csvNodes[i].vDir.x, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vDir.y, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vDir.z, sizeof(float));
-
-        writeBytes(&file, (const char*)&csvNodes[i].vLat.x, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vLat.y, sizeof(float));
-        writeBytes(&file, (const char*)&csvNodes[i].vLat.z, sizeof(float));
-    }
+    QVector<float> data;
+    writePoints(data);
+    writeFloats(&file, data.constData(), data.size());
 }
 
 void secnlcsv::loadSection(stringstream &file)
 {
-    csvNodes.clear();
+    clearPoints();
 
     int size = readInt(&file);
 
-    for(int i=0; i < size; i++) {
-        mnode node;
-        node.vPos = readVec3(&file);
-        node.vDir = readVec3(&file);
-        node.vLat = readVec3(&file);
+    if(size <= 0) return;
 
-        csvNodes.append(node);
-    }
+    QVector<float> data(9*size);
+    readFloats(&file, data.data(), data.size());
+
+    readPoints(data.constData(), size);
 }
 
 float secnlcsv::getMaxArgument()
@@ -244,7 +277,7 @@ void secnlcsv::loadTrack(QString filename)
 {
     QFile file(filename);
 
-    csvNodes.clear();
+    clearPoints();
 
     if (!file.open(QIODevice::ReadOnly)) {
         return ;
@@ -262,15 +295,15 @@ void secnlcsv::loadTrack(QString filename)
             glm::vec3 front = glm::vec3(lineSplitted[4].toFloat(), lineSplitted[5].toFloat(), lineSplitted[6].toFloat());
             glm::vec3 left = -glm::vec3(lineSplitted[7].toFloat(), lineSplitted[8].toFloat(), lineSplitted[9].toFloat());
 
-            mnode node;
-            node.vPos = pos;
-            node.vDir = front;
-            node.vLat = left;
-            csvNodes.append(node);
+            csvPoints.vPos.append(pos);
+            csvPoints.vDir.append(front);
+            csvPoints.vLat.append(left);
         }
 
         lineCount++;
     }
 
+    initDistances();
+
     parent->updateTrack(0, 0);
 }
@@ -2,15 +2,25 @@
 #define SECNLCSV_H
 
 #include <QMap>
+#include <QVector>
 #include "track.h"
 #include "section.h"
 
+// imported csv nodes, one float32 column per field instead of full mnodes
+typedef struct csvpoints_s
+{
+    QVector<glm::vec3> vPos;
+    QVector<glm::vec3> vDir;
+    QVector<glm::vec3> vLat;
+    QVector<float> fTotalLength;
+} csvpoints_t;
+
 class secnlcsv : public section
 {
 public:
     secnlcsv(track* getParent, mnode* first);
     virtual int updateSection(int node = 0);
-    virtual void saveSection(std::fstream& file);
+    virtual void saveSection(std::ostream& file);
     virtual void loadSection(std::fstream& file);
     virtual void legacyLoadSection(std::fstream& file);
     virtual void saveSection(std::stringstream& file);
@@ -20,9 +30,11 @@ public:
     virtual bool isInFunction(int index, subfunc* func);
     void loadTrack(QString filename);
 private:
-    QList<mnode> csvNodes;
+    csvpoints_t csvPoints;
+    void clearPoints();
+    void readPoints(const float* data, int size);
+    void writePoints(QVector<float>& data);
     void initDistances();
-    mnode getNodeAtDistance(float distance);
 };
 
 #endif // SECNLCSV_H
@@ -133,7 +133,7 @@ float secstraight::getMaxArgument()
     return rollFunc->getMaxArgument();
 }
 
-void secstraight::saveSection(std::fstream& file)
+void secstraight::saveSection(std::ostream& file)
 {
     file << "STR";
     writeBytes(&file, (const char*)&bSpeed, sizeof(bool));
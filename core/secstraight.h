@@ -28,7 +28,7 @@ public:
     secstraight(track* getParent, mnode* first, float getlength = 10.0);
     void changelength(float newlength);
     virtual int updateSection(int node = 0);
-    virtual void saveSection(std::fstream& file);
+    virtual void saveSection(std::ostream& file);
     virtual void loadSection(std::fstream& file);
     virtual void legacyLoadSection(std::fstream& file);
     virtual void saveSection(std::stringstream& file);
@@ -206,7 +206,7 @@ void section::fillPointList(QList<glm::vec4> &List, QList<glm::vec3> &Normals, m
     }
 }
 
-void section::iFillPointList(QList<int> &List, float mPerNode)
+void section::iFillPointList(QList<int> &List, float mPerNode, int offset)
 {
 	lNodes[0].updateNorm();
 
@@ -215,7 +215,7 @@ void section::iFillPointList(QList<int> &List, float mPerNode)
     int numNodes = (int)(this->length / mPerNode);
     int nodeCount = 0;
     if(this->type == straight) {
-        List.append(parent->getNumPoints(this)+lNodes.size()-2);
+        List.append(offset+lNodes.size()-2);
         return;
     }
 
@@ -224,17 +224,17 @@ void section::iFillPointList(QList<int> &List, float mPerNode)
 		fThreshold += lNodes[i].fDistFromLast; //glm::distance(lNodes[(i)->fPosHeart(fHeart), lNodes.at(i-1)]-fPosHeart(fHeart));
         //qDebug("Node %d processed: Threshold is now %f", i, fThreshold);
         if(i == this->lNodes.size()-1 || fThreshold > this->length/numNodes) {
-            List.append(parent->getNumPoints(this)+i-1);
+            List.append(offset+i-1);
             fThreshold -= this->length/numNodes;
             ++nodeCount;
         }
     }
-	if(List.size() > 1 && (lNodes[List.last()-parent->getNumPoints(this)+1].fTotalLength - lNodes[List[List.size()-2]-parent->getNumPoints(this)+1].fTotalLength < mPerNode/2.f)) {
+	if(List.size() > 1 && (lNodes[List.last()-offset+1].fTotalLength - lNodes[List[List.size()-2]-offset+1].fTotalLength < mPerNode/2.f)) {
         List.removeAt(List.size()-2);
     }
 }
 
-void section::fFillPointList(QList<int> &List, float mPerNode)
+void section::fFillPointList(QList<int> &List, float mPerNode, int offset)
 {
 	lNodes[0].updateNorm();
 
@@ -249,7 +249,7 @@ void section::fFillPointList(QList<int> &List, float mPerNode)
         if(List.size()) {
             List.last() *= -1;
         }
-        List.append((parent->getNumPoints(this)+lNodes.size()-2)*-1);
+        List.append((offset+lNodes.size()-2)*-1);
         return;
     }
 
@@ -257,12 +257,12 @@ void section::fFillPointList(QList<int> &List, float mPerNode)
 		lNodes[i].updateNorm();
 		fThreshold += lNodes[i].fDistFromLast;
         if(i == this->lNodes.size()-1 || fThreshold > this->length/numNodes) {
-            List.append(parent->getNumPoints(this)+i-1);
+            List.append(offset+i-1);
             fThreshold -= this->length/numNodes;
             ++nodeCount;
         }
     }
-	if(List.size() > 1 && (lNodes[List.last()-parent->getNumPoints(this)+1].fTotalLength - lNodes[List[List.size()-2]-parent->getNumPoints(this)+1].fTotalLength < mPerNode/2.f)) {
+	if(List.size() > 1 && (lNodes[List.last()-offset+1].fTotalLength - lNodes[List[List.size()-2]-offset+1].fTotalLength < mPerNode/2.f)) {
         List.removeAt(List.size()-2);
     }
 }
@@ -359,6 +359,17 @@ bool section::setLocked(eFunctype func, int _id, bool _locked)
     return false;
 }
 
+// first and last node inside func, from is past the last node if there is none.
+// the nodes of a function are contiguous, so scanning is fine where isInFunction is cheap
+void section::getFunctionRange(subfunc* func, int& from, int& to)
+{
+    int last = lNodes.size()-1;
+    from = 0;
+    while(from <= last && !isInFunction(from, func)) ++from;
+    to = from;
+    while(to < last && isInFunction(to+1, func)) ++to;
+}
+
 float section::getSpeed()
 {
     if(bSpeed) {
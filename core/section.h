@@ -53,10 +53,10 @@ public:
     virtual int updateSection(int node = 0) = 0;
     virtual int exportSection(std::fstream *file, mnode* anchor, float mPerNode, float fHeart, glm::vec3& vHeartLat, glm::vec3& Norm, float fRollThresh);
     virtual void fillPointList(QList<glm::vec4> &List, QList<glm::vec3> &Normals, mnode* anchor, float mPerNode, float fHeart);
-    virtual void iFillPointList(QList<int> &List, float mPerNode);
+    virtual void iFillPointList(QList<int> &List, float mPerNode, int offset);
     void         Split(QList<int> &List, int l, int r, float total, float min);
-    virtual void fFillPointList(QList<int> &List, float mPerNode);
-    virtual void saveSection(std::fstream& file) = 0;
+    virtual void fFillPointList(QList<int> &List, float mPerNode, int offset);
+    virtual void saveSection(std::ostream& file) = 0;
     virtual void loadSection(std::fstream& file) = 0;
     virtual void legacyLoadSection(std::fstream& file) = 0;
     virtual void saveSection(std::stringstream& file) = 0;
@@ -64,6 +64,7 @@ public:
     virtual float getMaxArgument() = 0;
     virtual bool isLockable(func* _func) = 0;
     virtual bool isInFunction(int index, subfunc* func) = 0;
+    virtual void getFunctionRange(subfunc* func, int& from, int& to);
     float getSpeed();
     bool setLocked(eFunctype func, int _id, bool _active);
     void calcDirFromLast(int i);
@@ -96,7 +97,7 @@ public:
     QString sName;
 
     // Bezier Section Parameters
-    QList<bezier_t*> bezList;
+    QVector<bezier_t> bezList;
     QList<glm::vec3> supList;
 };
 
@@ -159,7 +159,7 @@ void smoothHandler::setIterations(int _arg)
     treeItem->setText(5, QString::number(iterations));
 }
 
-void smoothHandler::saveSmooth(std::fstream& file)
+void smoothHandler::saveSmooth(std::ostream& file)
 {
     QString name = treeItem->text(1);
     int namelength = name.length();
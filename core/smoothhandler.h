@@ -48,7 +48,7 @@ public:
     void setLength(int _arg);
     void setIterations(int _arg);
 
-    void saveSmooth(std::fstream& file);
+    void saveSmooth(std::ostream& file);
     void loadSmooth(std::fstream& file);
     void legacyLoadSmooth(std::fstream& file);
 
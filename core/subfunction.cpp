@@ -300,55 +300,49 @@ bool subfunc::isSymmetric()
     return false;
 }
 
-void subfunc::saveSubFunc(fstream& file)
+void subfunc::saveSubFunc(ostream& file)
 {
     writeBytes(&file, (const char*)&degree, sizeof(enum eDegree));
-    writeBytes(&file, (const char*)&minArgument, sizeof(float));
-    writeBytes(&file, (const char*)&maxArgument, sizeof(float));
-    writeBytes(&file, (const char*)&startValue, sizeof(float));
-    writeBytes(&file, (const char*)&arg1, sizeof(float));
-    writeBytes(&file, (const char*)&symArg, sizeof(float));
-    writeBytes(&file, (const char*)&centerArg, sizeof(float));
-    writeBytes(&file, (const char*)&tensionArg, sizeof(float));
+    float data[7] = {minArgument, maxArgument, startValue, arg1, symArg, centerArg, tensionArg};
+    writeFloats(&file, data, 7);
     writeBytes(&file, (const char*)&locked, sizeof(bool));
 }
 
 void subfunc::saveSubFunc(stringstream& file)
 {
     writeBytes(&file, (const char*)&degree, sizeof(enum eDegree));
-    writeBytes(&file, (const char*)&minArgument, sizeof(float));
-    writeBytes(&file, (const char*)&maxArgument, sizeof(float));
-    writeBytes(&file, (const char*)&startValue, sizeof(float));
-    writeBytes(&file, (const char*)&arg1, sizeof(float));
-    writeBytes(&file, (const char*)&symArg, sizeof(float));
-    writeBytes(&file, (const char*)&centerArg, sizeof(float));
-    writeBytes(&file, (const char*)&tensionArg, sizeof(float));
+    float data[7] = {minArgument, maxArgument, startValue, arg1, symArg, centerArg, tensionArg};
+    writeFloats(&file, data, 7);
     writeBytes(&file, (const char*)&locked, sizeof(bool));
 }
 
 void subfunc::loadSubFunc(fstream& file)
 {
     degree = (enum eDegree)readInt(&file);
-    minArgument = readFloat(&file);
-    maxArgument = readFloat(&file);
-    startValue = readFloat(&file);
-    arg1 = readFloat(&file);
-    symArg = readFloat(&file);
-    centerArg = readFloat(&file);
-    tensionArg = readFloat(&file);
+    float data[7];
+    readFloats(&file, data, 7);
+    minArgument = data[0];
+    maxArgument = data[1];
+    startValue = data[2];
+    arg1 = data[3];
+    symArg = data[4];
+    centerArg = data[5];
+    tensionArg = data[6];
     locked = readBool(&file);
 }
 
 void subfunc::legacyLoadSubFunc(fstream& file)
 {
     degree = (enum eDegree)readInt(&file);
-    minArgument = readFloat(&file);
-    maxArgument = readFloat(&file);
-    startValue = readFloat(&file);
-    arg1 = readFloat(&file);
-    symArg = readFloat(&file);
-    centerArg = readFloat(&file);
-    tensionArg = readFloat(&file);
+    float data[7];
+    readFloats(&file, data, 7);
+    minArgument = data[0];
+    maxArgument = data[1];
+    startValue = data[2];
+    arg1 = data[3];
+    symArg = data[4];
+    centerArg = data[5];
+    tensionArg = data[6];
     locked = readBool(&file);
 }
 
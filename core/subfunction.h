@@ -63,7 +63,7 @@ public:
     bool isSymmetric();
     float endValue();
 
-    void saveSubFunc(std::fstream& file);
+    void saveSubFunc(std::ostream& file);
     void loadSubFunc(std::fstream& file);
     void legacyLoadSubFunc(std::fstream& file);
     void saveSubFunc(std::stringstream& file);
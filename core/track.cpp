@@ -25,6 +25,8 @@
 #include "trackmesh.h"
 #include "smoothui.h"
 #include "trackwidget.h"
+#include "nodecache.h"
+#include "parallel.h"
 
 #define RELTHRESH 0.98f
 
@@ -52,6 +54,7 @@ track::track(trackHandler* _parent, glm::vec3 startPos, float startYaw, float he
     fFriction = 0.03f;
     fResistance = 2e-5;
     hasChanged = true;
+    unsavedChanges = true;
     drawTrack = true;
     drawHeartline = 0;
     mOptions = gloParent->mOptions;
@@ -61,6 +64,7 @@ track::track(trackHandler* _parent, glm::vec3 startPos, float startYaw, float he
 
     smoothedUntil = 0;
     style = generic;
+    materialized = true;
 }
 
 track::~track()
@@ -81,6 +85,7 @@ track::~track()
 void track::removeSection(int index)
 {
     if(lSections.size() <= index) return;
+    unsavedChanges = true;
 
     delete smoothList[index+1];
     smoothList.removeAt(index+1);
@@ -197,10 +202,11 @@ void track::updateTrack(int index, int iNode)
 {
     //qDebug("called updateTrack(%d, %d)", index, iNode);
     if(index < 0) index = 0;
-    if(lSections.size() <= index)
+    unsavedChanges = true;
+    if(lSections.size() <= index || !materialized)
     {
         hasChanged = true;
-        return;   // for savety
+        return;   // for savety, or nodes are computed later by materialize()
     }
 
     QElapsedTimer timer;
@@ -236,11 +242,27 @@ void track::updateTrack(int index, int iNode)
         removeSmooth(nodeAt);
     }
 
-    int updateFrom = lSections.at(index)->updateSection(iNode);
+    nodeCache* cache = gloParent->mNodeCache;
+    int cached = 0;
+
+    int updateFrom = 0;
+    quint64 key = cache->getKey(lSections.at(index));
+    if(cache->restore(lSections.at(index), key)) {
+        ++cached;
+    } else {
+        updateFrom = lSections.at(index)->updateSection(iNode);
+        cache->store(lSections.at(index), key);
+    }
     for(int i = index+1; i < lSections.size(); i++)
     {
 		lSections.at(i)->lNodes.prepend(lSections.at(i-1)->lNodes[lSections.at(i-1)->lNodes.size()-1]);
-        lSections.at(i)->updateSection(0);
+        key = cache->getKey(lSections.at(i));
+        if(cache->restore(lSections.at(i), key)) {
+            ++cached;
+        } else {
+            lSections.at(i)->updateSection(0);
+            cache->store(lSections.at(i), key);
+        }
     }
 
     if(useSmoothing && smoother && smoother->active()) smoother->applyRollSmooth(nodeAt);
@@ -254,7 +276,7 @@ void track::updateTrack(int index, int iNode)
         mParent->mMesh->buildMeshes(nodeAt);
 
     mSec = timer.nsecsElapsed()/1000000.;
-    gloParent->showMessage(QString::number(mSec).append(QString("ms used to update %1 (%2) points").arg(count2).arg(count)), 3000);
+    gloParent->showMessage(QString::number(mSec).append(QString("ms used to update %1 (%2) points, %3 of %4 sections cached").arg(count2).arg(count).arg(cached).arg(lSections.size()-index)), 3000);
 
     hasChanged = true;
 }
@@ -301,31 +323,7 @@ void track::newSection(enum secType type, int index)
         startNode = anchorNode;
     }
 
-    section* newSection;
-    switch(type)
-    {
-    case 1:
-        newSection = new secstraight(this, startNode, 10);
-        break;
-    case 2:
-        newSection = new seccurved(this, startNode, 90, 15);
-        break;
-    case 3:
-        newSection = new secforced(this, startNode, 1000);
-        break;
-    case 4:
-        newSection = new secgeometric(this, startNode, 1000);
-        break;
-    case 5:
-        newSection = new secbezier(this, startNode);
-        break;
-    case 6:
-        newSection = new secnlcsv(this, startNode);
-        break;
-    default:
-        newSection = NULL;
-        qWarning("Wrong Section type defined!");
-    }
+    section* newSection = createSection(type, startNode);
     activeSection = newSection;
     if(index == -1)
     {
@@ -355,23 +353,76 @@ void track::newSection(enum secType type, int index)
         smoothList.insert(index+1, new smoothHandler(this, index));
     }
     hasChanged = true;
+    unsavedChanges = true;
 }
 
-int track::exportTrack(fstream *file, float mPerNode, int fromIndex, int toIndex, float fRollThresh)
+// a section with default parameters that has not been integrated yet
+section* track::createSection(enum secType type, mnode* startNode)
 {
-    QList<int> exportPoints;
-	mnode* anchor = &lSections.at(fromIndex)->lNodes[0];
+    switch(type)
+    {
+    case 1:
+        return new secstraight(this, startNode, 10);
+    case 2:
+        return new seccurved(this, startNode, 90, 15);
+    case 3:
+        return new secforced(this, startNode, 1000);
+    case 4:
+        return new secgeometric(this, startNode, 1000);
+    case 5:
+        return new secbezier(this, startNode);
+    case 6:
+        return new secnlcsv(this, startNode);
+    default:
+        qWarning("Wrong Section type defined!");
+        return NULL;
+    }
+}
+
+// picks the export points of sections fromIndex to toIndex and resolves their nodes in one pass,
+// with keepStraights the list starts at the first node and straight sections are marked negative
+void track::selectExportPoints(QList<int>& points, QVector<mnode*>& nodes, float mPerNode, int fromIndex, int toIndex, bool keepStraights)
+{
+    int offset = getNumPoints(lSections.at(fromIndex));
+    points.clear();
+    if(keepStraights) points.append(offset);
+
     for(int i = fromIndex; i <= toIndex; ++i)
     {
-        lSections.at(i)->iFillPointList(exportPoints, mPerNode);
+        if(keepStraights) lSections.at(i)->fFillPointList(points, mPerNode, offset);
+        else lSections.at(i)->iFillPointList(points, mPerNode, offset);
+        offset += lSections.at(i)->lNodes.size()-1;
+    }
+
+    // points are ascending, so a section cursor replaces getPoint()
+    nodes.resize(points.size());
+    int cur = fromIndex;
+    offset = getNumPoints(lSections.at(fromIndex));
+    for(int i = 0; i < points.size(); ++i)
+    {
+        int index = abs(points[i]);
+        while(cur < lSections.size()-1 && index - offset > lSections.at(cur)->lNodes.size()-1)
+        {
+            offset += lSections.at(cur++)->lNodes.size()-1;
+        }
+        int node = qMin(index - offset, lSections.at(cur)->lNodes.size()-1);
+        nodes[i] = &lSections.at(cur)->lNodes[node];
     }
+}
+
+int track::exportTrack(fstream *file, float mPerNode, int fromIndex, int toIndex, float fRollThresh)
+{
+    QList<int> exportPoints;
+	mnode* anchor = &lSections.at(fromIndex)->lNodes[0];
+    QVector<mnode*> exportNodes;
+    selectExportPoints(exportPoints, exportNodes, mPerNode, fromIndex, toIndex, false);
 
-    mnode *lastP = anchor, *curP = getPoint(exportPoints[0]);
-    QList<bezier_t*> bezList;
+    mnode *lastP = anchor, *curP = exportNodes[0];
+    QVector<bezier_t> bezList;
 
     for(int i = 0; i < exportPoints.size(); ++i)
     {
-        curP = getPoint(exportPoints[i]);
+        curP = exportNodes[i];
 
         curP->exportNode(bezList, lastP, NULL, anchor, fHeart, fRollThresh);
 
@@ -392,21 +443,21 @@ int track::exportTrack(fstream *file, float mPerNode, int fromIndex, int toIndex
             b[i] = 2.f;
             a[i] = 0.f;
             c[i] = 1.f;
-            d[i] = bezList[i]->P1 + 2.f * bezList[i+1]->P1;
+            d[i] = bezList[i].P1 + 2.f * bezList[i+1].P1;
         }
         else if(i == size-1)
         {
             b[i] = 7.f;
             a[i] = 2.f;
             c[i] = 0.f;
-            d[i] = 8.f*bezList[i]->P1 + bezList[i+1]->P1;
+            d[i] = 8.f*bezList[i].P1 + bezList[i+1].P1;
         }
         else
         {
             a[i] = 1.f;
             b[i] = 4.f;
             c[i] = 1.f;
-            d[i] = 4.f * bezList[i]->P1 + 2.f * bezList[i+1]->P1;
+            d[i] = 4.f * bezList[i].P1 + 2.f * bezList[i+1].P1;
        }
     }
 
@@ -425,12 +476,12 @@ int track::exportTrack(fstream *file, float mPerNode, int fromIndex, int toIndex
     for(size_t i = size-1; i-- > 0;)
     {
         d[i] = d[i] - c[i] * d[i+1];
-        bezList[i+1]->Kp1 = d[i];
-        bezList[i+1]->Kp2 = (bezList[i]->P1 - bezList[i]->Kp1)+bezList[i]->P1;
+        bezList[i+1].Kp1 = d[i];
+        bezList[i+1].Kp2 = (bezList[i].P1 - bezList[i].Kp1)+bezList[i].P1;
     }
 
-    bezList.last()->Kp1 = 0.5f*(bezList.last()->P1 + bezList[size-2]->Kp2);
-    bezList.last()->Kp2 = (bezList.last()->P1 - bezList.last()->Kp1)+bezList.last()->P1;
+    bezList.last().Kp1 = 0.5f*(bezList.last().P1 + bezList[size-2].Kp2);
+    bezList.last().Kp2 = (bezList.last().P1 - bezList.last().Kp1)+bezList.last().P1;
 
 
     writeToExportFile(file, bezList);
@@ -443,26 +494,24 @@ int track::exportTrack2(fstream *file, float mPerNode, int fromIndex, int toInde
     QList<int> exportPoints;
 	mnode* anchor = &lSections.at(fromIndex)->lNodes[0];
     glm::vec3 anchorPos = anchor->vPosHeart(fHeart);
-    for(int i = fromIndex; i <= toIndex; ++i)
-    {
-        lSections.at(i)->iFillPointList(exportPoints, mPerNode);
-    }
+    QVector<mnode*> exportNodes;
+    selectExportPoints(exportPoints, exportNodes, mPerNode, fromIndex, toIndex, false);
 
     glm::vec3 KP1_this, P, KP2_this;
 
-    KP2_this = anchor->vDirHeart(fHeart)*glm::distance(anchor->vPosHeart(fHeart), getPoint(exportPoints[0])->vPosHeart(fHeart))/3.f;
+    KP2_this = anchor->vDirHeart(fHeart)*glm::distance(anchor->vPosHeart(fHeart), exportNodes[0]->vPosHeart(fHeart))/3.f;
     qDebug("KP2_this %f %f %f",KP2_this.x,KP2_this.y,KP2_this.z);
 
     writeBytes(file, (const char*)&(KP2_this.x), 4);
     writeBytes(file, (const char*)&(KP2_this.y), 4);
     writeBytes(file, (const char*)&(KP2_this.z), 4);
 
-    glm::vec3 startPoint = getPoint(exportPoints[0])->vPosHeart(fHeart)+(KP2_this+anchorPos - getPoint(exportPoints[0])->vPosHeart(fHeart))/2.f*3.f;
+    glm::vec3 startPoint = exportNodes[0]->vPosHeart(fHeart)+(KP2_this+anchorPos - exportNodes[0]->vPosHeart(fHeart))/2.f*3.f;
     qDebug("startPoint %f %f %f",startPoint.x,startPoint.y,startPoint.z);
 
-    P = glm::vec3((1/6.f)*(startPoint+4.f*getPoint(exportPoints[0])->vPosHeart(fHeart)+getPoint(exportPoints[1])->vPosHeart(fHeart)))-anchorPos;
-    KP1_this = glm::vec3((1/3.f)*(startPoint+2.f*getPoint(exportPoints[0])->vPosHeart(fHeart)))-anchorPos;
-    KP2_this = glm::vec3((1/3.f)*(2.f*getPoint(exportPoints[0])->vPosHeart(fHeart)+getPoint(exportPoints[1])->vPosHeart(fHeart)))-anchorPos;
+    P = glm::vec3((1/6.f)*(startPoint+4.f*exportNodes[0]->vPosHeart(fHeart)+exportNodes[1]->vPosHeart(fHeart)))-anchorPos;
+    KP1_this = glm::vec3((1/3.f)*(startPoint+2.f*exportNodes[0]->vPosHeart(fHeart)))-anchorPos;
+    KP2_this = glm::vec3((1/3.f)*(2.f*exportNodes[0]->vPosHeart(fHeart)+exportNodes[1]->vPosHeart(fHeart)))-anchorPos;
 
     writeBytes(file, (const char*)&(KP1_this.x), 4);
     writeBytes(file, (const char*)&(KP1_this.y), 4);
@@ -474,8 +523,8 @@ int track::exportTrack2(fstream *file, float mPerNode, int fromIndex, int toInde
 
     glm::vec3 V = glm::normalize(P - KP1_this);
 
-    glm::vec3 vHeartLat = glm::normalize(glm::cross(getPoint(exportPoints[0])->vNorm, V));
-    float temp = glm::atan(vHeartLat.y, -getPoint(exportPoints[0])->vNorm.y);
+    glm::vec3 vHeartLat = glm::normalize(glm::cross(exportNodes[0]->vNorm, V));
+    float temp = glm::atan(vHeartLat.y, -exportNodes[0]->vNorm.y);
     if(fabs(V.y) > fRollThresh)
     {
         glm::vec3 vLastLat = anchor->vLatHeart(fHeart);
@@ -515,9 +564,9 @@ int track::exportTrack2(fstream *file, float mPerNode, int fromIndex, int toInde
         writeBytes(file, (const char*)&(KP2_this.y), 4);
         writeBytes(file, (const char*)&(KP2_this.z), 4);
 
-        P = glm::vec3((1/6.f)*(getPoint(exportPoints[i-1])->vPosHeart(fHeart)+4.f*getPoint(exportPoints[i])->vPosHeart(fHeart)+getPoint(exportPoints[i+1])->vPosHeart(fHeart)))-anchorPos;
-        KP1_this = glm::vec3((1/3.f)*(getPoint(exportPoints[i-1])->vPosHeart(fHeart)+2.f*getPoint(exportPoints[i])->vPosHeart(fHeart)))-anchorPos;
-        KP2_this = glm::vec3((1/3.f)*(2.f*getPoint(exportPoints[i])->vPosHeart(fHeart)+getPoint(exportPoints[i+1])->vPosHeart(fHeart)))-anchorPos;
+        P = glm::vec3((1/6.f)*(exportNodes[i-1]->vPosHeart(fHeart)+4.f*exportNodes[i]->vPosHeart(fHeart)+exportNodes[i+1]->vPosHeart(fHeart)))-anchorPos;
+        KP1_this = glm::vec3((1/3.f)*(exportNodes[i-1]->vPosHeart(fHeart)+2.f*exportNodes[i]->vPosHeart(fHeart)))-anchorPos;
+        KP2_this = glm::vec3((1/3.f)*(2.f*exportNodes[i]->vPosHeart(fHeart)+exportNodes[i+1]->vPosHeart(fHeart)))-anchorPos;
 
         writeBytes(file, (const char*)&(KP1_this.x), 4);
         writeBytes(file, (const char*)&(KP1_this.y), 4);
@@ -529,14 +578,14 @@ int track::exportTrack2(fstream *file, float mPerNode, int fromIndex, int toInde
 
         glm::vec3 V = glm::normalize(P - KP1_this);
 
-        glm::vec3 vHeartLat = glm::normalize(glm::cross(getPoint(exportPoints[i])->vNorm, V));
-        float temp = glm::atan(vHeartLat.y, -getPoint(exportPoints[i])->vNorm.y);
+        glm::vec3 vHeartLat = glm::normalize(glm::cross(exportNodes[i]->vNorm, V));
+        float temp = glm::atan(vHeartLat.y, -exportNodes[i]->vNorm.y);
         if(fabs(V.y) > fRollThresh)
         {
-            glm::vec3 vLastLat = getPoint(exportPoints[i-1])->vLatHeart(fHeart);
+            glm::vec3 vLastLat = exportNodes[i-1]->vLatHeart(fHeart);
 
-            glm::vec3 rotateAxis = glm::cross(getPoint(exportPoints[i-1])->vDirHeart(fHeart), V);
-            glm::vec3 rotated = glm::vec3(glm::rotate(glm::angle(getPoint(exportPoints[i-1])->vDirHeart(fHeart), V), rotateAxis)*glm::vec4(vLastLat, 0.f));
+            glm::vec3 rotateAxis = glm::cross(exportNodes[i-1]->vDirHeart(fHeart), V);
+            glm::vec3 rotated = glm::vec3(glm::rotate(glm::angle(exportNodes[i-1]->vDirHeart(fHeart), V), rotateAxis)*glm::vec4(vLastLat, 0.f));
             temp = glm::angle(rotated, vHeartLat)*F_PI/180.f;
             if(glm::dot(glm::cross(rotated, vHeartLat), V) > 0)
             {
@@ -568,12 +617,12 @@ int track::exportTrack2(fstream *file, float mPerNode, int fromIndex, int toInde
     writeBytes(file, (const char*)&(KP2_this.y), 4);
     writeBytes(file, (const char*)&(KP2_this.z), 4);
 
-    glm::vec3 endPoint = getPoint(exportPoints[exportPoints.size()-1])->vPosHeart(fHeart) - getPoint(exportPoints[exportPoints.size()-1])->vDirHeart(fHeart)*glm::distance(getPoint(exportPoints[exportPoints.size()-1])->vPosHeart(fHeart), getPoint(exportPoints[exportPoints.size()-2])->vPosHeart(fHeart));
+    glm::vec3 endPoint = exportNodes[exportPoints.size()-1]->vPosHeart(fHeart) - exportNodes[exportPoints.size()-1]->vDirHeart(fHeart)*glm::distance(exportNodes[exportPoints.size()-1]->vPosHeart(fHeart), exportNodes[exportPoints.size()-2]->vPosHeart(fHeart));
     qDebug("endPoint %f %f %f",endPoint.x,endPoint.y,endPoint.z);
 
-    P = glm::vec3((1/6.f)*(getPoint(exportPoints[i-1])->vPosHeart(fHeart)+4.f*endPoint+getPoint(exportPoints[i+1])->vPosHeart(fHeart)))-anchorPos;
-    KP1_this = glm::vec3((1/3.f)*(getPoint(exportPoints[i-1])->vPosHeart(fHeart)+2.f*endPoint))-anchorPos;
-    KP2_this = glm::vec3((1/3.f)*(2.f*endPoint+getPoint(exportPoints[i+1])->vPosHeart(fHeart)))-anchorPos;
+    P = glm::vec3((1/6.f)*(exportNodes[i-1]->vPosHeart(fHeart)+4.f*endPoint+exportNodes[i+1]->vPosHeart(fHeart)))-anchorPos;
+    KP1_this = glm::vec3((1/3.f)*(exportNodes[i-1]->vPosHeart(fHeart)+2.f*endPoint))-anchorPos;
+    KP2_this = glm::vec3((1/3.f)*(2.f*endPoint+exportNodes[i+1]->vPosHeart(fHeart)))-anchorPos;
 
     writeBytes(file, (const char*)&(KP1_this.x), 4);
     writeBytes(file, (const char*)&(KP1_this.y), 4);
@@ -585,14 +634,14 @@ int track::exportTrack2(fstream *file, float mPerNode, int fromIndex, int toInde
 
     V = glm::normalize(P - KP1_this);
 
-    vHeartLat = glm::normalize(glm::cross(getPoint(exportPoints[i])->vNorm, V));
-    temp = glm::atan(vHeartLat.y, -getPoint(exportPoints[i])->vNorm.y);
+    vHeartLat = glm::normalize(glm::cross(exportNodes[i]->vNorm, V));
+    temp = glm::atan(vHeartLat.y, -exportNodes[i]->vNorm.y);
     if(fabs(V.y) > fRollThresh)
     {
-        glm::vec3 vLastLat = getPoint(exportPoints[i-1])->vLatHeart(fHeart);
+        glm::vec3 vLastLat = exportNodes[i-1]->vLatHeart(fHeart);
 
-        glm::vec3 rotateAxis = glm::cross(getPoint(exportPoints[i-1])->vDirHeart(fHeart), V);
-        glm::vec3 rotated = glm::vec3(glm::rotate(glm::angle(getPoint(exportPoints[i-1])->vDirHeart(fHeart), V), rotateAxis)*glm::vec4(vLastLat, 0.f));
+        glm::vec3 rotateAxis = glm::cross(exportNodes[i-1]->vDirHeart(fHeart), V);
+        glm::vec3 rotated = glm::vec3(glm::rotate(glm::angle(exportNodes[i-1]->vDirHeart(fHeart), V), rotateAxis)*glm::vec4(vLastLat, 0.f));
         temp = glm::angle(rotated, vHeartLat)*F_PI/180.f;
         if(glm::dot(glm::cross(rotated, vHeartLat), V) > 0)
         {
@@ -624,8 +673,8 @@ int track::exportTrack2(fstream *file, float mPerNode, int fromIndex, int toInde
     writeBytes(file, (const char*)&(KP2_this.z), 4);
 
 
-    P = getPoint(exportPoints[exportPoints.size()-1])->vPosHeart(fHeart)-anchorPos;
-    KP1_this = P-getPoint(exportPoints[exportPoints.size()-1])->vDirHeart(fHeart)*glm::distance(getPoint(exportPoints[exportPoints.size()-1])->vPosHeart(fHeart), getPoint(exportPoints[exportPoints.size()-2])->vPosHeart(fHeart))/3.f;
+    P = exportNodes[exportPoints.size()-1]->vPosHeart(fHeart)-anchorPos;
+    KP1_this = P-exportNodes[exportPoints.size()-1]->vDirHeart(fHeart)*glm::distance(exportNodes[exportPoints.size()-1]->vPosHeart(fHeart), exportNodes[exportPoints.size()-2]->vPosHeart(fHeart))/3.f;
 
     writeBytes(file, (const char*)&(KP1_this.x), 4);
     writeBytes(file, (const char*)&(KP1_this.y), 4);
@@ -637,14 +686,14 @@ int track::exportTrack2(fstream *file, float mPerNode, int fromIndex, int toInde
 
     V = glm::normalize(P - KP1_this);
 
-    vHeartLat = glm::normalize(glm::cross(getPoint(exportPoints[i])->vNorm, V));
-    temp = glm::atan(vHeartLat.y, -getPoint(exportPoints[i])->vNorm.y);
+    vHeartLat = glm::normalize(glm::cross(exportNodes[i]->vNorm, V));
+    temp = glm::atan(vHeartLat.y, -exportNodes[i]->vNorm.y);
     if(fabs(V.y) > fRollThresh)
     {
-        glm::vec3 vLastLat = getPoint(exportPoints[i-1])->vLatHeart(fHeart);
+        glm::vec3 vLastLat = exportNodes[i-1]->vLatHeart(fHeart);
 
-        glm::vec3 rotateAxis = glm::cross(getPoint(exportPoints[i-1])->vDirHeart(fHeart), V);
-        glm::vec3 rotated = glm::vec3(glm::rotate(glm::angle(getPoint(exportPoints[i-1])->vDirHeart(fHeart), V), rotateAxis)*glm::vec4(vLastLat, 0.f));
+        glm::vec3 rotateAxis = glm::cross(exportNodes[i-1]->vDirHeart(fHeart), V);
+        glm::vec3 rotated = glm::vec3(glm::rotate(glm::angle(exportNodes[i-1]->vDirHeart(fHeart), V), rotateAxis)*glm::vec4(vLastLat, 0.f));
         temp = glm::angle(rotated, vHeartLat)*F_PI/180.f;
         if(glm::dot(glm::cross(rotated, vHeartLat), V) > 0)
         {
@@ -673,24 +722,23 @@ int track::exportTrack2(fstream *file, float mPerNode, int fromIndex, int toInde
     return exportPoints.size();
 }
 
-int track::exportTrack3(fstream *file, float mPerNode, int fromIndex, int toIndex, float fRollThresh)
+int track::exportTrack3(fstream *file, float mPerNode, int fromIndex, int toIndex, float fRollThresh, exportprogress_t* progress)
 {
     QList<int> exportPoints;
 	mnode* anchor = &lSections.at(fromIndex)->lNodes[0];
-    for(int i = fromIndex; i <= toIndex; ++i)
-    {
-        lSections.at(i)->iFillPointList(exportPoints, mPerNode);
-    }
+    QVector<mnode*> exportNodes;
+    selectExportPoints(exportPoints, exportNodes, mPerNode, fromIndex, toIndex, false);
 
-    mnode *lastP = anchor, *curP = getPoint(exportPoints[0]);
-    QList<bezier_t*> bezList;
+    mnode *lastP = anchor, *curP = exportNodes[0];
+    QVector<bezier_t> bezList;
 
-    bezList.append(new bezier_t);
-    bezList[0]->P1 = glm::vec3(0.f, 0.f, 0.f);
+    bezList.append(bezier_t());
+    bezList[0].P1 = glm::vec3(0.f, 0.f, 0.f);
 
     for(int i = 0; i < exportPoints.size(); ++i)
     {
-        curP = getPoint(exportPoints[i]);
+        if(!exportStep(progress, i, exportPoints.size())) return -1;
+        curP = exportNodes[i];
 
         curP->exportNode(bezList, lastP, NULL, anchor, fHeart, fRollThresh);
 
@@ -706,7 +754,7 @@ int track::exportTrack3(fstream *file, float mPerNode, int fromIndex, int toInde
 
     for(size_t i = 0; i < size; ++i)
     {
-        d[i] = bezList[i]->P1;
+        d[i] = bezList[i].P1;
         if(i == 0)
         {
             a[i] = 0.f;
@@ -747,39 +795,31 @@ int track::exportTrack3(fstream *file, float mPerNode, int fromIndex, int toInde
     int i;
     for(i = 1; i < bezList.size(); ++i)
     {
-        bezList[i]->Kp1 = 1.f/3.f*(d[i]+2.f*d[i-1]);
-        bezList[i]->Kp2 = 1.f/3.f*(2.f*d[i]+d[i-1]);
-        bezList[i-1]->P1 = 0.5f*(bezList[i-1]->Kp2 + bezList[i]->Kp1);
+        bezList[i].Kp1 = 1.f/3.f*(d[i]+2.f*d[i-1]);
+        bezList[i].Kp2 = 1.f/3.f*(2.f*d[i]+d[i-1]);
+        bezList[i-1].P1 = 0.5f*(bezList[i-1].Kp2 + bezList[i].Kp1);
     }
-    delete bezList[0];
-
     bezList.removeFirst();
 
     writeToExportFile(file, bezList);
 
-    for(int i = 0; i < bezList.size(); ++i)
-    {
-        delete bezList[i];
-    }
-
     return exportPoints.size();
 }
 
-int track::exportTrack4(fstream *file, float mPerNode, int fromIndex, int toIndex, float fRollThresh)
+int track::exportTrack4(fstream *file, float mPerNode, int fromIndex, int toIndex, float fRollThresh, exportprogress_t* progress)
 {
     QList<int> exportPoints;
 	mnode* anchor = &lSections.at(fromIndex)->lNodes[0];
-    for(int i = fromIndex; i <= toIndex; ++i)
-    {
-        lSections.at(i)->iFillPointList(exportPoints, mPerNode);
-    }
+    QVector<mnode*> exportNodes;
+    selectExportPoints(exportPoints, exportNodes, mPerNode, fromIndex, toIndex, false);
 
-    mnode *last = anchor, *current = getPoint(exportPoints[0]), *mid = getPoint(exportPoints[0]/2);
-    QList<bezier_t*> bezList;
+    mnode *last = anchor, *current = exportNodes[0], *mid = NULL;
+    QVector<bezier_t> bezList;
 
     for(int i = 0; i < exportPoints.size(); ++i)
     {
-        current = getPoint(exportPoints[i]);
+        if(!exportStep(progress, i, exportPoints.size())) return -1;
+        current = exportNodes[i];
 
         mid = NULL; //i == 0 ? getPoint(exportPoints[0]/2) : getPoint((exportPoints[i]+exportPoints[i-1])/2);
 
@@ -793,21 +833,234 @@ int track::exportTrack4(fstream *file, float mPerNode, int fromIndex, int toInde
     return exportPoints.size();
 }
 
-void track::exportNL2Track(FILE *file, float mPerNode, int fromIndex, int toIndex)
+#define ADAPTIVE_SAMPLES 64     // interior nodes tested per candidate bezier
+
+// heartline frames of the nodes an adaptive export is fitted to
+struct adaptiveFrames {
+    QVector<glm::vec3> pos, dir, lat;
+    QVector<float> length;
+};
+
+// control point distance of a cubic following a circular arc between two frames,
+// degrades to a third of the chord on straights
+static float adaptiveHandle(const glm::vec3& p0, const glm::vec3& d0, const glm::vec3& p3, const glm::vec3& d3)
 {
-    QList<int> exportPoints, rollPoints;
-	mnode* anchor = &lSections.at(fromIndex)->lNodes[0];
-    exportPoints.append(getNumPoints(lSections.at(fromIndex)));
-    rollPoints.append(getNumPoints(lSections.at(fromIndex)));
-    for(int i = fromIndex; i <= toIndex; ++i)
-    {
-        lSections.at(i)->fFillPointList(exportPoints, mPerNode);
+    float chord = glm::length(p3 - p0);
+    float angle = acos(glm::clamp(glm::dot(d0, d3), -1.f, 1.f));
+    if(angle < 1e-4f) return chord/3.f;
+    float radius = chord/(2.f*sin(angle/2.f));
+    return 4.f/3.f*tan(angle/4.f)*radius;
+}
+
+// largest error of the bezier from node "from" to node "to" relative to the tolerances,
+// worst is set to the interior node that violates them most
+static float adaptiveError(const adaptiveFrames& f, int from, int to, float tolerance, float rollTolerance, int& worst)
+{
+    glm::vec3 P0 = f.pos[from], P3 = f.pos[to];
+    float h = adaptiveHandle(P0, f.dir[from], P3, f.dir[to]);
+    glm::vec3 P1 = P0 + h*f.dir[from], P2 = P3 - h*f.dir[to];
+    float totalLength = f.length[to] - f.length[from];
+
+    float maxError = 0.f;
+    worst = (from + to)/2;
+    int stride = qMax(1, (to - from)/ADAPTIVE_SAMPLES);
+
+    for(int k = from + stride; k < to; k += stride) {
+        float u = totalLength > 0.f ? (f.length[k] - f.length[from])/totalLength : 0.5f;
+
+        // project the node onto the curve, starting from its arc length fraction
+        float t = u;
+        glm::vec3 B;
+        for(int n = 0; n < 3; ++n) {
+            float s = 1.f - t;
+            B = s*s*s*P0 + 3.f*s*s*t*P1 + 3.f*s*t*t*P2 + t*t*t*P3;
+            glm::vec3 dB = 3.f*s*s*(P1-P0) + 6.f*s*t*(P2-P1) + 3.f*t*t*(P3-P2);
+            glm::vec3 ddB = 6.f*s*(P2-2.f*P1+P0) + 6.f*t*(P3-2.f*P2+P1);
+            float denom = glm::dot(dB, dB) + glm::dot(B - f.pos[k], ddB);
+            if(fabs(denom) < 1e-8f) break;
+            t = glm::clamp(t - glm::dot(B - f.pos[k], dB)/denom, 0.f, 1.f);
+        }
+        float s = 1.f - t;
+        B = s*s*s*P0 + 3.f*s*s*t*P1 + 3.f*s*t*t*P2 + t*t*t*P3;
+        float error = glm::length(B - f.pos[k])/tolerance;
+
+        // roll is blended between the end frames along the arc length
+        glm::vec3 lat = glm::mix(f.lat[from], f.lat[to], u);
+        lat -= f.dir[k]*glm::dot(lat, f.dir[k]);
+        float latLength = glm::length(lat);
+        if(latLength < 1e-3f) {
+            error = qMax(error, 2.f);
+        } else {
+            float rollError = acos(glm::clamp(glm::dot(lat/latLength, f.lat[k]), -1.f, 1.f))*180.f/F_PI;
+            error = qMax(error, rollError/rollTolerance);
+        }
+
+        if(error > maxError) {
+            maxError = error;
+            worst = k;
+        }
     }
+    return maxError;
+}
 
-    for(int i = 0; i < exportPoints.size(); ++i) {
-        qDebug("%d\n", exportPoints[i]);
+// fits as few beziers as possible to sections fromIndex to toIndex, a bezier is split at its worst node
+// while the heartline deviates more than tolerance (in m) or the roll more than rollTolerance (in deg)
+int track::exportTrackAdaptive(fstream *file, float tolerance, float rollTolerance, int fromIndex, int toIndex, float fRollThresh, exportprogress_t* progress)
+{
+    QVector<mnode*> nodes;
+    QVector<bool> keep;
+    for(int i = fromIndex; i <= toIndex; ++i) {
+        section* curSection = lSections.at(i);
+        for(int j = nodes.isEmpty() ? 0 : 1; j < curSection->lNodes.size(); ++j) {
+            nodes.append(&curSection->lNodes[j]);
+            keep.append(false);
+        }
+        // section transitions are kept, curvature is rarely continuous across them
+        if(!keep.isEmpty()) keep.last() = true;
+    }
+    if(nodes.size() < 2) return 0;
+    keep[0] = true;
+
+    adaptiveFrames frames;
+    frames.pos.resize(nodes.size());
+    frames.dir.resize(nodes.size());
+    frames.lat.resize(nodes.size());
+    frames.length.resize(nodes.size());
+    for(int i = 0; i < nodes.size(); ++i) {
+        frames.pos[i] = nodes[i]->vPosHeart(fHeart);
+        frames.dir[i] = nodes[i]->vDirHeart(fHeart);
+        frames.lat[i] = nodes[i]->vLatHeart(fHeart);
+        frames.length[i] = nodes[i]->fTotalHeartLength;
+    }
+
+    QList<int> pending;
+    int last = 0;
+    for(int i = 1; i < nodes.size(); ++i) {
+        if(!keep[i]) continue;
+        pending.append(last);
+        pending.append(i);
+        last = i;
+    }
+    // intervals are resolved from the end of the track, so every node past "to" is done
+    while(!pending.isEmpty()) {
+        int to = pending.takeLast();
+        int from = pending.takeLast();
+        if(!exportStep(progress, nodes.size()-1-to, nodes.size())) return -1;
+        if(to - from < 2) continue;
+
+        int worst;
+        if(adaptiveError(frames, from, to, tolerance, rollTolerance, worst) <= 1.f) continue;
+
+        keep[worst] = true;
+        pending.append(from);
+        pending.append(worst);
+        pending.append(worst);
+        pending.append(to);
+    }
+
+    mnode* anchor = nodes[0];
+    float temp = glm::length(glm::vec3(anchor->vDir.x, 0.f, anchor->vDir.z));
+    glm::mat3 anchorBase = glm::mat3(-anchor->vDir.z/temp, 0.f, -anchor->vDir.x/temp,
+                     0.f, 1.f, 0.f,
+                     anchor->vDir.x/temp, 0.f, -anchor->vDir.z/temp);
+
+    QVector<bezier_t> bezList;
+    last = 0;
+    for(int i = 1; i < nodes.size(); ++i) {
+        if(!keep[i]) continue;
+
+        // roll and position come from the regular node export, only the handles are refitted
+        nodes[i]->exportNode(bezList, nodes[last], NULL, anchor, fHeart, fRollThresh);
+
+        float h = adaptiveHandle(frames.pos[last], frames.dir[last], frames.pos[i], frames.dir[i]);
+        bezList.last().Kp1 = anchorBase*(frames.pos[last] - frames.pos[0] + h*frames.dir[last]);
+        bezList.last().Kp2 = bezList.last().P1 - anchorBase*(h*frames.dir[i]);
+        last = i;
     }
 
+    writeToExportFile(file, bezList);
+
+    return bezList.size();
+}
+
+#define NL2_CHUNK 2048      // vertices or roll nodes formatted per job
+
+// formats a range of NL2 element vertices or roll nodes into its own block, blocks are written in order
+struct nl2Formatter {
+    const QList<glm::vec4>* vertices;
+    QVector<mnode*> nodes;
+    glm::mat3 anchorBase;
+    float startLen, endLen;
+    QByteArray* blocks;
+    exportprogress_t* progress;
+
+    void operator()(int chunk, int from, int to) const {
+        if(progress && progress->canceled.load()) return;
+        QByteArray& out = blocks[chunk];
+        if(vertices) {
+            out.reserve((to - from)*120);
+            for(int i = from; i < to; ++i) {
+                glm::vec3 ex = anchorBase*glm::vec3(vertices->at(i));
+                out.append("\t\t\t<vertex>\n\t\t\t\t<x>");
+                appendFloat(out, ex.x);
+                out.append("</x>\n\t\t\t\t<y>");
+                appendFloat(out, ex.y);
+                out.append("</y>\n\t\t\t\t<z>");
+                appendFloat(out, ex.z);
+                out.append("</z>\n");
+                if(vertices->at(i).w > 0.5f) {
+                    out.append("\t\t\t\t<strict>true</strict>\n");
+                }
+                out.append("\t\t\t</vertex>\n");
+            }
+        } else {
+            out.reserve((to - from)*300);
+            for(int i = from; i < to; ++i) {
+                mnode* curNode = nodes[i];
+
+                glm::vec3 up = anchorBase*(-curNode->vNorm);
+                glm::vec3 right = anchorBase*(curNode->vLat);
+                float coord = (curNode->fTotalHeartLength-startLen)/(endLen-startLen);
+
+                out.append("\t\t\t<roll>\n\t\t\t\t<ux>");
+                appendFloat(out, up.x);
+                out.append("</ux>\n\t\t\t\t<uy>");
+                appendFloat(out, up.y);
+                out.append("</uy>\n\t\t\t\t<uz>");
+                appendFloat(out, up.z);
+                out.append("</uz>\n\t\t\t\t<rx>");
+                appendFloat(out, right.x);
+                out.append("</rx>\n\t\t\t\t<ry>");
+                appendFloat(out, right.y);
+                out.append("</ry>\n\t\t\t\t<rz>");
+                appendFloat(out, right.z);
+                out.append("</rz>\n\t\t\t\t<coord>");
+                appendFloat(out, coord);
+                out.append("</coord>\n\t\t\t\t<strict>false</strict>\n\t\t\t</roll>\n");
+            }
+        }
+        if(progress) progress->done.fetchAndAddRelaxed(to - from);
+    }
+};
+
+static void writeNL2Blocks(FILE* file, nl2Formatter& formatter, int count)
+{
+    QVector<QByteArray> blocks((count + NL2_CHUNK - 1)/NL2_CHUNK);
+    formatter.blocks = blocks.data();
+    parallelChunks(count, NL2_CHUNK, formatter);
+
+    for(int i = 0; i < blocks.size(); ++i) {
+        fwrite(blocks[i].constData(), 1, blocks[i].size(), file);
+    }
+}
+
+void track::exportNL2Track(FILE *file, float mPerNode, int fromIndex, int toIndex, exportprogress_t* progress)
+{
+    QList<int> exportPoints;
+	mnode* anchor = &lSections.at(fromIndex)->lNodes[0];
+    QVector<mnode*> exportNodes;
+    selectExportPoints(exportPoints, exportNodes, mPerNode, fromIndex, toIndex, true);
+
     size_t size = exportPoints.size();
     QVector<float> a = QVector<float>(size);
     QVector<float> b = QVector<float>(size);
@@ -817,7 +1070,7 @@ void track::exportNL2Track(FILE *file, float mPerNode, int fromIndex, int toInde
     for(size_t i = 0; i < size; ++i)
     {
         int point = exportPoints[i];
-        mnode* curNode = getPoint(point < 0 ? -point : point);
+        mnode* curNode = exportNodes[i];
         d[i] = curNode->vPos - anchor->vPos;
         if(i == 0 || i == size-1 || point < 0) {
             a[i] = 0.f;
@@ -876,8 +1129,8 @@ void track::exportNL2Track(FILE *file, float mPerNode, int fromIndex, int toInde
         // if strict == 7 -> can't happen
 
         if(strict == 1) {
-            glm::vec3 dir = getPoint(ppoint)->vDir;
-            glm::vec3 nP = getPoint(npoint)->vPos;
+            glm::vec3 dir = exportNodes[i-1]->vDir;
+            glm::vec3 nP = exportNodes[i+1]->vPos;
             float a = glm::length(nP-d[i-1]);
             float cosa = glm::dot(glm::normalize(nP-d[i-1]), dir);
             e.append(glm::vec4(d[i-1]+dir*a/(2.f*cosa), 0.f));
@@ -886,14 +1139,14 @@ void track::exportNL2Track(FILE *file, float mPerNode, int fromIndex, int toInde
         } else if (strict == 3) {
             e.append(glm::vec4(d[i], 1.f));
         } else if (strict == 4) {
-            glm::vec3 dir = getPoint(npoint)->vDir;
-            glm::vec3 pP = getPoint(ppoint)->vPos;
+            glm::vec3 dir = exportNodes[i+1]->vDir;
+            glm::vec3 pP = exportNodes[i-1]->vPos;
             float a = glm::length(d[i+1]-pP);
             float cosa = glm::dot(glm::normalize(d[i+1]-pP), dir);
             e.append(glm::vec4(d[i+1]-dir*a/(2.f*cosa), 0.f));
         } else if (strict == 5) {
-            glm::vec3 dp = getPoint(npoint)->vPos - getPoint(ppoint)->vPos;
-            glm::vec3 dv = getPoint(npoint)->vDir + getPoint(ppoint)->vDir;
+            glm::vec3 dp = exportNodes[i+1]->vPos - exportNodes[i-1]->vPos;
+            glm::vec3 dv = exportNodes[i+1]->vDir + exportNodes[i-1]->vDir;
 
             float a = glm::length2(dv)-1.f;
             float b = glm::dot(dv, dp)*2.f;
@@ -906,8 +1159,8 @@ void track::exportNL2Track(FILE *file, float mPerNode, int fromIndex, int toInde
             float x0 = -p + sqrt(p*p - c);
             //float x1 = -p - sqrt(p*p - c); // second solution (unsused)
 
-            e.append(glm::vec4(getPoint(ppoint)->vPos-x0*getPoint(ppoint)->vDir, 0.f));
-            e.append(glm::vec4(getPoint(npoint)->vPos+x0*getPoint(npoint)->vDir, 0.f));
+            e.append(glm::vec4(exportNodes[i-1]->vPos-x0*exportNodes[i-1]->vDir, 0.f));
+            e.append(glm::vec4(exportNodes[i+1]->vPos+x0*exportNodes[i+1]->vDir, 0.f));
 
             //qDebug("%f, %f", x0, x1);
 
@@ -926,41 +1179,20 @@ void track::exportNL2Track(FILE *file, float mPerNode, int fromIndex, int toInde
                      0.f, 1.f, 0.f,
                      -anchor->vDir.x/temp, 0.f, -anchor->vDir.z/temp));
 
-    for(int i = 0; i < e.size(); ++i) {
-        glm::vec3 ex = anchorBase*glm::vec3(e[i]);
-        fprintf(file, "\t\t\t<vertex>\n");
-        fprintf(file, "\t\t\t\t<x>%e</x>\n", ex.x);
-        fprintf(file, "\t\t\t\t<y>%e</y>\n", ex.y);
-        fprintf(file, "\t\t\t\t<z>%e</z>\n", ex.z);
-        if(e[i].w > 0.5f) {
-            fprintf(file, "\t\t\t\t<strict>true</strict>\n");
-        }
-        fprintf(file, "\t\t\t</vertex>\n");
-    }
-
-    float startLen = getPoint(exportPoints[0])->fTotalHeartLength;
-    int lp = abs(exportPoints.last());
-    float endLen = getPoint(lp)->fTotalHeartLength;
+    if(!exportStep(progress, 0, e.size() + exportNodes.size())) return;
 
-    for(size_t i = 0; i < size; ++i) {
-        int point = exportPoints[i];
-        mnode* curNode = getPoint(point < 0 ? -point : point);
+    nl2Formatter formatter;
+    formatter.progress = progress;
+    formatter.anchorBase = anchorBase;
+    formatter.startLen = exportNodes[0]->fTotalHeartLength;
+    formatter.endLen = exportNodes.last()->fTotalHeartLength;
+    formatter.vertices = &e;
+    writeNL2Blocks(file, formatter, e.size());
+    if(progress && progress->canceled.load()) return;
 
-        glm::vec3 up = anchorBase*(-curNode->vNorm);
-        glm::vec3 right = anchorBase*(curNode->vLat);
-        float coord = (curNode->fTotalHeartLength-startLen)/(endLen-startLen);
-
-        fprintf(file, "\t\t\t<roll>\n");
-        fprintf(file, "\t\t\t\t<ux>%e</ux>\n", up.x);
-        fprintf(file, "\t\t\t\t<uy>%e</uy>\n", up.y);
-        fprintf(file, "\t\t\t\t<uz>%e</uz>\n", up.z);
-        fprintf(file, "\t\t\t\t<rx>%e</rx>\n", right.x);
-        fprintf(file, "\t\t\t\t<ry>%e</ry>\n", right.y);
-        fprintf(file, "\t\t\t\t<rz>%e</rz>\n", right.z);
-        fprintf(file, "\t\t\t\t<coord>%e</coord>\n", coord);
-        fprintf(file, "\t\t\t\t<strict>false</strict>\n");
-        fprintf(file, "\t\t\t</roll>\n");
-    }
+    formatter.vertices = NULL;
+    formatter.nodes = exportNodes;
+    writeNL2Blocks(file, formatter, exportNodes.size());
 
     return;
 }
@@ -969,36 +1201,7 @@ QString track::saveTrack(fstream& file, trackWidget* _widget)
 {   
     file << "TRC";
 
-    int namelength = name.length();
-    std::string stdName = name.toStdString();
-
-    writeBytes(&file, (const char*)&namelength, sizeof(int));
-    file << stdName;
-
-    writeBytes(&file, (const char*)&(_widget->inTrack->trackColors), 3*sizeof(QColor));
-
-    // ANCHOR
-    writeBytes(&file, (const char*)&startPos, sizeof(glm::vec3));
-    writeBytes(&file, (const char*)&anchorNode->fRoll, sizeof(float));
-    writeBytes(&file, (const char*)&startPitch, sizeof(float));
-    writeBytes(&file, (const char*)&startYaw, sizeof(float));
-
-    writeBytes(&file, (const char*)&anchorNode->fVel, sizeof(float));
-
-    writeBytes(&file, (const char*)&anchorNode->forceNormal, sizeof(float));
-    writeBytes(&file, (const char*)&anchorNode->forceLateral, sizeof(float));
-
-    writeBytes(&file, (const char*)&fHeart, sizeof(float));
-    writeBytes(&file, (const char*)&fFriction, sizeof(float));
-    writeBytes(&file, (const char*)&fResistance, sizeof(float));
-
-    writeBytes(&file, (const char*)&drawTrack, sizeof(bool));
-    writeBytes(&file, (const char*)&drawHeartline, sizeof(int));
-    writeBytes(&file, (const char*)&style, sizeof(int));
-    writeBytes(&file, (const char*)&mParent->mMesh->isWireframe, sizeof(bool));
-
-    writeBytes(&file, (const char*)&povPos.x, sizeof(float));
-    writeBytes(&file, (const char*)&povPos.y, sizeof(float));
+    saveHeader(file, _widget);
 
     //float fFriction;
     int size = lSections.size();
@@ -1010,128 +1213,159 @@ QString track::saveTrack(fstream& file, trackWidget* _widget)
         lSections.at(i)->saveSection(file);
     }
 
-    size = smoothList.size();
-    writeBytes(&file, (const char*)&size, sizeof(int));
-    for(int i = 0; i < size; ++i)
-    {
-        smoothList[i]->saveSmooth(file);
-    }
+    saveSmooths(file);
 
     file << "EOT";
 
     return QString("Save Successful");
 }
 
-QString track::loadTrack(fstream& file, trackWidget* _widget)
+void track::saveTrack(chunkWriter& writer, int trackIndex, trackWidget* _widget, bool withNodes)
 {
-    int namelength = readInt(&file);
-    name = QString(readString(&file, namelength).c_str());
+    writer.beginChunk("TRKH", trackIndex);
+    saveHeader(*writer.file, _widget);
+    writer.endChunk();
 
-    readBytes(&file, &_widget->inTrack->trackColors, 3*sizeof(QColor));
+    saveSections(writer, trackIndex);
 
-    startPos = readVec3(&file);
-    anchorNode->fRoll = readFloat(&file);
-    startPitch = readFloat(&file);
-    startYaw = readFloat(&file);
-    anchorNode->fVel = readFloat(&file);
-    anchorNode->forceNormal = readFloat(&file);
-    anchorNode->forceLateral = readFloat(&file);
+    writer.beginChunk("SMTH", trackIndex);
+    saveSmooths(*writer.file);
+    writer.endChunk();
 
-    fHeart = readFloat(&file);
-    fFriction = readFloat(&file);
-    fResistance = readFloat(&file);
+    if(withNodes && mOptions->projectNodeCache)
+    {
+        QByteArray nodes = materialized ? nodeCache::packTrack(this) : nodeChunk;
+        if(!nodes.isEmpty())
+        {
+            writer.beginChunk("NODC", trackIndex);
+            writer.file->write(nodes.constData(), nodes.size());
+            writer.endChunk();
+        }
+    }
+}
 
-    drawTrack = readBool(&file);
-    drawHeartline = readInt(&file);
-    style = (enum trackStyle)readInt(&file);
-    mParent->mMesh->isWireframe = readBool(&file);
+void track::saveSections(chunkWriter& writer, int trackIndex)
+{
+    for(int i = 0; i < lSections.size(); ++i)
+    {
+        writer.beginChunk("SECT", trackIndex, i);
+        lSections.at(i)->saveSection(*writer.file);
+        writer.endChunk();
+    }
+}
 
-    povPos.x = readFloat(&file);
-    povPos.y = readFloat(&file);
+// the chunks of saveTrack() without nodes for an autosave,
+// the sections are serialized again only if they changed since the last one
+chunkBlock_t track::backupChunks(int trackIndex, trackWidget* _widget)
+{
+    if(unsavedChanges || backupBlock.toc.isEmpty())
+    {
+        stringstream sections;
+        chunkWriter writer(&sections, false);
+        saveSections(writer, trackIndex);
+        backupBlock = makeBlock(sections, writer.toc);
+        unsavedChanges = false;
+    }
 
-    anchorNode->fEnergy = 0.5f*anchorNode->fVel*anchorNode->fVel + F_G*anchorNode->fPosHearty(0.9*fHeart);
+    stringstream stream;
+    chunkWriter writer(&stream, false);
+    writer.beginChunk("TRKH", trackIndex);
+    saveHeader(stream, _widget);
+    writer.endChunk();
 
-    anchorNode->changePitch(startPitch, false);
-    anchorNode->setRoll(anchorNode->fRoll);
+    writer.appendBlock(backupBlock, trackIndex);
 
-    _widget->updateAnchorGeometrics();
+    writer.beginChunk("SMTH", trackIndex);
+    saveSmooths(stream);
+    writer.endChunk();
 
-    anchorNode->updateNorm();
+    return makeBlock(stream, writer.toc);
+}
+
+QString track::loadTrack(fstream& file, trackWidget* _widget)
+{
+    loadHeader(file, _widget);
 
-    string temp;
-    //gloParent->treeInit(this);
     int size = readInt(&file);
     for(int i = 0; i < size; ++i)
     {
-        temp = readString(&file, 3);
-        if(temp == "STR")
-        {
-            _widget->addStraightSec();
-            //this->newSection(straight);
-            activeSection->loadSection(file);
-            activeSection->updateSection();
-            //gloParent->addStraightSec(activeSection);
-        }
-        else if(temp == "CUR")
+        if(!loadSection(file, _widget))
         {
-            _widget->addCurvedSec();
-            //this->newSection(curved);
-            activeSection->loadSection(file);
-            activeSection->updateSection();
-            //gloParent->addCurvedSec(activeSection);
-        }
-        else if(temp == "GEO")
-        {
-            _widget->addGeometricSec();
-            //this->newSection(geometric);
-            activeSection->loadSection(file);
-            activeSection->updateSection();
-            //gloParent->addGeometricSec(activeSection);
-        }
-        else if(temp == "FRC")
-        {
-            _widget->addForceSec();
-            //this->newSection(forced);
-            activeSection->loadSection(file);
-            activeSection->updateSection();
-            //gloParent->addForceSec(activeSection);
-        }
-        else if(temp == "BEZ")
-        {
-            _widget->addSection(bezier);
-            //this->newSection(forced);
-            activeSection->loadSection(file);
-            activeSection->updateSection();
-            //gloParent->addForceSec(activeSection);
-        }
-        else if(temp == "CSV")
-        {
-            _widget->addSection(nolimitscsv);
-            //this->newSection(forced);
-            activeSection->loadSection(file);
-            activeSection->updateSection();
-            //gloParent->addForceSec(activeSection);
+            return QString("Error while Loading: No Such Segment!");
         }
-        else
+    }
+
+    loadSmooths(file);
+
+    string temp = readString(&file, 3);
+    if(temp == "EOT")
+    {
+        finishLoad(_widget);
+        return QString("Load Successful");
+    }
+    else
+    {
+        return QString("Load not Successful");
+    }
+}
+
+QString track::loadTrack(fstream& file, const QList<chunk_t>& chunks, trackWidget* _widget)
+{
+    const chunk_t* header = findChunk(chunks, "TRKH");
+    if(header == NULL || !seekChunk(file, *header))
+    {
+        return QString("Error while Loading: No Track Header!");
+    }
+    loadHeader(file, _widget);
+
+    // chunks are in file order, unknown ones are skipped
+    for(int i = 0; i < chunks.size(); ++i)
+    {
+        if(chunks[i].tag != "SECT") continue;
+        if(!seekChunk(file, chunks[i]) || !loadSection(file, _widget))
         {
             return QString("Error while Loading: No Such Segment!");
         }
     }
 
-    size = readInt(&file);
-    for(int i = 0; i < size; ++i)
+    const chunk_t* smooths = findChunk(chunks, "SMTH");
+    if(smooths != NULL && seekChunk(file, *smooths))
     {
-        if(i >= smoothList.size()) smoothList.append(new smoothHandler(this, -2));
+        loadSmooths(file);
+    }
 
-        smoothList[i]->loadSmooth(file);
+    // computed nodes from the last save, used by materialize() if still valid
+    const chunk_t* nodes = findChunk(chunks, "NODC");
+    if(nodes != NULL && seekChunk(file, *nodes))
+    {
+        nodeChunk.resize(nodes->length);
+        file.read(nodeChunk.data(), nodes->length);
+        if(!file) nodeChunk.clear();
     }
 
-    temp = readString(&file, 3);
+    finishLoad(_widget);
+    return QString("Load Successful");
+}
+
+QString track::legacyLoadTrack(fstream& file, trackWidget* _widget)
+{
+    loadHeader(file, _widget);
+
+    int size = readInt(&file);
+    for(int i = 0; i < size; ++i)
+    {
+        if(!loadSection(file, _widget, true))
+        {
+            return QString("Error while Loading: No Such Segment!");
+        }
+    }
+
+    loadSmooths(file, true);
+
+    string temp = readString(&file, 3);
     if(temp == "EOT")
     {
-        updateTrack(0, 0);
-        _widget->clearSelection();
-        _widget->setNames();
+        finishLoad(_widget);
         return QString("Load Successful");
     }
     else
@@ -1140,8 +1374,44 @@ QString track::loadTrack(fstream& file, trackWidget* _widget)
     }
 }
 
-QString track::legacyLoadTrack(fstream& file, trackWidget* _widget)
+void track::saveHeader(ostream& file, trackWidget* _widget)
+{
+    int namelength = name.length();
+    std::string stdName = name.toStdString();
+
+    writeBytes(&file, (const char*)&namelength, sizeof(int));
+    file << stdName;
+
+    writeBytes(&file, (const char*)&(_widget->inTrack->trackColors), 3*sizeof(QColor));
+
+    // ANCHOR
+    writeBytes(&file, (const char*)&startPos, sizeof(glm::vec3));
+    writeBytes(&file, (const char*)&anchorNode->fRoll, sizeof(float));
+    writeBytes(&file, (const char*)&startPitch, sizeof(float));
+    writeBytes(&file, (const char*)&startYaw, sizeof(float));
+
+    writeBytes(&file, (const char*)&anchorNode->fVel, sizeof(float));
+
+    writeBytes(&file, (const char*)&anchorNode->forceNormal, sizeof(float));
+    writeBytes(&file, (const char*)&anchorNode->forceLateral, sizeof(float));
+
+    writeBytes(&file, (const char*)&fHeart, sizeof(float));
+    writeBytes(&file, (const char*)&fFriction, sizeof(float));
+    writeBytes(&file, (const char*)&fResistance, sizeof(float));
+
+    writeBytes(&file, (const char*)&drawTrack, sizeof(bool));
+    writeBytes(&file, (const char*)&drawHeartline, sizeof(int));
+    writeBytes(&file, (const char*)&style, sizeof(int));
+    writeBytes(&file, (const char*)&mParent->mMesh->isWireframe, sizeof(bool));
+
+    writeBytes(&file, (const char*)&povPos.x, sizeof(float));
+    writeBytes(&file, (const char*)&povPos.y, sizeof(float));
+}
+
+void track::loadHeader(fstream& file, trackWidget* _widget)
 {
+    materialized = false;
+
     int namelength = readInt(&file);
     name = QString(readString(&file, namelength).c_str());
 
@@ -1162,7 +1432,9 @@ QString track::legacyLoadTrack(fstream& file, trackWidget* _widget)
     drawTrack = readBool(&file);
     drawHeartline = readInt(&file);
     style = (enum trackStyle)readInt(&file);
-    mParent->mMesh->isWireframe = readBool(&file);
+    bool wireframe = readBool(&file);
+    if(mParent->mMesh != NULL)
+        mParent->mMesh->isWireframe = wireframe;
 
     povPos.x = readFloat(&file);
     povPos.y = readFloat(&file);
@@ -1175,87 +1447,145 @@ QString track::legacyLoadTrack(fstream& file, trackWidget* _widget)
     _widget->updateAnchorGeometrics();
 
     anchorNode->updateNorm();
+}
 
-    string temp;
-    //gloParent->treeInit(this);
-    int size = readInt(&file);
+bool track::loadSection(fstream& file, trackWidget* _widget, bool legacy)
+{
+    string temp = readString(&file, 3);
+    if(temp == "STR")
+    {
+        _widget->addStraightSec();
+    }
+    else if(temp == "CUR")
+    {
+        _widget->addCurvedSec();
+    }
+    else if(temp == "GEO")
+    {
+        _widget->addGeometricSec();
+    }
+    else if(temp == "FRC")
+    {
+        _widget->addForceSec();
+    }
+    else if(temp == "BEZ")
+    {
+        _widget->addSection(bezier);
+    }
+    else if(temp == "CSV")
+    {
+        _widget->addSection(nolimitscsv);
+    }
+    else
+    {
+        return false;
+    }
+
+    if(legacy) activeSection->legacyLoadSection(file);
+    else activeSection->loadSection(file);
+    return true;
+}
+
+void track::saveSmooths(ostream& file)
+{
+    int size = smoothList.size();
+    writeBytes(&file, (const char*)&size, sizeof(int));
     for(int i = 0; i < size; ++i)
     {
-        temp = readString(&file, 3);
-        if(temp == "STR")
-        {
-            _widget->addStraightSec();
-            //this->newSection(straight);
-            activeSection->legacyLoadSection(file);
-            activeSection->updateSection();
-            //gloParent->addStraightSec(activeSection);
-        }
-        else if(temp == "CUR")
-        {
-            _widget->addCurvedSec();
-            //this->newSection(curved);
-            activeSection->legacyLoadSection(file);
-            activeSection->updateSection();
-            //gloParent->addCurvedSec(activeSection);
-        }
-        else if(temp == "GEO")
-        {
-            _widget->addGeometricSec();
-            //this->newSection(geometric);
-            activeSection->legacyLoadSection(file);
-            activeSection->updateSection();
-            //gloParent->addGeometricSec(activeSection);
-        }
-        else if(temp == "FRC")
-        {
-            _widget->addForceSec();
-            //this->newSection(forced);
-            activeSection->legacyLoadSection(file);
-            activeSection->updateSection();
-            //gloParent->addForceSec(activeSection);
-        }
-        else if(temp == "BEZ")
-        {
-            _widget->addSection(bezier);
-            //this->newSection(forced);
-            activeSection->legacyLoadSection(file);
-            activeSection->updateSection();
-            //gloParent->addForceSec(activeSection);
-        }
-        else if(temp == "CSV")
-        {
-            _widget->addSection(nolimitscsv);
-            //this->newSection(forced);
-            activeSection->legacyLoadSection(file);
-            activeSection->updateSection();
-            //gloParent->addForceSec(activeSection);
-        }
-        else
-        {
-            return QString("Error while Loading: No Such Segment!");
-        }
+        smoothList[i]->saveSmooth(file);
     }
+}
 
-    size = readInt(&file);
+void track::loadSmooths(fstream& file, bool legacy)
+{
+    int size = readInt(&file);
     for(int i = 0; i < size; ++i)
     {
         if(i >= smoothList.size()) smoothList.append(new smoothHandler(this, -2));
 
-        smoothList[i]->legacyLoadSmooth(file);
+        if(legacy) smoothList[i]->legacyLoadSmooth(file);
+        else smoothList[i]->loadSmooth(file);
     }
+}
 
-    temp = readString(&file, 3);
-    if(temp == "EOT")
+void track::finishLoad(trackWidget* _widget)
+{
+    _widget->clearSelection();
+    _widget->setNames();
+}
+
+void track::materialize()
+{
+    if(materialized) return;
+    integrate();
+    publish();
+}
+
+// computes the nodes of a loaded track without touching the ui, the renderer
+// or the shared node cache, so several tracks can be integrated at once
+void track::integrate()
+{
+    if(!nodeChunk.isEmpty() && nodeCache::unpackTrack(this, nodeChunk))
     {
-        updateTrack(0, 0);
-        _widget->clearSelection();
-        _widget->setNames();
-        return QString("Load Successful");
+        nodeChunk.clear();
+        return;
     }
-    else
+    nodeChunk.clear();
+
+    for(int i = 0; i < lSections.size(); ++i)
     {
-        return QString("Load not Successful");
+        if(i) lSections.at(i)->lNodes.prepend(lSections.at(i-1)->lNodes[lSections.at(i-1)->lNodes.size()-1]);
+        lSections.at(i)->updateSection(0);
+    }
+}
+
+// hands integrated nodes over to the mesh and smoothing, gui thread only
+void track::publish()
+{
+    materialized = true;
+
+    if(mParent->mMesh != NULL)
+        mParent->mMesh->buildMeshes(0);
+    hasChanged = true;
+
+    if(smoother)
+    {
+        smoother->updateUi();
+        smoother->applyRollSmooth();
+    }
+}
+
+// detached copy of the computed track for background exports, the section parameters are
+// cloned and the nodes are shared copy-on-write, so editing the original stays safe
+track* track::snapshot()
+{
+    materialize();
+
+    track* copy = new track(mParent, startPos, startYaw, fHeart);
+    *copy->anchorNode = *anchorNode;
+    copy->startPitch = startPitch;
+    copy->fFriction = fFriction;
+    copy->fResistance = fResistance;
+    copy->name = name;
+    copy->style = style;
+    copy->smoother = NULL;
+
+    for(int i = 0; i < lSections.size(); ++i)
+    {
+        std::stringstream params;
+        lSections[i]->saveSection(params);
+        params.seekg(3);
+
+        // the nodes are taken over below, so the clone is never integrated
+        section* cur = copy->createSection(lSections[i]->type, copy->anchorNode);
+        copy->lSections.append(cur);
+        copy->smoothList.insert(copy->lSections.size(), new smoothHandler(copy, copy->lSections.size()-1));
+        cur->loadSection(params);
+        cur->lNodes = lSections[i]->lNodes;
+        cur->length = lSections[i]->length;
     }
+    copy->hasChanged = false;
+    return copy;
 }
 
 mnode* track::getPoint(int index)
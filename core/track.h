@@ -30,6 +30,9 @@
 #include <QList>
 #include <fstream>
 #include <QString>
+#include <QByteArray>
+#include "projectfile.h"
+#include "exportfuncs.h"
 
 class optionsMenu;
 class sectionHandler;
@@ -64,17 +67,34 @@ public:
     void updateTrack(int index, int iNode);
     void updateTrack(section* fromSection, int iNode);
     void newSection(enum secType type, int index = -1);
+    section* createSection(enum secType type, mnode* startNode);
 
+    void selectExportPoints(QList<int>& points, QVector<mnode*>& nodes, float mPerNode, int fromIndex, int toIndex, bool keepStraights);
     int exportTrack(std::fstream* file, float mPerNode, int fromIndex, int toIndex, float fRollThresh);
     int exportTrack2(std::fstream* file, float mPerNode, int fromIndex, int toIndex, float fRollThresh);
-    int exportTrack3(std::fstream* file, float mPerNode, int fromIndex, int toIndex, float fRollThresh);
-    int exportTrack4(std::fstream* file, float mPerNode, int fromIndex, int toIndex, float fRollThresh);
+    int exportTrack3(std::fstream* file, float mPerNode, int fromIndex, int toIndex, float fRollThresh, exportprogress_t* progress = NULL);
+    int exportTrack4(std::fstream* file, float mPerNode, int fromIndex, int toIndex, float fRollThresh, exportprogress_t* progress = NULL);
+    int exportTrackAdaptive(std::fstream* file, float tolerance, float rollTolerance, int fromIndex, int toIndex, float fRollThresh, exportprogress_t* progress = NULL);
 
-    void exportNL2Track(FILE *file, float mPerNode, int fromIndex, int toIndex);
+    void exportNL2Track(FILE *file, float mPerNode, int fromIndex, int toIndex, exportprogress_t* progress = NULL);
 
     QString saveTrack(std::fstream& file, trackWidget* _widget);
+    void saveTrack(chunkWriter& writer, int trackIndex, trackWidget* _widget, bool withNodes = true);
+    void saveSections(chunkWriter& writer, int trackIndex);
+    chunkBlock_t backupChunks(int trackIndex, trackWidget* _widget);
     QString loadTrack(std::fstream& file, trackWidget* _widget);
+    QString loadTrack(std::fstream& file, const QList<chunk_t>& chunks, trackWidget* _widget);
     QString legacyLoadTrack(std::fstream& file, trackWidget* _widget);
+    void saveHeader(std::ostream& file, trackWidget* _widget);
+    void loadHeader(std::fstream& file, trackWidget* _widget);
+    bool loadSection(std::fstream& file, trackWidget* _widget, bool legacy = false);
+    void saveSmooths(std::ostream& file);
+    void loadSmooths(std::fstream& file, bool legacy = false);
+    void finishLoad(trackWidget* _widget);
+    void materialize();
+    void integrate();
+    void publish();
+    track* snapshot();
     mnode* getPoint(int index);
     int getIndexFromDist(float dist);
     int getNumPoints(section* until = NULL);
@@ -83,6 +103,10 @@ public:
     void getSecNode(int index, int *node, int *section);
 
     bool hasChanged;
+    bool unsavedChanges;    // sections edited since the last autosave, hasChanged is reset by every frame
+    chunkBlock_t backupBlock;   // section chunks of the last autosave
+    bool materialized;  // false while loaded parameters have not been integrated yet
+    QByteArray nodeChunk;   // persisted nodes read from the project file
     bool drawTrack;
     int drawHeartline;
 
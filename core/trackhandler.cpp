@@ -52,10 +52,12 @@ trackHandler::trackHandler(QString _name, int _id)
     trackColors[0] = QColor(20, 20, 130);
     trackColors[1] = QColor(255, 51, 51);
     trackColors[2] = QColor(51, 255, 51);
+    supportColor = QColor(153, 153, 153);
 
 
     mUndoHandler = new undoHandler(gloParent->mOptions->maxUndoChanges);
-    mMesh = new trackMesh(trackData);
+    // without a view there is nothing to draw, tracks then carry no mesh
+    mMesh = glView->hasContext() ? new trackMesh(trackData) : NULL;
 }
 
 trackHandler::~trackHandler()
@@ -45,6 +45,7 @@ public:
     trackMesh* mMesh;
     undoHandler* mUndoHandler;
     QColor trackColors[3];
+    QColor supportColor;
 
 private:
 
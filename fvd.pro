@@ -27,7 +27,7 @@
 # lib3ds
 
 CONFIG	+= qt
-QT       += core gui widgets printsupport opengl
+QT       += core gui widgets printsupport opengl concurrent
 
 #CONFIG += exceptions \
 #          rtti
@@ -52,6 +52,8 @@ SOURCES += main.cpp\
     core/saver.cpp \
     core/nolimitsimporter.cpp \
     core/mnode.cpp \
+    core/nodecache.cpp \
+    core/projectfile.cpp \
     core/function.cpp \
     core/exportfuncs.cpp \
     osx/common.cpp \
@@ -77,6 +79,10 @@ SOURCES += main.cpp\
     ui/exportui.cpp \
     ui/draglabel.cpp \
     ui/conversionpanel.cpp \
+    ui/trackloader.cpp \
+    ui/exportqueue.cpp \
+    core/nodeexport.cpp \
+    renderer/meshexporter.cpp \
     core/secnlcsv.cpp
 
 HEADERS  += core/undohandler.h \
@@ -95,6 +101,9 @@ HEADERS  += core/undohandler.h \
     core/saver.h \
     core/nolimitsimporter.h \
     core/mnode.h \
+    core/nodecache.h \
+    core/projectfile.h \
+    core/parallel.h \
     core/function.h \
     core/exportfuncs.h \
     osx/common.h \
@@ -120,6 +129,10 @@ HEADERS  += core/undohandler.h \
     ui/exportui.h \
     ui/draglabel.h \
     ui/conversionpanel.h \
+    ui/trackloader.h \
+    ui/exportqueue.h \
+    core/nodeexport.h \
+    renderer/meshexporter.h \
     lenassert.h \
     core/secnlcsv.h
 
@@ -226,6 +239,8 @@ OTHER_FILES += \
     shaders/floor.frag \
     shaders/debug.vert \
     shaders/debug.frag \
+    shaders/pipe.vert \
+    shaders/pipe.frag \
     metalnormals.png \
     readme.txt \
     sky/negx.jpg \
@@ -85,6 +85,20 @@ int main(int argc, char *argv[])
 #endif
 
     MainWindow w;
+
+    // FVD++ --export-nodes <project.fvd> <output> [--csv] [--track <number>]
+    // the window is never shown, see MainWindow::exportNodes for the exit codes
+    if(argc >= 4 && QString(argv[1]) == "--export-nodes") {
+        bool csv = false;
+        int trackIndex = 0;
+        for(int i = 4; i < argc; ++i) {
+            if(QString(argv[i]) == "--csv") csv = true;
+            else if(QString(argv[i]) == "--track" && i+1 < argc) trackIndex = QString(argv[++i]).toInt()-1;
+        }
+        // leave without unwinding, ~MainWindow always exits with 0
+        exit(w.exportNodes(argv[2], argv[3], trackIndex, csv));
+    }
+
     w.show();
     if(argc == 2) {
         QString fileName(argv[1]);
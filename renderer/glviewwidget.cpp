@@ -77,6 +77,7 @@ glViewWidget::~glViewWidget()
 		delete skyShader;
 		delete floorShader;
 		delete trackShader;
+		delete pipeShader;
 		delete simpleSMShader;
 		delete shadowVolumeShader;
 
@@ -189,6 +190,7 @@ void glViewWidget::drawTrack(trackHandler *_track, bool toNormalMap)
 	shader->useUniform("defaultColor", tempColor[0].red()/255.f, tempColor[0].green()/255.f, tempColor[0].blue()/255.f);
 	shader->useUniform("sectionColor", tempColor[1].red()/255.f, tempColor[1].green()/255.f, tempColor[1].blue()/255.f);
 	shader->useUniform("transitionColor", tempColor[2].red()/255.f, tempColor[2].green()/255.f, tempColor[2].blue()/255.f);
+	shader->useUniform("selectionRange", &mesh->selectionRange);
 
 	shader->useUniform("lightDir", &lightDir);
 
@@ -228,7 +230,7 @@ void glViewWidget::drawTrack(trackHandler *_track, bool toNormalMap)
 		}
 		else
 		{
-			shader->useUniform("defaultColor", 0.6f, 0.6f, 0.6f);
+			shader->useUniform("defaultColor", _track->supportColor.red()/255.f, _track->supportColor.green()/255.f, _track->supportColor.blue()/255.f);
 			for(int i = 0; i < mesh->supportsSize; ++i)
 			{
 				glDrawArrays(GL_TRIANGLE_STRIP, i*61, 61);
@@ -240,6 +242,8 @@ void glViewWidget::drawTrack(trackHandler *_track, bool toNormalMap)
 	shader->useUniform("defaultColor", 0.9f, 0.9f, 0.4f);
 	if(myTrack->drawHeartline != 1)
 	{
+		// the heartline has no node attribute, keep it out of the selection range
+		glVertexAttrib1f(6, -1.f);
 		glBindVertexArray(mesh->HeartObject[0]);
 		glDrawArrays(GL_LINE_STRIP, 0, mesh->heartline.size());
 	}
@@ -700,6 +704,12 @@ QString glViewWidget::getGLVersionString()
 	return QString((const char*)glGetString(GL_VERSION));
 }
 
+// false until the view was shown once, the headless export never gets a context
+bool glViewWidget::hasContext()
+{
+	return initialized != 0;
+}
+
 bool glViewWidget::loadGroundTexture(QString fileName)
 {
 	QImage img(fileName);
@@ -843,6 +853,8 @@ void glViewWidget::initializeGL()
 	if(!legacyMode)
 	{
 		glEnable(GL_DEPTH_TEST);
+		glEnable(GL_PRIMITIVE_RESTART);
+		glPrimitiveRestartIndex((GLuint)RESTART_INDEX);
 
 		initFloorMesh();
 		initShaders();
@@ -1219,11 +1231,24 @@ void glViewWidget::initShaders()
 	trackShader->useAttribute(3, "aNForce");
 	trackShader->useAttribute(4, "aLForce");
 	trackShader->useAttribute(5, "aFlex");
-	trackShader->useAttribute(6, "aselected");
+	trackShader->useAttribute(6, "aNode");
 	trackShader->useAttribute(7, "aNormal");
 	trackShader->useAttribute(8, "aUv");
 	trackShader->linkProgram();
 
+#ifdef Q_OS_LINUX
+	pipeShader = new myShader(":/shaders/pipe.vert", ":/shaders/pipe.frag");
+#endif
+#ifdef Q_OS_WIN32
+	pipeShader = new myShader(":/shaders/pipe.vert", ":/shaders/pipe.frag");
+#endif
+#ifdef Q_OS_MAC
+	pipeShader = new myShader(":/shaders/pipe.vert", ":/shaders/pipe.frag");
+#endif
+	const GLchar* pipeOutputs[7] = {"tPosition", "tUv", "tNode", "tNormal", "tVelRoll", "tForces", "tFlexion"};
+	pipeShader->captureOutputs(7, pipeOutputs);
+	pipeShader->linkProgram();
+
 	simpleShadowFb = new myFramebuffer(viewPortWidth, viewPortHeight, GL_RED, GL_RED);
 
 #ifdef Q_OS_LINUX
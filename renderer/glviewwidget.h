@@ -68,6 +68,7 @@ public:
     void paintGL();
     QString getGLVersionString();
     bool loadGroundTexture(QString fileName);
+    bool hasContext();
 
     void setBackgroundColor(QColor _background);
 
@@ -84,6 +85,9 @@ public:
     bool hasChanged;
     glm::vec3 cameraPos;
 
+    // extrudes the rail rings of the track meshes, see trackMesh::extrudePipes
+    myShader* pipeShader;
+
 protected:
     void initializeGL();
     void resizeGL(int w, int h);
@@ -0,0 +1,323 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "meshexporter.h"
+#include "trackmesh.h"
+#include <QHash>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QtEndian>
+#include <cstring>
+
+struct vertexKey {
+    glm::vec3 pos;
+    glm::vec3 normal;
+    bool operator==(const vertexKey& other) const { return !memcmp(this, &other, sizeof(vertexKey)); }
+};
+
+inline uint qHash(const vertexKey& key, uint seed = 0)
+{
+    return qHashBits(&key, sizeof(vertexKey), seed);
+}
+
+// merges equal vertices of all parts into one shared vertex list
+struct meshWelder {
+    meshExporter* out;
+    QHash<vertexKey, quint32> lookup;
+
+    quint32 index(const tracknode_t& vertex) {
+        vertexKey key;
+        key.pos = vertex.pos;
+        key.normal = unpackNormal(vertex.normal);
+        QHash<vertexKey, quint32>::const_iterator it = lookup.constFind(key);
+        if(it != lookup.constEnd()) return it.value();
+
+        quint32 result = out->positions.size();
+        out->positions.append(key.pos);
+        out->normals.append(key.normal);
+        lookup.insert(key, result);
+        return result;
+    }
+
+    void triangle(QVector<quint32>& list, quint32 a, quint32 b, quint32 c) {
+        if(a == b || b == c || a == c) return;
+        list.append(a);
+        list.append(b);
+        list.append(c);
+    }
+
+    // unrolls a triangle strip, degenerate triangles that join strips are dropped
+    void strip(QVector<quint32>& list, const QVector<tracknode_t>& vertices, const int* order, int count, int first) {
+        for(int k = 0; k+2 < count; ++k) {
+            quint32 a = index(vertices[order ? order[k] : first+k]);
+            quint32 b = index(vertices[order ? order[k+1] : first+k+1]);
+            quint32 c = index(vertices[order ? order[k+2] : first+k+2]);
+            if(k%2) triangle(list, b, a, c);
+            else triangle(list, a, b, c);
+        }
+    }
+};
+
+meshExporter::meshExporter(trackMesh* _mesh)
+{
+    // wireframe meshes only hold the rail lines, their pipe indices are line strips
+    if(_mesh->isWireframe) {
+        error = QString("Error: Wireframe tracks cannot be exported, switch off wireframe in the track properties");
+        return;
+    }
+
+    meshWelder welder;
+    welder.out = this;
+
+    // solid rails only live on the gpu when the pipe shader extrudes them
+    QVector<tracknode_t> rails = _mesh->rails;
+    if(_mesh->gpuPipes) _mesh->extrudeRails(rails);
+    welder.lookup.reserve(rails.size() + _mesh->crossties.size() + _mesh->rendersupports.size());
+
+    // the rail strips are separated by restart indices
+    const int* order = _mesh->pipeIndices.constData();
+    for(int i = 0; i < _mesh->pipeBorders.size()-1; ++i) {
+        int from = _mesh->pipeBorders[i];
+        for(int k = from; k <= _mesh->pipeBorders[i+1]; ++k) {
+            if(k == _mesh->pipeBorders[i+1] || order[k] == RESTART_INDEX) {
+                welder.strip(indices[partRails], rails, order+from, k-from, 0);
+                from = k+1;
+            }
+        }
+    }
+
+    for(int i = 0; i+2 < _mesh->crossties.size(); i += 3) {
+        welder.triangle(indices[partCrossties], welder.index(_mesh->crossties[i]), welder.index(_mesh->crossties[i+1]), welder.index(_mesh->crossties[i+2]));
+    }
+
+    int numSupports = qMin(_mesh->supportsSize, _mesh->rendersupports.size()/61);
+    for(int i = 0; i < numSupports; ++i) {
+        welder.strip(indices[partSupports], _mesh->rendersupports, NULL, 61, i*61);
+    }
+}
+
+// writes 32 bit values in file order, hosts that are little-endian already write the array as is
+static bool writeWords(QFile& file, const void* data, qint64 count)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    return file.write((const char*)data, count*4) == count*4;
+#else
+    QByteArray buffer(count*4, Qt::Uninitialized);
+    const quint32* words = (const quint32*)data;
+    for(qint64 i = 0; i < count; ++i) qToLittleEndian(words[i], (uchar*)buffer.data()+4*i);
+    return file.write(buffer) == buffer.size();
+#endif
+}
+
+static QJsonArray jsonColor(const QColor& color)
+{
+    QJsonArray result;
+    result.append(color.redF());
+    result.append(color.greenF());
+    result.append(color.blueF());
+    result.append(1.0);
+    return result;
+}
+
+// glTF shares the y-up, right-handed meter system of the renderer, so no axes are swapped
+QString meshExporter::saveGlb(QString fileName, QColor trackColor, QColor supportColor)
+{
+    if(!error.isEmpty()) return error;
+    if(positions.isEmpty()) return QString("Error: The track has no mesh to export");
+
+    glm::vec3 minPos = positions[0], maxPos = positions[0];
+    for(int i = 1; i < positions.size(); ++i) {
+        minPos = glm::min(minPos, positions[i]);
+        maxPos = glm::max(maxPos, positions[i]);
+    }
+
+    QJsonArray bufferViews, accessors, primitives, materials;
+    qint64 offset = 0;
+    qint64 vertexBytes = positions.size()*12;
+
+    for(int attribute = 0; attribute < 2; ++attribute) {
+        QJsonObject view;
+        view["buffer"] = 0;
+        view["byteOffset"] = offset;
+        view["byteLength"] = vertexBytes;
+        view["target"] = 34962;
+        bufferViews.append(view);
+        offset += vertexBytes;
+
+        QJsonObject accessor;
+        accessor["bufferView"] = attribute;
+        accessor["componentType"] = 5126;
+        accessor["count"] = positions.size();
+        accessor["type"] = QString("VEC3");
+        if(attribute == 0) {
+            QJsonArray min, max;
+            min.append(minPos.x); min.append(minPos.y); min.append(minPos.z);
+            max.append(maxPos.x); max.append(maxPos.y); max.append(maxPos.z);
+            accessor["min"] = min;
+            accessor["max"] = max;
+        }
+        accessors.append(accessor);
+    }
+
+    const char* partNames[numMeshParts] = {"rails", "crossties", "supports"};
+    for(int part = 0; part < numMeshParts; ++part) {
+        QJsonObject material;
+        QJsonObject pbr;
+        pbr["baseColorFactor"] = jsonColor(part == partSupports ? supportColor : trackColor);
+        pbr["metallicFactor"] = part == partSupports ? 0.0 : 0.5;
+        pbr["roughnessFactor"] = 0.6;
+        material["name"] = QString(partNames[part]);
+        material["pbrMetallicRoughness"] = pbr;
+        materials.append(material);
+
+        if(indices[part].isEmpty()) continue;
+
+        QJsonObject view;
+        view["buffer"] = 0;
+        view["byteOffset"] = offset;
+        view["byteLength"] = (qint64)indices[part].size()*4;
+        view["target"] = 34963;
+        bufferViews.append(view);
+        offset += indices[part].size()*4;
+
+        QJsonObject accessor;
+        accessor["bufferView"] = bufferViews.size()-1;
+        accessor["componentType"] = 5125;
+        accessor["count"] = indices[part].size();
+        accessor["type"] = QString("SCALAR");
+        accessors.append(accessor);
+
+        QJsonObject attributes;
+        attributes["POSITION"] = 0;
+        attributes["NORMAL"] = 1;
+        QJsonObject primitive;
+        primitive["attributes"] = attributes;
+        primitive["indices"] = accessors.size()-1;
+        primitive["material"] = part;
+        primitives.append(primitive);
+    }
+
+    QJsonObject asset, mesh, node, scene, buffer, root;
+    asset["version"] = QString("2.0");
+    asset["generator"] = QString("FVD++");
+    mesh["name"] = QString("track");
+    mesh["primitives"] = primitives;
+    node["mesh"] = 0;
+    QJsonArray sceneNodes;
+    sceneNodes.append(0);
+    scene["nodes"] = sceneNodes;
+    buffer["byteLength"] = offset;
+
+    root["asset"] = asset;
+    root["scene"] = 0;
+    root["scenes"] = QJsonArray() << scene;
+    root["nodes"] = QJsonArray() << node;
+    root["meshes"] = QJsonArray() << mesh;
+    root["materials"] = materials;
+    root["buffers"] = QJsonArray() << buffer;
+    root["bufferViews"] = bufferViews;
+    root["accessors"] = accessors;
+
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    while(json.size()%4) json.append(' ');
+
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly)) return QString("Error: Could not write to ").append(fileName);
+
+    quint32 header[5];
+    memcpy(header, "glTF", 4);
+    header[1] = qToLittleEndian<quint32>(2);
+    header[2] = qToLittleEndian<quint32>(12 + 8 + json.size() + 8 + offset);
+    header[3] = qToLittleEndian<quint32>(json.size());
+    memcpy(header+4, "JSON", 4);
+    file.write((const char*)header, sizeof(header));
+    file.write(json);
+
+    quint32 binHeader[2];
+    binHeader[0] = qToLittleEndian<quint32>(offset);
+    memcpy(binHeader+1, "BIN\0", 4);
+    file.write((const char*)binHeader, sizeof(binHeader));
+
+    bool success = writeWords(file, positions.constData(), positions.size()*3);
+    success = success && writeWords(file, normals.constData(), normals.size()*3);
+    for(int part = 0; part < numMeshParts; ++part) {
+        success = success && writeWords(file, indices[part].constData(), indices[part].size());
+    }
+    file.close();
+
+    if(!success) return QString("Error: Could not write to ").append(fileName);
+    return QString("Export to ").append(fileName).append(" successful!");
+}
+
+QString meshExporter::savePly(QString fileName)
+{
+    if(!error.isEmpty()) return error;
+    if(positions.isEmpty()) return QString("Error: The track has no mesh to export");
+
+    int numFaces = 0;
+    for(int part = 0; part < numMeshParts; ++part) numFaces += indices[part].size()/3;
+
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly)) return QString("Error: Could not write to ").append(fileName);
+
+    QByteArray header("ply\nformat binary_little_endian 1.0\ncomment FVD++ track mesh\n");
+    header.append("element vertex ").append(QByteArray::number(positions.size())).append('\n');
+    header.append("property float x\nproperty float y\nproperty float z\n");
+    header.append("property float nx\nproperty float ny\nproperty float nz\n");
+    header.append("element face ").append(QByteArray::number(numFaces)).append('\n');
+    header.append("property list uchar uint vertex_indices\nend_header\n");
+    file.write(header);
+
+    // vertices are interleaved per element, so both arrays go through one buffer in large blocks
+    bool success = true;
+    const int block = 8192;
+    QVector<glm::vec3> vertices;
+    for(int from = 0; success && from < positions.size(); from += block) {
+        int to = qMin(from + block, positions.size());
+        vertices.resize(2*(to-from));
+        for(int i = from; i < to; ++i) {
+            vertices[2*(i-from)] = positions[i];
+            vertices[2*(i-from)+1] = normals[i];
+        }
+        success = writeWords(file, vertices.constData(), vertices.size()*3);
+    }
+
+    QByteArray faces;
+    for(int part = 0; success && part < numMeshParts; ++part) {
+        const QVector<quint32>& list = indices[part];
+        for(int from = 0; success && from < list.size(); from += 3*block) {
+            int to = qMin(from + 3*block, list.size());
+            faces.resize((to-from)/3*13);
+            uchar* out = (uchar*)faces.data();
+            for(int i = from; i < to; i += 3) {
+                *out++ = 3;
+                qToLittleEndian(list[i], out);
+                qToLittleEndian(list[i+1], out+4);
+                qToLittleEndian(list[i+2], out+8);
+                out += 12;
+            }
+            success = file.write(faces) == faces.size();
+        }
+    }
+    file.close();
+
+    if(!success) return QString("Error: Could not write to ").append(fileName);
+    return QString("Export to ").append(fileName).append(" successful!");
+}
@@ -0,0 +1,50 @@
+#ifndef MESHEXPORTER_H
+#define MESHEXPORTER_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QVector>
+#include <QString>
+#include <QColor>
+#include "glm/glm.hpp"
+
+class trackMesh;
+
+enum meshPart {
+    partRails = 0,
+    partCrossties,
+    partSupports,
+    numMeshParts
+};
+
+// indexed triangles of the rendered track geometry, vertices shared by position and normal are merged
+class meshExporter
+{
+public:
+    meshExporter(trackMesh* _mesh);
+    QString saveGlb(QString fileName, QColor trackColor, QColor supportColor);
+    QString savePly(QString fileName);
+
+    QVector<glm::vec3> positions;
+    QVector<glm::vec3> normals;
+    QVector<quint32> indices[numMeshParts];
+    QString error;
+};
+
+#endif // MESHEXPORTER_H
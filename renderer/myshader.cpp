@@ -71,6 +71,12 @@ void myShader::setOutput(GLuint _index, const GLchar* _name)
     glBindFragDataLocation(program, _index, _name);
 }
 
+// the outputs are written interleaved into one transform feedback buffer, call before linkProgram
+void myShader::captureOutputs(GLsizei _count, const GLchar** _names)
+{
+    glTransformFeedbackVaryings(program, _count, _names, GL_INTERLEAVED_ATTRIBS);
+}
+
 void myShader::useUniform(const GLchar* _name, glm::mat4* _mat4)
 {
     glUniformMatrix4fv(glGetUniformLocation(program, _name), 1, GL_FALSE, glm::value_ptr(*_mat4));
@@ -101,6 +107,16 @@ void myShader::useUniform(const GLchar* _name, float _float)
     glUniform1f(glGetUniformLocation(program, _name), _float);
 }
 
+void myShader::useUniform(const GLchar* _name, GLsizei _count, const GLint* _ints)
+{
+    glUniform1iv(glGetUniformLocation(program, _name), _count, _ints);
+}
+
+void myShader::useUniform(const GLchar* _name, GLsizei _count, const glm::vec4* _vec4)
+{
+    glUniform4fv(glGetUniformLocation(program, _name), _count, glm::value_ptr(*_vec4));
+}
+
 void myShader::linkProgram()
 {
     glAttachShader(program, sources[0]);
@@ -28,6 +28,7 @@ public:
     ~myShader();
     void useAttribute(GLuint _index, const GLchar* _name);
     void setOutput(GLuint _index, const GLchar* _name);
+    void captureOutputs(GLsizei _count, const GLchar** _names);
 
     void useUniform(const GLchar* _name, glm::mat4* _mat4);
     void useUniform(const GLchar* _name, glm::vec4* _vec4);
@@ -35,6 +36,8 @@ public:
     void useUniform(const GLchar* _name, float f1, float f2, float f3);
     void useUniform(const GLchar* _name, GLuint _int);
     void useUniform(const GLchar* _name, float _float);
+    void useUniform(const GLchar* _name, GLsizei _count, const GLint* _ints);
+    void useUniform(const GLchar* _name, GLsizei _count, const glm::vec4* _vec4);
 
     void linkProgram();
     void bind();
@@ -160,6 +160,19 @@ myTexture::myTexture(int _width, int _height, GLuint _format, GLuint _intFormat)
     iType = 1;
 }
 
+// buffer texture, reads the contents of an existing buffer object
+myTexture::myTexture(GLuint _buffer, GLuint _format)
+{
+    mId = getFreeID();
+    myTexture::usedIDs[mId] = true;
+    glActiveTexture(GL_TEXTURE0 + mId);
+    glGenTextures(1, &handle);
+    glBindTexture(GL_TEXTURE_BUFFER, handle);
+    glTexBuffer(GL_TEXTURE_BUFFER, _format, _buffer);
+
+    iType = 3;
+}
+
 myTexture::~myTexture()
 {
     myTexture::usedIDs[mId] = false;
@@ -20,6 +20,10 @@
 #include "mainwindow.h"
 #include "optionsmenu.h"
 #include "mnode.h"
+#include "myshader.h"
+#include "mytexture.h"
+#include "parallel.h"
+#include <cstddef>
 
 extern MainWindow* gloParent;
 extern glViewWidget* glView;
@@ -38,6 +42,8 @@ trackMesh::trackMesh(track* parent)
         glGenBuffers(5, HeartIndices);
         glGenVertexArrays(1, ShadowObject);
         glGenBuffers(1, ShadowBuffer);
+        glGenVertexArrays(1, PipeObject);
+        glGenBuffers(1, PipeBuffer);
     }
 
     trackVertexSize = 0;
@@ -45,8 +51,18 @@ trackMesh::trackMesh(track* parent)
     supportsSize = 0;
     heartlineSize = 0;
     railShadowSize = 0;
+    selectionRange = glm::vec4(-1.f, -2.f, -1.f, -2.f);
     trackData = parent;
 	isWireframe = false;
+    gpuPipes = !glView->legacyMode;
+    frameTexture = NULL;
+
+    for(int i = 0; i < numMeshBuffers; ++i)
+    {
+        bufferCapacity[i] = 0;
+        bufferClean[i] = 0;
+    }
+    uploadedBytes = 0;
 }
 
 void trackMesh::init() {
@@ -60,8 +76,20 @@ void trackMesh::init() {
         glGenBuffers(5, HeartIndices);
         glGenVertexArrays(1, ShadowObject);
         glGenBuffers(1, ShadowBuffer);
+        glGenVertexArrays(1, PipeObject);
+        glGenBuffers(1, PipeBuffer);
+    }
+
+    for(int i = 0; i < numMeshBuffers; ++i)
+    {
+        bufferCapacity[i] = 0;
+        bufferClean[i] = 0;
     }
 
+    // the frame texture reads the pipe buffer generated above
+    delete frameTexture;
+    frameTexture = NULL;
+
     isInit = true;
     buildMeshes(0);
 }
@@ -76,7 +104,10 @@ trackMesh::~trackMesh()
         glDeleteBuffers(5, HeartBuffer);
         glDeleteBuffers(5, TrackIndices);
         glDeleteBuffers(5, HeartIndices);
+        glDeleteVertexArrays(1, PipeObject);
+        glDeleteBuffers(1, PipeBuffer);
     }
+    delete frameTexture;
 }
 
 /*enum trackStyle {
@@ -89,81 +120,104 @@ trackMesh::~trackMesh()
     small           // 0,5m
 };*/
 
-#define APPEND_TRACK_NODE(name) {name.append(nextPos.x); name.append(nextPos.y); name.append(nextPos.z); name.append(nextNorm.x); name.append(nextNorm.y); name.append(nextNorm.z); name.append(curNode->fVel); name.append(fabs(curNode->fRollSpeed+curNode->fSmoothSpeed)); name.append(curNode->forceNormal+curNode->smoothNormal); name.append(fabs(curNode->forceLateral + curNode->smoothLateral)); name.append(fabs(curNode->fFlexion())); if(trackData == gloParent->curTrack() && curSection == trackData->activeSection) { if(curSection->isInFunction(j, gloParent->selectedFunc)) { name.append(2.0f); } else { name.append(1.0f); } } else { name.append(0.0f); } }
-#define APPEND_NODE(name) {name.append(nextPos.x); name.append(nextPos.y); name.append(nextPos.z);}
 
-void trackMesh::appendTrackNode(QVector<tracknode_t> &list, float _u, float _v)
+// float to half float, rounded to nearest, clamped to the largest half and flushed to zero below the normal range
+static quint16 toHalf(float value)
 {
-    tracknode_t temp;
-    temp.node = nextNode;
-    temp.pos = nextPos;
-    temp.normal = nextNorm;
-    temp.uv = glm::vec2(_u, _v);
-    temp.vel = curNode->fVel;
-    temp.rollSpeed = fabs(curNode->fRollSpeed+curNode->fSmoothSpeed);
-    temp.yForce = curNode->forceNormal+curNode->smoothNormal;
-    temp.xForce = fabs(curNode->forceLateral + curNode->smoothLateral);
-    temp.flexion = fabs(curNode->fFlexion());
+    union { float f; quint32 i; } bits;
+    bits.f = value;
+    quint32 sign = (bits.i >> 16) & 0x8000;
+    int exponent = (int)((bits.i >> 23) & 0xff) - 127 + 15;
+    quint32 mantissa = bits.i & 0x7fffff;
+    if(exponent <= 0) return sign;
+    if(exponent >= 31) return sign | 0x7bff;
+    quint32 half = ((quint32)exponent << 10) | (mantissa >> 13);
+    if(mantissa & 0x1000) ++half;
+    if(half > 0x7bff) half = 0x7bff;
+    return sign | half;
+}
 
-    temp.selected = (trackData == gloParent->curTrack() && curSection == trackData->activeSection) ? (curSection->isInFunction(j, gloParent->selectedFunc) ? 2.f : 1.f) : 0.f;
+// octahedral encoding: the normal is projected onto the octahedron |x|+|y|+|z| = 1 and the lower half
+// is folded over the upper one, the same as packNormal() in pipe.vert. zero normals are stored as up,
+// the fallback track.vert used for them
+static void packNormal(qint16* out, glm::vec3 normal)
+{
+    float sum = fabs(normal.x) + fabs(normal.y) + fabs(normal.z);
+    glm::vec2 oct = sum > 1e-6f ? glm::vec2(normal.x, normal.y)/sum : glm::vec2(0.f, 1.f);
+    if(sum > 1e-6f && normal.z < 0.f)
+    {
+        oct = (1.f - glm::abs(glm::vec2(oct.y, oct.x)))*glm::vec2(oct.x >= 0.f ? 1.f : -1.f, oct.y >= 0.f ? 1.f : -1.f);
+    }
+    oct = glm::clamp(oct, -1.f, 1.f)*32767.f;
+    out[0] = (qint16)floor(oct.x+0.5f);
+    out[1] = (qint16)floor(oct.y+0.5f);
+}
 
-    list.append(temp);
+glm::vec3 unpackNormal(const qint16* normal)
+{
+    glm::vec2 oct = glm::max(glm::vec2(normal[0], normal[1])/32767.f, -1.f);
+    glm::vec3 result = glm::vec3(oct, 1.f - fabs(oct.x) - fabs(oct.y));
+    if(result.z < 0.f)
+    {
+        glm::vec2 folded = (1.f - glm::abs(glm::vec2(oct.y, oct.x)))*glm::vec2(oct.x >= 0.f ? 1.f : -1.f, oct.y >= 0.f ? 1.f : -1.f);
+        result.x = folded.x;
+        result.y = folded.y;
+    }
+    return glm::normalize(result);
 }
 
-void trackMesh::append3dsNode(QVector<float> *_vertices)
+void trackMesh::appendTrackNode(meshcursor_t &c, QVector<tracknode_t> &list, float _u, float _v)
 {
-    _vertices->append(nextPos.x);
-    _vertices->append(nextPos.y);
-    _vertices->append(nextPos.z);
+    tracknode_t temp;
+    temp.node = c.nextNode;
+    temp.pos = c.nextPos;
+    packNormal(temp.normal, c.nextNorm);
+    temp.uv = glm::vec2(_u, _v);
+    temp.vel = toHalf(c.curNode->fVel);
+    temp.rollSpeed = toHalf(fabs(c.curNode->fRollSpeed+c.curNode->fSmoothSpeed));
+    temp.yForce = toHalf(c.curNode->forceNormal+c.curNode->smoothNormal);
+    temp.xForce = toHalf(fabs(c.curNode->forceLateral + c.curNode->smoothLateral));
+    temp.flexion = toHalf(fabs(c.curNode->fFlexion()));
+    temp.padding = 0;
+
+    list.append(temp);
 }
 
-void trackMesh::appendSupportNode(QVector<tracknode_t> &list, float _u, float _v)
+void trackMesh::appendSupportNode(meshcursor_t &c, QVector<tracknode_t> &list, float _u, float _v)
 {
     tracknode_t temp;
-    temp.node = nextNode;
-    temp.pos = nextPos;
-    temp.normal = nextNorm;
+    temp.node = c.nextNode;
+    temp.pos = c.nextPos;
+    packNormal(temp.normal, c.nextNorm);
     temp.uv = glm::vec2(_u, _v);
-    temp.vel =0;
+    temp.vel = 0;
     temp.rollSpeed = 0;
     temp.yForce = 0;
     temp.xForce = 0;
     temp.flexion = 0;
-    temp.selected = 0;
+    temp.padding = 0;
 
     list.append(temp);
 }
 
-void trackMesh::appendMeshNode(QVector<meshnode_t> &list)
+void trackMesh::appendMeshNode(meshcursor_t &c, QVector<meshnode_t> &list)
 {
     meshnode_t temp;
-    temp.pos = nextPos;
-    temp.node = nextNode;
+    temp.pos = c.nextPos;
+    temp.node = c.nextNode;
 
     list.append(temp);
 }
 
-int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &options)
+// builds the rings of posList[from] to posList[to-1] and their shadow outlines, segments only
+// share read access to the track so several of them can be built at once
+void trackMesh::createPipeSegment(QVector<tracknode_t> &list, QVector<meshnode_t> &shadowList, const QList<pipeoption_t> &options, const QList<int> &posList, const QList<int> &secList, int from, int to, bool buildRings)
 {
-    int count = 0;
+    meshcursor_t c;
     float angle;
     int numPipes = options.size();
 
-    if(!secList.isEmpty() && rails.isEmpty())
-    {
-        for(int p = 0; p < numPipes; ++p)
-        {
-            j = 0;
-            curSection = trackData->lSections[0];
-			curNode = &curSection->lNodes[0];
-            nextNorm = -curNode->vDirHeart(-options[p].offset.y);
-            nextPos = curNode->vRelPos(options[p].offset.y, options[p].offset.x);
-            nextNode = 0;
-            appendTrackNode(list, 0, curNode->fTotalLength);
-        }
-    }
-
-    for(int pos = 0; pos < posList.size(); ++pos)
+    for(int pos = from; buildRings && pos < to; ++pos)
     {
         for(int p = 0; p < numPipes; ++p)
         {
@@ -173,58 +227,42 @@ int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &opti
                 if(options[p].smooth) angle = i*360.f/options[p].edges - 180.f/options[p].edges;
                 else angle = (i/2)*720.f/options[p].edges - 360.f/options[p].edges;
 
-                j = posList[pos];
-                curSection = trackData->lSections[secList[pos]];
-				curNode = &curSection->lNodes[j];
+                c.secNode = posList[pos];
+                c.curSection = trackData->lSections[secList[pos]];
+				c.curNode = &c.curSection->lNodes[c.secNode];
 
-                nextNorm = -(float)(options[p].radius.y*cos(angle*F_PI/180))*curNode->vNorm+(float)(options[p].radius.x*sin(angle*F_PI/180))*curNode->vLatHeart(-options[p].offset.y);
+                c.nextNorm = -(float)(options[p].radius.y*cos(angle*F_PI/180))*c.curNode->vNorm+(float)(options[p].radius.x*sin(angle*F_PI/180))*c.curNode->vLatHeart(-options[p].offset.y);
 
-                nextPos = curNode->vRelPos(options[p].offset.y, options[p].offset.x)+nextNorm;
-                nextNode = trackData->getNumPoints(curSection) + j;
+                c.nextPos = c.curNode->vRelPos(options[p].offset.y, options[p].offset.x)+c.nextNorm;
+                c.nextNode = trackData->getNumPoints(c.curSection) + c.secNode;
                 if(options[p].smooth)
                 {
-                    nextNorm = glm::normalize(nextNorm);
-                    appendTrackNode(list, r/0.3f*fabs(angle-180+180.f/options[p].edges)/180.f, curNode->fTotalLength);
+                    c.nextNorm = glm::normalize(c.nextNorm);
+                    appendTrackNode(c, list, r/0.3f*fabs(angle-180+180.f/options[p].edges)/180.f, c.curNode->fTotalLength);
                 }
                 else
                 {
-                    nextNorm = -(float)(options[p].radius.y*cos(angle*F_PI/180+((i%2)*2-1)*F_PI_4))*curNode->vNorm+(float)(options[p].radius.x*sin(angle*F_PI/180+((i%2)*2-1)*F_PI_4))*curNode->vLatHeart(-options[p].offset.y);
-                    nextNorm = glm::normalize(nextNorm);
-                    appendTrackNode(list, r/0.3f*fabs(angle-180+180.f/options[p].edges)/180.f, curNode->fTotalLength);
+                    c.nextNorm = -(float)(options[p].radius.y*cos(angle*F_PI/180+((i%2)*2-1)*F_PI_4))*c.curNode->vNorm+(float)(options[p].radius.x*sin(angle*F_PI/180+((i%2)*2-1)*F_PI_4))*c.curNode->vLatHeart(-options[p].offset.y);
+                    c.nextNorm = glm::normalize(c.nextNorm);
+                    appendTrackNode(c, list, r/0.3f*fabs(angle-180+180.f/options[p].edges)/180.f, c.curNode->fTotalLength);
                 }
             }
         }
     }
 
-    //last node here
-    if(!posList.isEmpty())
-    {
-        for(int p = 0; p < numPipes; ++p)
-        {
-            j = posList.last();
-            curSection = trackData->lSections[secList.last()];
-			curNode = &curSection->lNodes[j];
-
-            nextNorm = curNode->vDirHeart(-options[p].offset.y);
-            nextPos = curNode->vRelPos(options[p].offset.y, options[p].offset.x);
-            nextNode = trackData->getNumPoints(curSection) + j;
-            appendTrackNode(list, 0, curNode->fTotalLength);
-        }
-    }
-
     // get shadow vertices
 
     glm::vec3 P1, P2, P3, P4;
-    for(int i =  0; i < posList.size(); ++i)
+    for(int i = from; i < to; ++i)
     {
         for(int p = 0; p < numPipes; ++p)
         {
-            j = posList[i];
-            curSection = trackData->lSections[secList[i]];
-			curNode = &curSection->lNodes[j];
-            nextNode = trackData->getNumPoints(curSection) + j;
+            c.secNode = posList[i];
+            c.curSection = trackData->lSections[secList[i]];
+			c.curNode = &c.curSection->lNodes[c.secNode];
+            c.nextNode = trackData->getNumPoints(c.curSection) + c.secNode;
 
-            float banking = glm::atan(curNode->vLatHeart(-options[p].offset.y).y, -curNode->vNorm.y)+F_PI_2+0.001;
+            float banking = glm::atan(c.curNode->vLatHeart(-options[p].offset.y).y, -c.curNode->vNorm.y)+F_PI_2+0.001;
             if(!options[p].smooth)
             {
                 banking /= F_PI_2;
@@ -232,10 +270,10 @@ int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &opti
                 banking *= F_PI_2;
                 banking += F_PI_4;
             }
-            nextNorm = -(float)(options[p].radius.y*cos(banking))*curNode->vNorm+(float)(options[p].radius.x*sin(banking))*curNode->vLatHeart(-options[p].offset.y);
-            P1 = curNode->vRelPos(options[p].offset.y, options[p].offset.x)+nextNorm;
+            c.nextNorm = -(float)(options[p].radius.y*cos(banking))*c.curNode->vNorm+(float)(options[p].radius.x*sin(banking))*c.curNode->vLatHeart(-options[p].offset.y);
+            P1 = c.curNode->vRelPos(options[p].offset.y, options[p].offset.x)+c.nextNorm;
             P2 = glm::vec3(P1.x, -trackData->startPos.y-1.f, P1.z);
-            banking = glm::atan(curNode->vLatHeart(-options[p].offset.y).y, -curNode->vNorm.y)-F_PI_2-0.001;
+            banking = glm::atan(c.curNode->vLatHeart(-options[p].offset.y).y, -c.curNode->vNorm.y)-F_PI_2-0.001;
             if(!options[p].smooth)
             {
                 banking /= F_PI_2;
@@ -243,258 +281,207 @@ int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &opti
                 banking *= F_PI_2;
                 banking += F_PI_4;
             }
-            nextNorm = -(float)(options[p].radius.y*cos(banking))*curNode->vNorm+(float)(options[p].radius.x*sin(banking))*curNode->vLatHeart(-options[p].offset.y);
-            P4 = curNode->vRelPos(options[p].offset.y, options[p].offset.x)+nextNorm;
+            c.nextNorm = -(float)(options[p].radius.y*cos(banking))*c.curNode->vNorm+(float)(options[p].radius.x*sin(banking))*c.curNode->vLatHeart(-options[p].offset.y);
+            P4 = c.curNode->vRelPos(options[p].offset.y, options[p].offset.x)+c.nextNorm;
             P3 = glm::vec3(P4.x, -trackData->startPos.y-1.f, P4.z);
-            /*if(j == 0 && secList[i] == 0)
-            {
-                createQuad(railshadows, P1, P2, P3, P4);
-                railShadowSize+=2;
-            }
-            else if(i == posList.size()-1)
-            {
-                createBox(railshadows, P1, P2, P4, P3, P5, P6, P8, P7);
-                railShadowSize+=8;
-                createQuad(railshadows, P2, P1, P4, P3);
-                railShadowSize+=2;
-            }
-            else
-            {
-                createBox(railshadows, P1, P2, P4, P3, P5, P6, P8, P7);
-                railShadowSize+=8;
-            }*/
-            nextPos = P1;
-            appendMeshNode(railshadows);
-            nextPos = P2;
-            appendMeshNode(railshadows);
-            nextPos = P3;
-            appendMeshNode(railshadows);
-            nextPos = P4;
-            appendMeshNode(railshadows);
+
+            c.nextPos = P1;
+            appendMeshNode(c, shadowList);
+            c.nextPos = P2;
+            appendMeshNode(c, shadowList);
+            c.nextPos = P3;
+            appendMeshNode(c, shadowList);
+            c.nextPos = P4;
+            appendMeshNode(c, shadowList);
         }
     }
-
-    return count;
 }
 
-int trackMesh::create3dsPipes(QVector<float> *_vertices, QList<pipeoption_t> &options)
+#define PIPE_SEGMENT_SIZE 64
+
+struct pipeSegmentBuilder {
+    trackMesh* mesh;
+    const QList<pipeoption_t>* options;
+    const QList<int>* posList;
+    const QList<int>* secList;
+    QVector<tracknode_t>* rings;
+    QVector<meshnode_t>* shadows;
+    bool buildRings;
+
+    void operator()(int segment, int from, int to) const {
+        mesh->createPipeSegment(rings[segment], shadows[segment], *options, *posList, *secList, from, to, buildRings);
+    }
+};
+
+// without rings only the shadow outlines are built, the rings then come from the pipe shader
+int trackMesh::createPipes(QVector<tracknode_t> &list, QVector<meshnode_t> &shadowList, const QList<pipeoption_t> &options, const QList<int> &posList, const QList<int> &secList, bool buildRings)
 {
+    meshcursor_t c;
     int count = 0;
-    float angle;
     int numPipes = options.size();
 
-    for(int p = 0; p < numPipes; ++p)
+    if(buildRings && !secList.isEmpty() && list.isEmpty())
     {
-        if(!secList.isEmpty())
+        for(int p = 0; p < numPipes; ++p)
         {
-            j = posList[0];
-            curSection = trackData->lSections[secList[0]];
-			curNode = &curSection->lNodes[j];
-            nextNorm = -curNode->vDirHeart(-options[p].offset.y);
-            nextPos = curNode->vRelPos(options[p].offset.y, options[p].offset.x);
-            nextNode = trackData->getNumPoints(curSection) + j;
-            append3dsNode(_vertices);
+            c.secNode = 0;
+            c.curSection = trackData->lSections[0];
+			c.curNode = &c.curSection->lNodes[0];
+            c.nextNorm = -c.curNode->vDirHeart(-options[p].offset.y);
+            c.nextPos = c.curNode->vRelPos(options[p].offset.y, options[p].offset.x);
+            c.nextNode = 0;
+            appendTrackNode(c, list, 0, c.curNode->fTotalLength);
         }
+    }
 
-        for(int pos = 0; pos < posList.size(); ++pos)
-        {
-            //float r = 0.5f*(options[p].radius.y+options[p].radius.x);
-            for(int i = 0; i < options[p].edges; ++i)
-            {
-                if(options[p].smooth) angle = i*360.f/options[p].edges - 180.f/options[p].edges;
-                else angle = (i/2)*720.f/options[p].edges - 360.f/options[p].edges;
+    // the rings of every segment go to their own buffers, appending them in segment order
+    // yields the same layout as building them one after another
+    int numSegments = (posList.size()+PIPE_SEGMENT_SIZE-1)/PIPE_SEGMENT_SIZE;
+    QVector<QVector<tracknode_t> > rings(numSegments);
+    QVector<QVector<meshnode_t> > shadows(numSegments);
 
-                j = posList[pos];
-				curSection = trackData->lSections[secList[pos]];
-				curNode = &curSection->lNodes[j];
+    pipeSegmentBuilder builder;
+    builder.mesh = this;
+    builder.options = &options;
+    builder.posList = &posList;
+    builder.secList = &secList;
+    builder.rings = rings.data();
+    builder.shadows = shadows.data();
+    builder.buildRings = buildRings;
+    parallelChunks(posList.size(), PIPE_SEGMENT_SIZE, builder);
 
-                nextNorm = -(float)(options[p].radius.y*cos(angle*F_PI/180))*curNode->vNorm+(float)(options[p].radius.x*sin(angle*F_PI/180))*curNode->vLatHeart(-options[p].offset.y);
-                nextPos = curNode->vRelPos(options[p].offset.y, options[p].offset.x)+nextNorm;
-                nextNode = trackData->getNumPoints(curSection) + j;
-                if(options[p].smooth)
-                {
-                    nextNorm = glm::normalize(nextNorm);
-                    append3dsNode(_vertices);
-                }
-                else
-                {
-                    nextNorm = -(float)(options[p].radius.y*cos(angle*F_PI/180+((i%2)*2-1)*F_PI_4))*curNode->vNorm+(float)(options[p].radius.x*sin(angle*F_PI/180+((i%2)*2-1)*F_PI_4))*curNode->vLatHeart(-options[p].offset.y);
-                    nextNorm = glm::normalize(nextNorm);
-                    append3dsNode(_vertices);
-                }
-            }
-        }
+    for(int i = 0; i < numSegments; ++i)
+    {
+        list += rings[i];
+        shadowList += shadows[i];
+    }
 
-        //last node here
-        if(!posList.isEmpty())
+    //last node here
+    if(buildRings && !posList.isEmpty())
+    {
+        for(int p = 0; p < numPipes; ++p)
         {
-            j = posList.last();
-            curSection = trackData->lSections[secList.last()];
-			curNode = &curSection->lNodes[j];
-
-            nextNorm = curNode->vDirHeart(-options[p].offset.y);
-            nextPos = curNode->vRelPos(options[p].offset.y, options[p].offset.x);
-            nextNode = trackData->getNumPoints(curSection) + j;
-            append3dsNode(_vertices);
+            c.secNode = posList.last();
+            c.curSection = trackData->lSections[secList.last()];
+			c.curNode = &c.curSection->lNodes[c.secNode];
+
+            c.nextNorm = c.curNode->vDirHeart(-options[p].offset.y);
+            c.nextPos = c.curNode->vRelPos(options[p].offset.y, options[p].offset.x);
+            c.nextNode = trackData->getNumPoints(c.curSection) + c.secNode;
+            appendTrackNode(c, list, 0, c.curNode->fTotalLength);
         }
     }
 
     return count;
 }
 
-int trackMesh::createPipe(QVector<tracknode_t> &list, int edges, float radiusy, float radiusx, float y, float x, bool smooth)
+// GL 3.1 only guarantees 65536 texels, every pipeframe_t takes 5 of them
+static int maxPipeFrames()
 {
-    int count = 0;
-    const float r = 0.5f*(radiusy+radiusx);
+    static GLint texels = 0;
+    if(!texels) glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &texels);
+    return texels/(sizeof(pipeframe_t)/sizeof(glm::vec4));
+}
 
-    float angleLeft, angleRight;
-    for(int iteration = 0; iteration < edges; iteration++)
+// appends the frames of the given mesh nodes, the pipe shader extrudes every pipe option around them
+void trackMesh::createFrames(const QList<int> &posList, const QList<int> &secList)
+{
+    frames.reserve(frames.size()+posList.size());
+    for(int i = 0; i < posList.size(); ++i)
     {
-        angleLeft = iteration*360.f/edges - 180.f/edges;
-        angleRight = iteration*360.f/edges + 180.f/edges;
+        section* curSection = trackData->lSections[secList[i]];
+        mnode* curNode = &curSection->lNodes[posList[i]];
+
+        // same roll estimate as mnode::vLatHeart, the shader tilts lat and dir by it for every pipe height
+        float estimated = curNode->fAngleFromLast < 0.001f ? curNode->fHeartDistFromLast : curNode->fVel/F_HZ;
+        float estDistFromLast = 0.7f*curNode->fHeartDistFromLast + 0.3f*curNode->fDistFromLast;
+        float rollPerMeter = estDistFromLast > 0.f ? (curNode->fRollSpeed + curNode->fSmoothSpeed)/F_HZ/estimated*F_PI/180.f : 0.f;
+        if(rollPerMeter != rollPerMeter || fabs(rollPerMeter) > 1e6f) rollPerMeter = 0.f;
+
+        pipeframe_t temp;
+        temp.pos = curNode->vPos;
+        temp.rollPerMeter = rollPerMeter;
+        temp.norm = curNode->vNorm;
+        temp.length = curNode->fTotalLength;
+        temp.lat = glm::normalize(curNode->vLat);
+        temp.vel = curNode->fVel;
+        temp.dir = glm::normalize(curNode->vDir);
+        temp.rollSpeed = fabs(curNode->fRollSpeed+curNode->fSmoothSpeed);
+        temp.yForce = curNode->forceNormal+curNode->smoothNormal;
+        temp.xForce = fabs(curNode->forceLateral + curNode->smoothLateral);
+        temp.flexion = fabs(curNode->fFlexion());
+        temp.node = trackData->getNumPoints(curSection) + posList[i];
+        frames.append(temp);
+    }
+}
 
-        for(int i = (iteration%2==0) ? 0 : posList.size()-1; (iteration%2==0) ? i < posList.size() : i >= 0; (iteration%2==0) ? ++i : --i)
-        {
-            j = posList[i];
-            curSection = trackData->lSections[secList[i]];
+// builds the rings the pipe shader would extrude on the cpu, the exporters need them in memory
+void trackMesh::extrudeRails(QVector<tracknode_t> &list)
+{
+    QList<int> posList;
+    QList<int> secList;
+    for(int i = 0; i < nodeList.size(); ++i)
+    {
+        int node, section;
+        trackData->getSecNode(nodeList[i], &node, &section);
+        posList.append(node);
+        secList.append(section);
+    }
 
-			curNode = &curSection->lNodes[j];
+    QVector<meshnode_t> shadows;
+    list.clear();
+    createPipes(list, shadows, options, posList, secList);
+}
 
-            if((i == 0 && iteration%2==0) || (i == posList.size()-1 && iteration%2!=0))
-            {
-                nextPos = curNode->vRelPos(y, x);
-                nextNorm = ((iteration%2==0) ? -1.f : 1.f)*curNode->vDirHeart(-y);
-                appendTrackNode(list, 0, curNode->fTotalLength);
-                ++count;
-            }
+// extrudes the pipes along the given mesh nodes, only touches its arguments so sections can be built concurrently
+int trackMesh::create3dsPipes(QVector<float> *_vertices, const QList<pipeoption_t> &options, const QList<int> &posList, const QList<int> &secList)
+{
+    int count = 0;
+    float angle;
+    int numPipes = options.size();
+    glm::vec3 pos;
 
-            if(iteration%2 == 0)
-            {
-                nextNorm = -(float)(radiusy*cos(angleLeft*F_PI/180))*curNode->vNorm+(float)(radiusx*sin(angleLeft*F_PI/180))*curNode->vLatHeart(-y);
-                nextPos = curNode->vRelPos(y, x)+nextNorm;
-                if(smooth)
-                {
-                    nextNorm = glm::normalize(nextNorm);
-                }
-                else
-                {
-                    nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*curNode->vNorm+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*curNode->vLatHeart(-y));
-                }
-                appendTrackNode(list, r/0.3f*angleLeft/180.f, curNode->fTotalLength);
-                ++count;
+    for(int p = 0; p < numPipes; ++p)
+    {
+        if(!secList.isEmpty())
+        {
+            mnode* curNode = &trackData->lSections[secList[0]]->lNodes[posList[0]];
+            pos = curNode->vRelPos(options[p].offset.y, options[p].offset.x);
+            _vertices->append(pos.x);
+            _vertices->append(pos.y);
+            _vertices->append(pos.z);
+        }
 
-                nextNorm = -(float)(radiusy*cos(angleRight*F_PI/180))*curNode->vNorm+(float)(radiusx*sin(angleRight*F_PI/180))*curNode->vLatHeart(-y);
-                nextPos = curNode->vRelPos(y, x)+nextNorm;
-                if(smooth)
-                {
-                    nextNorm = glm::normalize(nextNorm);
-                }
-                else
-                {
-                    nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*curNode->vNorm+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*curNode->vLatHeart(-y));
-                }
-                appendTrackNode(list, r/0.3f*angleRight/180.f, curNode->fTotalLength);
-                ++count;
-            }
-            else
+        for(int n = 0; n < posList.size(); ++n)
+        {
+            mnode* curNode = &trackData->lSections[secList[n]]->lNodes[posList[n]];
+            for(int i = 0; i < options[p].edges; ++i)
             {
-                nextNorm = -(float)(radiusy*cos(angleRight*F_PI/180))*curNode->vNorm+(float)(radiusx*sin(angleRight*F_PI/180))*curNode->vLatHeart(-y);
-                nextPos = curNode->vRelPos(y, x)+nextNorm;
-                if(smooth)
-                {
-                    nextNorm = glm::normalize(nextNorm);
-                }
-                else
-                {
-                    nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*curNode->vNorm+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*curNode->vLatHeart(-y));
-                }
-                appendTrackNode(list, r/0.3f*angleRight/180.f, curNode->fTotalLength);
-                ++count;
-
-
-                nextNorm = -(float)(radiusy*cos(angleLeft*F_PI/180))*curNode->vNorm+(float)(radiusx*sin(angleLeft*F_PI/180))*curNode->vLatHeart(-y);
-                nextPos = curNode->vRelPos(y, x)+nextNorm;
-                if(smooth)
-                {
-                    nextNorm = glm::normalize(nextNorm);
-                }
-                else
-                {
-                    nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*curNode->vNorm+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*curNode->vLatHeart(-y));
-                }
-                appendTrackNode(list, r/0.3f*angleLeft/180.f, curNode->fTotalLength);
-                ++count;
-            }
+                if(options[p].smooth) angle = i*360.f/options[p].edges - 180.f/options[p].edges;
+                else angle = (i/2)*720.f/options[p].edges - 360.f/options[p].edges;
 
-            if((i == 0 && iteration == edges-1))
-            {
-                nextPos = curNode->vRelPos(y, x);
-                nextNorm = ((iteration%2==0) ? 1.f : -1.f)*curNode->vDirHeart(-y);
-                appendTrackNode(list, r/0.3f*angleLeft/180.f, curNode->fTotalLength);
-                ++count;
+                pos = curNode->vRelPos(options[p].offset.y, options[p].offset.x) - (float)(options[p].radius.y*cos(angle*F_PI/180))*curNode->vNorm+(float)(options[p].radius.x*sin(angle*F_PI/180))*curNode->vLatHeart(-options[p].offset.y);
+                _vertices->append(pos.x);
+                _vertices->append(pos.y);
+                _vertices->append(pos.z);
             }
-
         }
-    }
-
-
-    glm::vec3 P1, P2, P3, P4, P5, P6, P7, P8;
-    for(int i =  0; i < posList.size(); ++i)
-    {
-        j = posList[i];
-        curSection = trackData->lSections[secList[i]];
-
-		curNode = &curSection->lNodes[j];
 
-        P5 = P1;
-        P6 = P2;
-        P7 = P3;
-        P8 = P4;
-        float banking = glm::atan(curNode->vLatHeart(-y).y, -curNode->vNorm.y)+F_PI_2+0.001;
-        if(!smooth)
-        {
-            banking /= F_PI_2;
-            banking = floor(banking);
-            banking *= F_PI_2;
-            banking += F_PI_4;
-        }
-        nextNorm = -(float)(radiusy*cos(banking))*curNode->vNorm+(float)(radiusx*sin(banking))*curNode->vLatHeart(-y);
-        P1 = curNode->vRelPos(y, x)+nextNorm;
-        P2 = glm::vec3(P1.x, -trackData->startPos.y-1.f, P1.z);
-        banking = glm::atan(curNode->vLatHeart(-y).y, -curNode->vNorm.y)-F_PI_2-0.001;
-        if(!smooth)
-        {
-            banking /= F_PI_2;
-            banking = floor(banking);
-            banking *= F_PI_2;
-            banking += F_PI_4;
-        }
-        nextNorm = -(float)(radiusy*cos(banking))*curNode->vNorm+(float)(radiusx*sin(banking))*curNode->vLatHeart(-y);
-        P4 = curNode->vRelPos(y, x)+nextNorm;
-        P3 = glm::vec3(P4.x, -trackData->startPos.y-1.f, P4.z);
-        if(i == 0)
-        {
-            createQuad(railshadows, P1, P2, P3, P4);
-            railShadowSize+=2;
-        }
-        else if(i == posList.size()-1)
-        {
-            createBox(railshadows, P1, P2, P4, P3, P5, P6, P8, P7);
-            railShadowSize+=8;
-            createQuad(railshadows, P2, P1, P4, P3);
-            railShadowSize+=2;
-        }
-        else
+        //last node here
+        if(!posList.isEmpty())
         {
-            createBox(railshadows, P1, P2, P4, P3, P5, P6, P8, P7);
-            railShadowSize+=8;
+            mnode* curNode = &trackData->lSections[secList.last()]->lNodes[posList.last()];
+            pos = curNode->vRelPos(options[p].offset.y, options[p].offset.x);
+            _vertices->append(pos.x);
+            _vertices->append(pos.y);
+            _vertices->append(pos.z);
         }
     }
 
     return count;
 }
 
-void trackMesh::createSupport(QVector<tracknode_t> &list, int edges, float radiusy, float radiusx, glm::vec3 P1, glm::vec3 P2, bool smooth)
+void trackMesh::createSupport(meshcursor_t &c, QVector<tracknode_t> &list, QVector<meshnode_t> &shadowList, int edges, float radiusy, float radiusx, glm::vec3 P1, glm::vec3 P2, bool smooth)
 {
     const float r = 0.5f*(radiusy+radiusx);
     const float length = glm::length(P1-P2);
@@ -514,94 +501,91 @@ void trackMesh::createSupport(QVector<tracknode_t> &list, int edges, float radiu
         angleLeft = i*360.f/edges - 180.f/edges;
         angleRight = i*360.f/edges + 180.f/edges;
 
-        nextPos = i%2 ? P1 : P2;
-        nextNorm = (i%2 ? -1.f : 1.f)*dir;
-        appendSupportNode(list, 0, (i%2) ? length : 0);
+        c.nextPos = i%2 ? P1 : P2;
+        c.nextNorm = (i%2 ? -1.f : 1.f)*dir;
+        appendSupportNode(c, list, 0, (i%2) ? length : 0);
 
 
-        nextNorm = -(float)(radiusy*cos(angleLeft*F_PI/180))*up+(float)(radiusx*sin(angleLeft*F_PI/180))*side;
-        nextPos = i%2 ? P1+nextNorm : P2+nextNorm;
+        c.nextNorm = -(float)(radiusy*cos(angleLeft*F_PI/180))*up+(float)(radiusx*sin(angleLeft*F_PI/180))*side;
+        c.nextPos = i%2 ? P1+c.nextNorm : P2+c.nextNorm;
         if(smooth)
         {
-            nextNorm = glm::normalize(nextNorm);
+            c.nextNorm = glm::normalize(c.nextNorm);
         }
         else
         {
-            nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*up+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*side);
+            c.nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*up+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*side);
         }
-        appendSupportNode(list, r/0.3f*angleLeft/180.f, (i%2) ? length : 0);
+        appendSupportNode(c, list, r/0.3f*angleLeft/180.f, (i%2) ? length : 0);
 
-        nextNorm = -(float)(radiusy*cos(angleRight*F_PI/180))*up+(float)(radiusx*sin(angleRight*F_PI/180))*side;
-        nextPos = i%2 ? P1+nextNorm : P2+nextNorm;
+        c.nextNorm = -(float)(radiusy*cos(angleRight*F_PI/180))*up+(float)(radiusx*sin(angleRight*F_PI/180))*side;
+        c.nextPos = i%2 ? P1+c.nextNorm : P2+c.nextNorm;
         if(smooth)
         {
-            nextNorm = glm::normalize(nextNorm);
+            c.nextNorm = glm::normalize(c.nextNorm);
         }
         else
         {
-            nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*up+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*side);
+            c.nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*up+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*side);
         }
-        appendSupportNode(list, r/0.3f*angleRight/180.f, (i%2) ? length : 0);
+        appendSupportNode(c, list, r/0.3f*angleRight/180.f, (i%2) ? length : 0);
 
-        nextNorm = -(float)(radiusy*cos(angleLeft*F_PI/180))*up+(float)(radiusx*sin(angleLeft*F_PI/180))*side;
-        nextPos = i%2 ? P2+nextNorm : P1+nextNorm;
+        c.nextNorm = -(float)(radiusy*cos(angleLeft*F_PI/180))*up+(float)(radiusx*sin(angleLeft*F_PI/180))*side;
+        c.nextPos = i%2 ? P2+c.nextNorm : P1+c.nextNorm;
         if(smooth)
         {
-            nextNorm = glm::normalize(nextNorm);
+            c.nextNorm = glm::normalize(c.nextNorm);
         }
         else
         {
-            nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*up+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*side);
+            c.nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*up+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*side);
         }
-        appendSupportNode(list, r/0.3f*angleLeft/180.f, (i%2) ? 0 : length);
+        appendSupportNode(c, list, r/0.3f*angleLeft/180.f, (i%2) ? 0 : length);
 
-        nextNorm = -(float)(radiusy*cos(angleRight*F_PI/180))*up+(float)(radiusx*sin(angleRight*F_PI/180))*side;
-        nextPos = i%2 ? P2+nextNorm : P1+nextNorm;
+        c.nextNorm = -(float)(radiusy*cos(angleRight*F_PI/180))*up+(float)(radiusx*sin(angleRight*F_PI/180))*side;
+        c.nextPos = i%2 ? P2+c.nextNorm : P1+c.nextNorm;
         if(smooth)
         {
-            nextNorm = glm::normalize(nextNorm);
+            c.nextNorm = glm::normalize(c.nextNorm);
         }
         else
         {
-            nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*up+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*side);
+            c.nextNorm = glm::normalize(-(float)(radiusy*cos((angleLeft+angleRight)*F_PI/360))*up+(float)(radiusx*sin((angleLeft+angleRight)*F_PI/360))*side);
         }
-        appendSupportNode(list, r/0.3f*angleRight/180.f, (i%2) ? 0 : length);
+        appendSupportNode(c, list, r/0.3f*angleRight/180.f, (i%2) ? 0 : length);
 
     }
 
 
-    nextPos = edges%2 ? P2 : P1;
-    nextNorm = (edges%2 ? 1.f : -1.f)*dir;
-    appendSupportNode(list, 0, (edges%2) ? 0 : length);
+    c.nextPos = edges%2 ? P2 : P1;
+    c.nextNorm = (edges%2 ? 1.f : -1.f)*dir;
+    appendSupportNode(c, list, 0, (edges%2) ? 0 : length);
 
     /* SHADOW STUFF */
 
     if(fabs(up.y) < 0.0001) return;
     glm::vec3 P1s, P2s, P3, P4, P5, P6, P7, P8;
 
-    nextNorm = radiusx*side;
-    P1s = P1+nextNorm;
+    c.nextNorm = radiusx*side;
+    P1s = P1+c.nextNorm;
     P2s = glm::vec3(P1s.x, -trackData->startPos.y-1, P1s.z);
-    P4 = P1-nextNorm;
+    P4 = P1-c.nextNorm;
     P3 = glm::vec3(P4.x, -trackData->startPos.y-1, P4.z);
-    P5 = P2+nextNorm;
+    P5 = P2+c.nextNorm;
     P6 = glm::vec3(P5.x, -trackData->startPos.y-1, P5.z);
-    P8 = P2-nextNorm;
+    P8 = P2-c.nextNorm;
     P7 = glm::vec3(P8.x, -trackData->startPos.y-1, P8.z);
 
     //createQuad(railshadows, P4, P3, P2s, P1s);
-    createQuad(supportshadows, P1s, P2s, P3, P4);
-    railShadowSize+=2;
-    createBox(supportshadows, P5, P6, P8, P7, P1s, P2s, P4, P3);
+    createQuad(c, shadowList, P1s, P2s, P3, P4);
+    createBox(c, shadowList, P5, P6, P8, P7, P1s, P2s, P4, P3);
     //createBox(railshadows, P3, P4, P2s, P1s, P7, P8, P6, P5);
-    railShadowSize+=8;
     //createQuad(railshadows, P5, P6, P7, P8);
-    createQuad(supportshadows, P8, P7, P6, P5);
-    railShadowSize+=2;
+    createQuad(c, shadowList, P8, P7, P6, P5);
 }
 
 
-void trackMesh::createQuad(QVector<tracknode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4)
+void trackMesh::createQuad(meshcursor_t &c, QVector<tracknode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4)
 {
     //float start = glm::length(P1);
     glm::vec3 base1 = glm::normalize(P1-P4);
@@ -609,23 +593,23 @@ void trackMesh::createQuad(QVector<tracknode_t> &list, glm::vec3 P1, glm::vec3 P
     base2 = glm::cross(base1, base2);
     base2 = glm::cross(base1, base2);
 
-    nextNorm = glm::normalize(glm::cross(P1-P4, P1-P2));
+    c.nextNorm = glm::normalize(glm::cross(P1-P4, P1-P2));
     //nextNorm = glm::rotateY(nextNorm, trackData->startYaw-90);
-    nextPos = P1;
-    appendTrackNode(list, glm::dot(P1, base1), glm::dot(P1, base2));
-    nextPos = P2;
-    appendTrackNode(list, glm::dot(P2, base1), glm::dot(P2, base2));
-    nextPos = P4;
-    appendTrackNode(list, glm::dot(P4, base1), glm::dot(P4, base2));
-
-    nextNorm = glm::normalize(glm::cross(P2-P4, P2-P3));
+    c.nextPos = P1;
+    appendTrackNode(c, list, glm::dot(P1, base1), glm::dot(P1, base2));
+    c.nextPos = P2;
+    appendTrackNode(c, list, glm::dot(P2, base1), glm::dot(P2, base2));
+    c.nextPos = P4;
+    appendTrackNode(c, list, glm::dot(P4, base1), glm::dot(P4, base2));
+
+    c.nextNorm = glm::normalize(glm::cross(P2-P4, P2-P3));
     //nextNorm = glm::rotateY(nextNorm, trackData->startYaw-90);
-    nextPos = P2;
-    appendTrackNode(list, glm::dot(P2, base1), glm::dot(P2, base2));
-    nextPos = P3;
-    appendTrackNode(list, glm::dot(P3, base1), glm::dot(P3, base2));
-    nextPos = P4;
-    appendTrackNode(list, glm::dot(P4, base1), glm::dot(P4, base2));
+    c.nextPos = P2;
+    appendTrackNode(c, list, glm::dot(P2, base1), glm::dot(P2, base2));
+    c.nextPos = P3;
+    appendTrackNode(c, list, glm::dot(P3, base1), glm::dot(P3, base2));
+    c.nextPos = P4;
+    appendTrackNode(c, list, glm::dot(P4, base1), glm::dot(P4, base2));
 }
 
 void trackMesh::create3dsQuad(QVector<float> *_vertices, QVector<unsigned int> *_indices, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4)
@@ -656,56 +640,56 @@ void trackMesh::create3dsQuad(QVector<float> *_vertices, QVector<unsigned int> *
     _indices->append(offset+2);
 }
 
-void trackMesh::createQuad(QVector<meshnode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4)
+void trackMesh::createQuad(meshcursor_t &c, QVector<meshnode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4)
 {
-    nextNorm = glm::normalize(glm::cross(P1-P4, P1-P2));
+    c.nextNorm = glm::normalize(glm::cross(P1-P4, P1-P2));
     //nextNorm = glm::rotateY(nextNorm, trackData->startYaw-90);
-    nextPos = P1;
-    appendMeshNode(list);
-    nextPos = P2;
-    appendMeshNode(list);
-    nextPos = P4;
-    appendMeshNode(list);
-
-    nextNorm = glm::normalize(glm::cross(P2-P4, P2-P3));
+    c.nextPos = P1;
+    appendMeshNode(c, list);
+    c.nextPos = P2;
+    appendMeshNode(c, list);
+    c.nextPos = P4;
+    appendMeshNode(c, list);
+
+    c.nextNorm = glm::normalize(glm::cross(P2-P4, P2-P3));
     //nextNorm = glm::rotateY(nextNorm, trackData->startYaw-90);
-    nextPos = P2;
-    appendMeshNode(list);
-    nextPos = P3;
-    appendMeshNode(list);
-    nextPos = P4;
-    appendMeshNode(list);
+    c.nextPos = P2;
+    appendMeshNode(c, list);
+    c.nextPos = P3;
+    appendMeshNode(c, list);
+    c.nextPos = P4;
+    appendMeshNode(c, list);
 }
 
-int trackMesh::createShadowTriangle(QVector<meshnode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3)
+int trackMesh::createShadowTriangle(meshcursor_t &c, QVector<meshnode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3)
 {
-    nextNorm = glm::normalize(glm::cross(P1-P2, P1-P3));
+    c.nextNorm = glm::normalize(glm::cross(P1-P2, P1-P3));
     glm::vec3 lightvec = glm::vec3(0.f, 1.f, 0.f);
-    if(glm::dot(nextNorm, lightvec) < 0) return 0;
-
-    nextPos = P1;
-    appendMeshNode(list);
-    nextPos = P3;
-    appendMeshNode(list);
-    nextPos = P2;
-    appendMeshNode(list);
-
-    nextNorm = glm::vec3(0, -1, 0);
-    nextPos = glm::vec3(P1.x, -1-trackData->startPos.y, P1.z);
-    appendMeshNode(list);
-    nextPos = glm::vec3(P2.x, -1-trackData->startPos.y, P2.z);
-    appendMeshNode(list);
-    nextPos = glm::vec3(P3.x, -1-trackData->startPos.y, P3.z);
-    appendMeshNode(list);
+    if(glm::dot(c.nextNorm, lightvec) < 0) return 0;
+
+    c.nextPos = P1;
+    appendMeshNode(c, list);
+    c.nextPos = P3;
+    appendMeshNode(c, list);
+    c.nextPos = P2;
+    appendMeshNode(c, list);
+
+    c.nextNorm = glm::vec3(0, -1, 0);
+    c.nextPos = glm::vec3(P1.x, -1-trackData->startPos.y, P1.z);
+    appendMeshNode(c, list);
+    c.nextPos = glm::vec3(P2.x, -1-trackData->startPos.y, P2.z);
+    appendMeshNode(c, list);
+    c.nextPos = glm::vec3(P3.x, -1-trackData->startPos.y, P3.z);
+    appendMeshNode(c, list);
     return 2;
 }
 
-void trackMesh::createBox(QVector<tracknode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r)
+void trackMesh::createBox(meshcursor_t &c, QVector<tracknode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r)
 {
-    createQuad(list, P1l, P2l, P2r, P1r);
-    createQuad(list, P2l, P4l, P4r, P2r);
-    createQuad(list, P4l, P3l, P3r, P4r);
-    createQuad(list, P3l, P1l, P1r, P3r);
+    createQuad(c, list, P1l, P2l, P2r, P1r);
+    createQuad(c, list, P2l, P4l, P4r, P2r);
+    createQuad(c, list, P4l, P3l, P3r, P4r);
+    createQuad(c, list, P3l, P1l, P1r, P3r);
 }
 
 void trackMesh::create3dsBox(QVector<float> *_vertices, QVector<unsigned int> *_indices, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r)
@@ -768,15 +752,15 @@ void trackMesh::create3dsBox(QVector<float> *_vertices, QVector<unsigned int> *_
     }
 }
 
-void trackMesh::createBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r)
+void trackMesh::createBox(meshcursor_t &c, QVector<meshnode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r)
 {
-    createQuad(list, P1l, P2l, P2r, P1r);
-    createQuad(list, P2l, P4l, P4r, P2r);
-    createQuad(list, P4l, P3l, P3r, P4r);
-    createQuad(list, P3l, P1l, P1r, P3r);
+    createQuad(c, list, P1l, P2l, P2r, P1r);
+    createQuad(c, list, P2l, P4l, P4r, P2r);
+    createQuad(c, list, P4l, P3l, P3r, P4r);
+    createQuad(c, list, P3l, P1l, P1r, P3r);
 }
 
-int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r)
+int trackMesh::createShadowBox(meshcursor_t &c, QVector<meshnode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r)
 {
     int count = 0;
     glm::vec3 PS1, PS2;
@@ -790,12 +774,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P1r.x, -trackData->startPos.y-1.f, P1r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P2l, P1r, PS2, PS1);
+        createQuad(c, list, P2l, P1r, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P1r, P2l, PS1, PS2);
+        createQuad(c, list, P1r, P2l, PS1, PS2);
         count+=2;
     }
 
@@ -809,12 +793,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P2r.x, -trackData->startPos.y-1.f, P2r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P2l, P2r, PS2, PS1);
+        createQuad(c, list, P2l, P2r, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P2r, P2l, PS1, PS2);
+        createQuad(c, list, P2r, P2l, PS1, PS2);
         count+=2;
     }
 
@@ -827,12 +811,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P2r.x, -trackData->startPos.y-1.f, P2r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P4l, P2r, PS2, PS1);
+        createQuad(c, list, P4l, P2r, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P2r, P4l, PS1, PS2);
+        createQuad(c, list, P2r, P4l, PS1, PS2);
         count+=2;
     }
 
@@ -846,12 +830,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P4r.x, -trackData->startPos.y-1.f, P4r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P4l, P4r, PS2, PS1); // x
+        createQuad(c, list, P4l, P4r, PS2, PS1); // x
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P4r, P4l, PS1, PS2);
+        createQuad(c, list, P4r, P4l, PS1, PS2);
         count+=2;
     }
 
@@ -864,12 +848,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P4r.x, -trackData->startPos.y-1.f, P4r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P3l, P4r, PS2, PS1);
+        createQuad(c, list, P3l, P4r, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P4r, P3l, PS1, PS2); // x
+        createQuad(c, list, P4r, P3l, PS1, PS2); // x
         count+=2;
     }
 
@@ -882,12 +866,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P3r.x, -trackData->startPos.y-1.f, P3r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P3l, P3r, PS2, PS1); // x
+        createQuad(c, list, P3l, P3r, PS2, PS1); // x
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P3r, P3l, PS1, PS2);
+        createQuad(c, list, P3r, P3l, PS1, PS2);
         count+=2;
     }
 
@@ -900,12 +884,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P3r.x, -trackData->startPos.y-1.f, P3r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P1l, P3r, PS2, PS1);
+        createQuad(c, list, P1l, P3r, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P3r, P1l, PS1, PS2);
+        createQuad(c, list, P3r, P1l, PS1, PS2);
         count+=2;
     }
 
@@ -918,12 +902,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P1r.x, -trackData->startPos.y-1.f, P1r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P1l, P1r, PS2, PS1);
+        createQuad(c, list, P1l, P1r, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P1r, P1l, PS1, PS2); // x
+        createQuad(c, list, P1r, P1l, PS1, PS2); // x
         count+=2;
     }
 
@@ -938,12 +922,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P2l.x, -trackData->startPos.y-1.f, P2l.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P1l, P2l, PS2, PS1);
+        createQuad(c, list, P1l, P2l, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P2l, P1l, PS1, PS2);
+        createQuad(c, list, P2l, P1l, PS1, PS2);
         count+=2;
     }
 
@@ -956,12 +940,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P4l.x, -trackData->startPos.y-1.f, P4l.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P1l, P4l, PS2, PS1);
+        createQuad(c, list, P1l, P4l, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P4l, P1l, PS1, PS2);
+        createQuad(c, list, P4l, P1l, PS1, PS2);
         count+=2;
     }
 
@@ -974,12 +958,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P4l.x, -trackData->startPos.y-1.f, P4l.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P3l, P4l, PS2, PS1);
+        createQuad(c, list, P3l, P4l, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P4l, P3l, PS1, PS2);
+        createQuad(c, list, P4l, P3l, PS1, PS2);
         count+=2;
     }
 
@@ -992,12 +976,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P1l.x, -trackData->startPos.y-1.f, P1l.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P3l, P1l, PS2, PS1);
+        createQuad(c, list, P3l, P1l, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P1l, P3l, PS1, PS2); // x
+        createQuad(c, list, P1l, P3l, PS1, PS2); // x
         count+=2;
     }
 
@@ -1010,12 +994,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P2l.x, -trackData->startPos.y-1.f, P2l.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P4l, P2l, PS2, PS1);
+        createQuad(c, list, P4l, P2l, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P2l, P4l, PS1, PS2);
+        createQuad(c, list, P2l, P4l, PS1, PS2);
         count+=2;
     }
 
@@ -1030,12 +1014,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P1r.x, -trackData->startPos.y-1.f, P1r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P2r, P1r, PS2, PS1); // x
+        createQuad(c, list, P2r, P1r, PS2, PS1); // x
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P1r, P2r, PS1, PS2);
+        createQuad(c, list, P1r, P2r, PS1, PS2);
         count+=2;
     }
 
@@ -1048,12 +1032,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P1r.x, -trackData->startPos.y-1.f, P1r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P4r, P1r, PS2, PS1);
+        createQuad(c, list, P4r, P1r, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P1r, P4r, PS1, PS2);
+        createQuad(c, list, P1r, P4r, PS1, PS2);
         count+=2;
     }
 
@@ -1066,12 +1050,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P3r.x, -trackData->startPos.y-1.f, P3r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P4r, P3r, PS2, PS1);
+        createQuad(c, list, P4r, P3r, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P3r, P4r, PS1, PS2); // x
+        createQuad(c, list, P3r, P4r, PS1, PS2); // x
         count+=2;
     }
 
@@ -1084,12 +1068,12 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P1r.x, -trackData->startPos.y-1.f, P1r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P3r, P1r, PS2, PS1);
+        createQuad(c, list, P3r, P1r, PS2, PS1);
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P1r, P3r, PS1, PS2);
+        createQuad(c, list, P1r, P3r, PS1, PS2);
         count+=2;
     }
 
@@ -1102,50 +1086,693 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     PS2 = glm::vec3(P2r.x, -trackData->startPos.y-1.f, P2r.z);
     if(dot1 <= 0 && dot2 > 0)
     {
-        createQuad(list, P4r, P2r, PS2, PS1); // x
+        createQuad(c, list, P4r, P2r, PS2, PS1); // x
         count+=2;
     }
     else if(dot2 <= 0 && dot1 > 0)
     {
-        createQuad(list, P2r, P4r, PS1, PS2);
+        createQuad(c, list, P2r, P4r, PS1, PS2);
         count+=2;
     }
 
-    count+=createShadowTriangle(list, P2l, P1r, P1l);
-    count+=createShadowTriangle(list, P2l, P2r, P1r);
-    count+=createShadowTriangle(list, P4l, P2r, P2l);
-    count+=createShadowTriangle(list, P4l, P4r, P2r);
-    count+=createShadowTriangle(list, P4l, P3l, P4r);
-    count+=createShadowTriangle(list, P3l, P3r, P4r);
-    count+=createShadowTriangle(list, P1l, P3r, P3l);
-    count+=createShadowTriangle(list, P1l, P1r, P3r);
+    count+=createShadowTriangle(c, list, P2l, P1r, P1l);
+    count+=createShadowTriangle(c, list, P2l, P2r, P1r);
+    count+=createShadowTriangle(c, list, P4l, P2r, P2l);
+    count+=createShadowTriangle(c, list, P4l, P4r, P2r);
+    count+=createShadowTriangle(c, list, P4l, P3l, P4r);
+    count+=createShadowTriangle(c, list, P3l, P3r, P4r);
+    count+=createShadowTriangle(c, list, P1l, P3r, P3l);
+    count+=createShadowTriangle(c, list, P1l, P1r, P3r);
 
-    count+=createShadowTriangle(list, P4l, P2l, P1l);
-    count+=createShadowTriangle(list, P4l, P1l, P3l);
-    count+=createShadowTriangle(list, P2r, P4r, P1r);
-    count+=createShadowTriangle(list, P4r, P3r, P1r);
+    count+=createShadowTriangle(c, list, P4l, P2l, P1l);
+    count+=createShadowTriangle(c, list, P4l, P1l, P3l);
+    count+=createShadowTriangle(c, list, P2r, P4r, P1r);
+    count+=createShadowTriangle(c, list, P4r, P3r, P1r);
 
 
     return count;
 }
 
+#define XS (0.06f)
+#define S (0.08f)
+#define M (0.10f)
+#define L (0.12f)
+#define XL (0.14f)
+#define XXL (0.16f)
+
+#define BOX_INWARD (0.14f)
+#define BOX_DIAG0 (0.08f)
+#define BOX_DIAG1 (0.18f)
+#define BOX_WIDTH (0.05f)
+
+// lastNode is the node of the previous crosstie, index counts the crossties from the start of the track
+void trackMesh::createCrosstie(meshcursor_t &c, QVector<tracknode_t> &list, QVector<meshnode_t> &shadowList, mnode* lastNode, int index, float railSpacing, float railWidth, float spineHeight, float spineSize)
+{
+    glm::vec3 P1, P2, P3, P4, P5, P6, P7, P8;
+    float mysign = fabs(spineHeight)/spineHeight;
+    switch(trackData->style)
+    {
+    case generic:
+        P1 = c.curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, -railSpacing, -0.15*spineHeight);
+        P2 = c.curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, -railSpacing, 0.15*spineHeight);
+        P3 = c.curNode->vRelPos(-trackData->fHeart, -railSpacing, -0.15*spineHeight);
+        P4 = c.curNode->vRelPos(-trackData->fHeart, -railSpacing, 0.15*spineHeight);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, -0.15f);//-0.35*spineHeight);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, 0.15f);//0.35*spineHeight);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.15f);// -0.15*spineHeight);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.15f);// 0.15*spineHeight);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, -0.15f);//-0.35*spineHeight);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, 0.15f);//0.35*spineHeight);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.15f);//, -0.15*spineHeight);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.15f);//, 0.15*spineHeight);
+        P5 = c.curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, railSpacing, -0.15*spineHeight);
+        P6 = c.curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, railSpacing, 0.15*spineHeight);
+        P7 = c.curNode->vRelPos(-trackData->fHeart, railSpacing, -0.15*spineHeight);
+        P8 = c.curNode->vRelPos(-trackData->fHeart, railSpacing, 0.15*spineHeight);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        break;
+    case genericflat:
+        if(index%6 == 0)
+        {
+            P1 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), -railSpacing, -M);
+            P2 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), -railSpacing, M);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), -railSpacing, -M);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), -railSpacing, M);
+            P5 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), railSpacing, -M);
+            P6 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), railSpacing, M);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), railSpacing, -M);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), railSpacing, M);
+
+        }
+        else
+        {
+            P1 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, -0.03);
+            P2 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, 0.03);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, -0.03);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, 0.03);
+            P5 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, -0.03);
+            P6 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, 0.03);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, -0.03);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, 0.03);
+        }
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        if(index)
+        {
+            P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing+0.13, 0.03);
+            P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing+0.07, 0.03);
+            P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing+0.13, 0.03);
+            P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing+0.07, 0.03);
+            P5 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing-0.07, -0.03);
+            P6 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing-0.13, -0.03);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing-0.07, -0.03);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing-0.13, -0.03);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        break;
+    case vekoma:
+        P1 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -railSpacing-0.5*railWidth, -0.05f);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -railSpacing-0.5*railWidth, +0.05f);
+        P3 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing-0.5*railWidth, -0.05f);
+        P4 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing-0.5*railWidth, +0.05f);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.2*railSpacing, -0.05f);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.2*railSpacing, +0.05f);
+        P7 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, -0.05f);
+        P8 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, +0.05f);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing+0.5*railWidth, -0.05f);
+        P2 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing+0.5*railWidth, +0.05f);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, railSpacing+0.5*railWidth, -0.05f);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, railSpacing+0.5*railWidth, +0.05f);
+        P5 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, -0.05f);
+        P6 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, +0.05f);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.2*railSpacing, -0.05f);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.2*railSpacing, +0.05f);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, -0.05f);
+        P2 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, +0.05f);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.3*railSpacing, -0.05f);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.3*railSpacing, +0.05f);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.2*railSpacing, -0.05f);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.2*railSpacing, +0.05f);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, -0.05f);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, +0.05f);
+
+        createQuad(c, list, P2, P1, P3, P4);
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.3*railSpacing, -0.05f);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.3*railSpacing, +0.05f);
+        P3 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, -0.05f);
+        P4 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, +0.05f);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, -0.05f);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, +0.05f);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.2*railSpacing, -0.05f);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.2*railSpacing, +0.05f);
+
+        createQuad(c, list, P2, P1, P3, P4);
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.3*railSpacing, -0.05f);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.3*railSpacing, +0.05f);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, -0.05f);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, +0.05f);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.3*railSpacing, -0.05f);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.3*railSpacing, +0.05f);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, -0.05f);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, +0.05f);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, -0.07f);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, +0.07f);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, -0.07f);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, +0.07f);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -1.1*spineSize, -0.07f);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -1.1*spineSize, +0.07f);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), -1.1*spineSize, -0.07f);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), -1.1*spineSize, +0.07f);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = P5;
+        P2 = P6;
+        P3 = P7;
+        P4 = P8;
+        P5 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 1.1*spineSize, -0.07f);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 1.1*spineSize, +0.07f);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), 1.1*spineSize, -0.07f);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), 1.1*spineSize, +0.07f);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = P5;
+        P2 = P6;
+        P3 = P7;
+        P4 = P8;
+        P5 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, -0.07f);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, +0.07f);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, -0.07f);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, +0.07f);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, -0.07f);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, -0.07f);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, -0.07f);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, -0.07f);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, +0.07f);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, +0.07f);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, +0.07f);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, +0.07f);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        break;
+    case bm:
+        P1 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing, -0.05f*mysign);
+        P2 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing, 0.05f*mysign);
+        P3 = c.curNode->vRelPos(-trackData->fHeart, -railSpacing, -0.05f*mysign);
+        P4 = c.curNode->vRelPos(-trackData->fHeart, -railSpacing, 0.05f*mysign);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.3*spineSize, -0.05f*mysign);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.3*spineSize, 0.05f*mysign);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, -0.05f*mysign);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, 0.05f*mysign);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+
+        if(index%6 == 0)
+        {
+            P1 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize*1.3, -0.05f*mysign);
+            P2 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize*1.3, 0.05f*mysign);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, -0.71*spineSize*1.3, -0.05f*mysign);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, -0.71*spineSize*1.3, 0.05f*mysign);
+            P5 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize*1.3, -0.05f*mysign);
+            P6 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize*1.3, 0.05f*mysign);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, 0.71*spineSize*1.3, -0.05f*mysign);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, 0.71*spineSize*1.3, 0.05f*mysign);
+
+            createQuad(c, list, P2, P1, P3, P4);
+            createQuad(c, list, P5, P6, P8, P7);
+        }
+        else
+        {
+            P1 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize, -0.05f*mysign);
+            P2 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize, 0.05f*mysign);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, -0.05f*mysign);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, 0.05f*mysign);
+            P5 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize, -0.05f*mysign);
+            P6 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize, 0.05f*mysign);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, -0.05f*mysign);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, 0.05f*mysign);
+        }
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.3*spineSize, -0.05f*mysign);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.3*spineSize, 0.05f*mysign);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, -0.05f*mysign);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, 0.05f*mysign);
+        P5 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing, -0.05f*mysign);
+        P6 = c.curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing, 0.05f*mysign);
+        P7 = c.curNode->vRelPos(-trackData->fHeart, railSpacing, -0.05f*mysign);
+        P8 = c.curNode->vRelPos(-trackData->fHeart, railSpacing, 0.05f*mysign);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        break;
+    case triangle:
+        P1 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
+        P2 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
+        P5 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
+        P6 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        if(index && index%2)
+        {
+            P1 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
+            P2 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
+            P2 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        else if(index && index%2 == 0)
+        {
+            P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
+            P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+            P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
+            P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+            P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+
+        if(index)
+        {
+            P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P5 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P6 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        break;
+    case box:
+        P1 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
+        P2 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
+        P5 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
+        P6 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
+        P2 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
+        P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
+        P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        if(index && index%2)
+        {
+            P1 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P2 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P2 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
+            P2 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
+            P3 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
+            P4 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
+            P2 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        else if(index && (index%2 == 0))
+        {
+            P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P5 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P6 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        break;
+    case smallflat:
+        P1 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, -BOX_WIDTH);
+        P2 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, BOX_WIDTH);
+        P3 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, -BOX_WIDTH);
+        P4 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, BOX_WIDTH);
+        P5 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, -BOX_WIDTH);
+        P6 = c.curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, BOX_WIDTH);
+        P7 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, -BOX_WIDTH);
+        P8 = c.curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, BOX_WIDTH);
+
+        createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        break;
+    case doublespine:
+        if(index%2 == 0)
+        {
+            P1 = c.curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, -railSpacing, -0.12*spineHeight);
+            P2 = c.curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, -railSpacing, 0.12*spineHeight);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, -railSpacing, -0.12*spineHeight);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, -railSpacing, 0.12*spineHeight);
+            P5 = c.curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, railSpacing, -0.12*spineHeight);
+            P6 = c.curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, railSpacing, 0.12*spineHeight);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, railSpacing, -0.12*spineHeight);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, railSpacing, 0.12*spineHeight);
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = c.curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, -0.80*railSpacing, -0.10*spineHeight);
+            P2 = c.curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, -0.80*railSpacing, 0.10*spineHeight);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, -0.80*railSpacing, -0.10*spineHeight);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, -0.80*railSpacing, 0.10*spineHeight);
+            P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, -0.20*spineHeight);
+            P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, 0.20*spineHeight);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.10*spineHeight);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.10*spineHeight);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = c.curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, -0.20*spineHeight);
+            P2 = c.curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, 0.20*spineHeight);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.10*spineHeight);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.10*spineHeight);
+            P5 = c.curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, 0.80*railSpacing, -0.10*spineHeight);
+            P6 = c.curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, 0.80*railSpacing, 0.10*spineHeight);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, 0.80*railSpacing, -0.10*spineHeight);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, 0.80*railSpacing, 0.10*spineHeight);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        if((index+3)%4 == 0)
+        {
+            P1 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, -0.65*spineSize);
+            P2 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, 0.65*spineSize);
+            P3 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -0.65*spineSize, -0.65*spineSize);
+            P4 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -0.65*spineSize, 0.65*spineSize);
+            P5 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, 0.65*spineSize, -0.65*spineSize);
+            P6 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, 0.65*spineSize, 0.65*spineSize);
+            P7 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, -0.65*spineSize, -0.65*spineSize);
+            P8 = c.curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, -0.65*spineSize, 0.65*spineSize);
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        if((index+1)%4 == 0)
+        {
+            P1 = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, -0.65*spineSize);
+            P2 = P1;
+            P3 = P1;
+            P4 = P1;
+            P5 = P1;
+            P6 = P1;
+            P7 = P1;
+            P8 = P1;
+
+            createBox(c, list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(c, shadowList, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        break;
+    }
+}
+
+struct supportChunkBuilder {
+    trackMesh* mesh;
+    supportchunk_t* const* chunks;
+
+    void operator()(int, int from, int to) const {
+        for(int i = from; i < to; ++i)
+        {
+            supportchunk_t& chunk = *chunks[i];
+            meshcursor_t c;
+            c.nextNode = -1;    // outside of every selection range
+            for(int j = 0; j+1 < chunk.supList.size(); j+=2)
+            {
+                glm::vec3 P1 = chunk.supList.at(j);
+                glm::vec3 P2 = chunk.supList.at(j+1);
+
+                mesh->createSupport(c, chunk.vertices, chunk.shadows, 12, 0.2f, 0.2f, P1, P2, true);
+            }
+        }
+    }
+};
+
+#define CROSSTIE_CHUNK_SIZE 128
+
+// the node vectors are already detached by the selection loops on the calling thread, so
+// looking up nodes here never writes to shared data
+
+struct crosstieChunkBuilder {
+    trackMesh* mesh;
+    const QList<int>* posList;
+    const QList<int>* secList;
+    mnode* firstLastNode;
+    int offset;
+    float railSpacing, railWidth, spineHeight, spineSize;
+    QVector<tracknode_t>* ties;
+    QVector<meshnode_t>* shadows;
+
+    void operator()(int chunk, int from, int to) const {
+        track* trackData = mesh->trackData;
+
+        meshcursor_t c;
+        c.curNode = from ? &trackData->lSections[(*secList)[from-1]]->lNodes[(*posList)[from-1]] : firstLastNode;
+        for(int i = from; i < to; ++i)
+        {
+            mnode* lastNode = c.curNode;
+            c.secNode = (*posList)[i];
+            c.curSection = trackData->lSections[(*secList)[i]];
+            c.curNode = &c.curSection->lNodes[c.secNode];
+            c.nextNode = trackData->getNumPoints(c.curSection) + c.secNode;
+
+            mesh->createCrosstie(c, ties[chunk], shadows[chunk], lastNode, i+offset, railSpacing, railWidth, spineHeight, spineSize);
+        }
+    }
+};
+
 void trackMesh::buildMeshes(int fromNode)
 {
     if(glView->legacyMode) return;
 
     //rails.clear();
     //crossties.clear();
-    rendersupports.clear();
     supports.clear();
     //railshadows.clear();
     //crosstieshadows.clear();
     //heartline.clear();
-    supportshadows.clear();
-    pipeIndices.clear();
-    shadowIndices.clear();
 
-    posList.clear();
-    secList.clear();
+    QList<int> posList;
+    QList<int> secList;
 
     trackVertexSize = 0;
     supportsSize = 0;
@@ -1192,12 +1819,14 @@ void trackMesh::buildMeshes(int fromNode)
     float railWidth = 0.065f;
 
 
+    meshcursor_t c;
     mnode *lastNode = NULL;
-    curNode = NULL;
+    c.curNode = NULL;
 
     QElapsedTimer timer;
     double mSec;
     timer.start();
+    uploadedBytes = 0;
 
     switch(trackData->style)
     {
@@ -1260,22 +1889,46 @@ void trackMesh::buildMeshes(int fromNode)
         // delete obsolete railnodes
         int railNode;
 
-        if(rails.size() && fromNode >= rails.last().node)
+        if(gpuPipes)
         {
-            fromNode = rails.last().node-5;
-        }
+            rails.clear();
+            if(frames.size() && fromNode >= frames.last().node)
+            {
+                fromNode = (int)frames.last().node-5;
+            }
 
-        for(railNode = 0; railNode < rails.size() && rails[railNode].node < fromNode; ++railNode);
-        rails.remove(railNode, rails.size()-railNode);
+            for(railNode = 0; railNode < frames.size() && frames[railNode].node < fromNode; ++railNode);
+            frames.remove(railNode, frames.size()-railNode);
 
-        railNode = rails.size() ? rails.last().node : 0;
+            railNode = frames.size() ? (int)frames.last().node : 0;
 
-        if(railNode == 0)
+            if(railNode == 0)
+            {
+                frames.clear();
+            }
+            invalidateBuffer(bufferFrames, frames.size()*sizeof(pipeframe_t));
+        }
+        else
         {
-            rails.clear();
+            if(rails.size() && fromNode >= rails.last().node)
+            {
+                fromNode = rails.last().node-5;
+            }
+
+            for(railNode = 0; railNode < rails.size() && rails[railNode].node < fromNode; ++railNode);
+            rails.remove(railNode, rails.size()-railNode);
+
+            railNode = rails.size() ? rails.last().node : 0;
+
+            if(railNode == 0)
+            {
+                rails.clear();
+            }
+            invalidateBuffer(bufferRails, rails.size()*sizeof(tracknode_t));
         }
+        int lastRailNode = railNode ? railNode : -1;
 
-        int i;
+        int i, j;
 
         trackData->getSecNode(railNode, &j, &i);
 
@@ -1285,7 +1938,7 @@ void trackMesh::buildMeshes(int fromNode)
 
         for(; i < trackData->lSections.size(); i++)
         {
-            curSection = trackData->lSections[i];
+            section* curSection = trackData->lSections[i];
             for(; j < curSection->lNodes.size(); ++j)
             {
                 if(i != 0 && j == 1) distFromLastNode = 1.f;
@@ -1304,30 +1957,69 @@ void trackMesh::buildMeshes(int fromNode)
                     {
                         distFromLastNode = 0.f;
                     }
-                    if(rails.size() == 0 || rails.last().node != trackData->getNumPoints(curSection) + j)
+                    if(lastRailNode != trackData->getNumPoints(curSection) + j)
                     {
                         posList.append(j);
                         secList.append(i);
                     }
                 }
             }
-            for(j = 0; j < curSection->supList.size(); j+=2)
-            {
-                glm::vec3 P1 = curSection->supList[j];
-                glm::vec3 P2 = curSection->supList[j+1];
+            j = 0;
+        }
 
-                createSupport(rendersupports, 12, 0.2f, 0.2f, P1, P2, true);
-                supportsSize += 1;
+        // supports are cached per section, only chunks whose supports or ground changed are rebuilt
+        int firstDirty = supportChunks.size() > trackData->lSections.size() ? trackData->lSections.size() : -1;
+        while(supportChunks.size() > trackData->lSections.size()) supportChunks.removeLast();
+        while(supportChunks.size() < trackData->lSections.size())
+        {
+            supportchunk_t chunk;
+            chunk.ground = 0.f;
+            supportChunks.append(chunk);
+        }
 
-                //supportsSize += 3;
-                //nextPos = curSection->supList[j];
-                //appendMeshNode(supports);
+        QVector<int> supSections;
+        QVector<supportchunk_t*> dirtyChunks;
+        for(i = 0; i < trackData->lSections.size(); ++i)
+        {
+            supportchunk_t& chunk = supportChunks[i];
+            supportsSize += trackData->lSections[i]->supList.size()/2;
+            if(chunk.supList == trackData->lSections[i]->supList && chunk.ground == trackData->startPos.y) continue;
+
+            chunk.supList = trackData->lSections[i]->supList;
+            chunk.ground = trackData->startPos.y;
+            chunk.vertices.clear();
+            chunk.shadows.clear();
+            supSections.append(i);
+            dirtyChunks.append(&chunk);
+        }
+
+        supportChunkBuilder supBuilder;
+        supBuilder.mesh = this;
+        supBuilder.chunks = dirtyChunks.constData();
+        parallelChunks(dirtyChunks.size(), 1, supBuilder);
+
+        if(supSections.size() && (firstDirty < 0 || supSections[0] < firstDirty)) firstDirty = supSections[0];
+        if(firstDirty >= 0)
+        {
+            int vertices = 0, shadows = 0;
+            for(i = 0; i < firstDirty; ++i)
+            {
+                vertices += supportChunks[i].vertices.size();
+                shadows += supportChunks[i].shadows.size();
             }
-            j = 0;
+            rendersupports.resize(vertices);
+            supportshadows.resize(shadows);
+            for(i = firstDirty; i < supportChunks.size(); ++i)
+            {
+                rendersupports += supportChunks[i].vertices;
+                supportshadows += supportChunks[i].shadows;
+            }
+            invalidateBuffer(bufferSupports, vertices*sizeof(tracknode_t));
+            invalidateBuffer(bufferSupportShadows, shadows*sizeof(meshnode_t));
         }
 
         int jSize = posList.size();
-        rails.reserve(jSize*12);
+        if(!gpuPipes) rails.reserve(jSize*12);
         //railshadows.reserve(jSize*12*8);
         //qDebug("Generated Points: %d", jSize);
 
@@ -1336,22 +2028,24 @@ void trackMesh::buildMeshes(int fromNode)
 
         for(railNode = 0; railNode < railshadows.size() && railshadows[railNode].node < fromNode; ++railNode);
         railshadows.remove(railNode, railshadows.size()-railNode);
+        invalidateBuffer(bufferRailShadows, railshadows.size()*sizeof(meshnode_t));
 
         for(railNode = 0; railNode < heartline.size() && heartline[railNode].node < fromNode; ++railNode);
         heartline.remove(railNode, heartline.size()-railNode);
+        invalidateBuffer(bufferHeartline, heartline.size()*sizeof(meshnode_t));
 
         for(int i = 0; i < jSize; ++i)
         {
-            j = posList[i];
-            section* curSection = trackData->lSections[secList[i]];
-			curNode = &curSection->lNodes[j];
+            c.secNode = posList[i];
+            c.curSection = trackData->lSections[secList[i]];
+			c.curNode = &c.curSection->lNodes[c.secNode];
 
             heartlineSize += 1;
 
-            nextPos = curNode->vPos;
-            nextNode = trackData->getNumPoints(curSection) + j;
-            if(nodeList.isEmpty() || (nodeList.size() && nodeList.last() != nextNode)) nodeList.append(nextNode);
-            if(!heartline.size() || nextNode != heartline.last().node) appendMeshNode(heartline);
+            c.nextPos = c.curNode->vPos;
+            c.nextNode = trackData->getNumPoints(c.curSection) + c.secNode;
+            if(nodeList.isEmpty() || (nodeList.size() && nodeList.last() != c.nextNode)) nodeList.append(c.nextNode);
+            if(!heartline.size() || c.nextNode != heartline.last().node) appendMeshNode(c, heartline);
         }
 
         options.clear();
@@ -1414,10 +2108,20 @@ void trackMesh::buildMeshes(int fromNode)
             options.append(temp);
         }
 
-        createPipes(rails, options);
-
+        // tracks with more frames than the buffer texture holds go back to the cpu rings for good,
+        // those are built from the start so the whole mesh is built again
+        if(gpuPipes && frames.size()+posList.size() > maxPipeFrames())
+        {
+            gpuPipes = false;
+            frames.clear();
+            invalidateBuffer(bufferFrames, 0);
+            invalidateBuffer(bufferRails, 0);
+            buildMeshes(0);
+            return;
+        }
 
-        createIndices();
+        createPipes(rails, railshadows, options, posList, secList, !gpuPipes);
+        if(gpuPipes) createFrames(posList, secList);
 
         /*trackVertexSize += createPipe(rails, 12, railWidth, railWidth, -trackData->fHeart, -railSpacing);
         createPipe(rails, 12, railWidth, railWidth, -trackData->fHeart, railSpacing);
@@ -1455,10 +2159,10 @@ void trackMesh::buildMeshes(int fromNode)
 
         crossties.remove(iCrosstie, crossties.size()-iCrosstie);
         crosstieshadows.remove(iCrossShadow, crosstieshadows.size()-iCrossShadow);
+        invalidateBuffer(bufferCrossties, crossties.size()*sizeof(tracknode_t));
+        invalidateBuffer(bufferCrosstieShadows, crosstieshadows.size()*sizeof(meshnode_t));
 
 
-        curNode = NULL;
-
         posList.clear();
         secList.clear();
 
@@ -1510,610 +2214,33 @@ void trackMesh::buildMeshes(int fromNode)
             break;
         }
 
-        if(crossties.size()) curNode = trackData->getPoint(crossties.last().node);
-
-#define XS (0.06f)
-#define S (0.08f)
-#define M (0.10f)
-#define L (0.12f)
-#define XL (0.14f)
-#define XXL (0.16f)
-
-#define BOX_INWARD (0.14f)
-#define BOX_DIAG0 (0.08f)
-#define BOX_DIAG1 (0.18f)
-#define BOX_WIDTH (0.05f)
-
-
-        for(int i = 0; i < jSize; ++i)
+        // every crosstie only needs its own node and the one of the crosstie before it, so the
+        // crossties are built in independent chunks and appended in order
+        mnode* firstLastNode = crossties.size() ? trackData->getPoint(crossties.last().node) : NULL;
+        int numChunks = (jSize+CROSSTIE_CHUNK_SIZE-1)/CROSSTIE_CHUNK_SIZE;
+        QVector<QVector<tracknode_t> > tieChunks(numChunks);
+        QVector<QVector<meshnode_t> > tieShadowChunks(numChunks);
+
+        crosstieChunkBuilder tieBuilder;
+        tieBuilder.mesh = this;
+        tieBuilder.posList = &posList;
+        tieBuilder.secList = &secList;
+        tieBuilder.firstLastNode = firstLastNode;
+        tieBuilder.offset = offset;
+        tieBuilder.railSpacing = railSpacing;
+        tieBuilder.railWidth = railWidth;
+        tieBuilder.spineHeight = spineHeight;
+        tieBuilder.spineSize = spineSize;
+        tieBuilder.ties = tieChunks.data();
+        tieBuilder.shadows = tieShadowChunks.data();
+        parallelChunks(jSize, CROSSTIE_CHUNK_SIZE, tieBuilder);
+
+        for(i = 0; i < numChunks; ++i)
         {
-            int index = i+offset;
-            j = posList[i];
-            curSection = trackData->lSections[secList[i]];
-            lastNode = curNode;
-			curNode = &curSection->lNodes[j];
-            nextNode = trackData->getNumPoints(curSection) + j;
-
-            /* CROSSTIE GENERATION */
-            glm::vec3 P1, P2, P3, P4, P5, P6, P7, P8;
-            float mysign = fabs(spineHeight)/spineHeight;
-            switch(trackData->style)
-            {
-            case generic:
-                P1 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, -railSpacing, -0.15*spineHeight);
-                P2 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, -railSpacing, 0.15*spineHeight);
-                P3 = curNode->vRelPos(-trackData->fHeart, -railSpacing, -0.15*spineHeight);
-                P4 = curNode->vRelPos(-trackData->fHeart, -railSpacing, 0.15*spineHeight);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, -0.15f);//-0.35*spineHeight);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, 0.15f);//0.35*spineHeight);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.15f);// -0.15*spineHeight);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.15f);// 0.15*spineHeight);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, -0.15f);//-0.35*spineHeight);
-                P2 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, 0.15f);//0.35*spineHeight);
-                P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.15f);//, -0.15*spineHeight);
-                P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.15f);//, 0.15*spineHeight);
-                P5 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, railSpacing, -0.15*spineHeight);
-                P6 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, railSpacing, 0.15*spineHeight);
-                P7 = curNode->vRelPos(-trackData->fHeart, railSpacing, -0.15*spineHeight);
-                P8 = curNode->vRelPos(-trackData->fHeart, railSpacing, 0.15*spineHeight);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                break;
-            case genericflat:
-                if(index%6 == 0)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), -railSpacing, -M);
-                    P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), -railSpacing, M);
-                    P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), -railSpacing, -M);
-                    P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), -railSpacing, M);
-                    P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), railSpacing, -M);
-                    P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), railSpacing, M);
-                    P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), railSpacing, -M);
-                    P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), railSpacing, M);
-
-                }
-                else
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, -0.03);
-                    P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, 0.03);
-                    P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, -0.03);
-                    P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, 0.03);
-                    P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, -0.03);
-                    P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, 0.03);
-                    P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, -0.03);
-                    P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, 0.03);
-                }
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                if(index)
-                {
-                    P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing+0.13, 0.03);
-                    P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing+0.07, 0.03);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing+0.13, 0.03);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing+0.07, 0.03);
-                    P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing-0.07, -0.03);
-                    P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing-0.13, -0.03);
-                    P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing-0.07, -0.03);
-                    P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing-0.13, -0.03);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                break;
-            case vekoma:
-                P1 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -railSpacing-0.5*railWidth, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -railSpacing-0.5*railWidth, +0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing-0.5*railWidth, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing-0.5*railWidth, +0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.2*railSpacing, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.2*railSpacing, +0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, +0.05f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing+0.5*railWidth, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing+0.5*railWidth, +0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, railSpacing+0.5*railWidth, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, railSpacing+0.5*railWidth, +0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, +0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.2*railSpacing, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.2*railSpacing, +0.05f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-
-                P1 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, +0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.3*railSpacing, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.3*railSpacing, +0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.2*railSpacing, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.2*railSpacing, +0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, +0.05f);
-
-                createQuad(crossties, P2, P1, P3, P4);
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.3*railSpacing, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.3*railSpacing, +0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, +0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, +0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.2*railSpacing, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.2*railSpacing, +0.05f);
-
-                createQuad(crossties, P2, P1, P3, P4);
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.3*railSpacing, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.3*railSpacing, +0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, +0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.3*railSpacing, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.3*railSpacing, +0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, +0.05f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, -0.07f);
-                P2 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, +0.07f);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, -0.07f);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, +0.07f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -1.1*spineSize, -0.07f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -1.1*spineSize, +0.07f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), -1.1*spineSize, -0.07f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), -1.1*spineSize, +0.07f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = P5;
-                P2 = P6;
-                P3 = P7;
-                P4 = P8;
-                P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 1.1*spineSize, -0.07f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 1.1*spineSize, +0.07f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), 1.1*spineSize, -0.07f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), 1.1*spineSize, +0.07f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = P5;
-                P2 = P6;
-                P3 = P7;
-                P4 = P8;
-                P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, -0.07f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, +0.07f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, -0.07f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, +0.07f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-
-                P1 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, -0.07f);
-                P2 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, -0.07f);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, -0.07f);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, -0.07f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, +0.07f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, +0.07f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, +0.07f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, +0.07f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                break;
-            case bm:
-                P1 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing, -0.05f*mysign);
-                P2 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing, 0.05f*mysign);
-                P3 = curNode->vRelPos(-trackData->fHeart, -railSpacing, -0.05f*mysign);
-                P4 = curNode->vRelPos(-trackData->fHeart, -railSpacing, 0.05f*mysign);
-                P5 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.3*spineSize, -0.05f*mysign);
-                P6 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.3*spineSize, 0.05f*mysign);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, -0.05f*mysign);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, 0.05f*mysign);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-
-                if(index%6 == 0)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize*1.3, -0.05f*mysign);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize*1.3, 0.05f*mysign);
-                    P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, -0.71*spineSize*1.3, -0.05f*mysign);
-                    P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, -0.71*spineSize*1.3, 0.05f*mysign);
-                    P5 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize*1.3, -0.05f*mysign);
-                    P6 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize*1.3, 0.05f*mysign);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, 0.71*spineSize*1.3, -0.05f*mysign);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, 0.71*spineSize*1.3, 0.05f*mysign);
-
-                    createQuad(crossties, P2, P1, P3, P4);
-                    createQuad(crossties, P5, P6, P8, P7);
-                }
-                else
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize, -0.05f*mysign);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize, 0.05f*mysign);
-                    P3 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, -0.05f*mysign);
-                    P4 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, 0.05f*mysign);
-                    P5 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize, -0.05f*mysign);
-                    P6 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize, 0.05f*mysign);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, -0.05f*mysign);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, 0.05f*mysign);
-                }
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.3*spineSize, -0.05f*mysign);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.3*spineSize, 0.05f*mysign);
-                P3 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, -0.05f*mysign);
-                P4 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, 0.05f*mysign);
-                P5 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing, -0.05f*mysign);
-                P6 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing, 0.05f*mysign);
-                P7 = curNode->vRelPos(-trackData->fHeart, railSpacing, -0.05f*mysign);
-                P8 = curNode->vRelPos(-trackData->fHeart, railSpacing, 0.05f*mysign);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                break;
-            case triangle:
-                P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                if(index && index%2)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                else if(index && index%2 == 0)
-                {
-                    P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-
-                if(index)
-                {
-                    P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                break;
-            case box:
-                P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                if(index && index%2)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                else if(index && (index%2 == 0))
-                {
-                    P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                break;
-            case smallflat:
-                P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                break;
-            case doublespine:
-                if(index%2 == 0)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, -railSpacing, -0.12*spineHeight);
-                    P2 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, -railSpacing, 0.12*spineHeight);
-                    P3 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, -railSpacing, -0.12*spineHeight);
-                    P4 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, -railSpacing, 0.12*spineHeight);
-                    P5 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, railSpacing, -0.12*spineHeight);
-                    P6 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, railSpacing, 0.12*spineHeight);
-                    P7 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, railSpacing, -0.12*spineHeight);
-                    P8 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, railSpacing, 0.12*spineHeight);
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, -0.80*railSpacing, -0.10*spineHeight);
-                    P2 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, -0.80*railSpacing, 0.10*spineHeight);
-                    P3 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, -0.80*railSpacing, -0.10*spineHeight);
-                    P4 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, -0.80*railSpacing, 0.10*spineHeight);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, -0.20*spineHeight);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, 0.20*spineHeight);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.10*spineHeight);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.10*spineHeight);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, -0.20*spineHeight);
-                    P2 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, 0.20*spineHeight);
-                    P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.10*spineHeight);
-                    P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.10*spineHeight);
-                    P5 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, 0.80*railSpacing, -0.10*spineHeight);
-                    P6 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, 0.80*railSpacing, 0.10*spineHeight);
-                    P7 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, 0.80*railSpacing, -0.10*spineHeight);
-                    P8 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, 0.80*railSpacing, 0.10*spineHeight);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                if((index+3)%4 == 0)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, -0.65*spineSize);
-                    P2 = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, 0.65*spineSize);
-                    P3 = curNode->vRelPos(-trackData->fHeart-spineHeight, -0.65*spineSize, -0.65*spineSize);
-                    P4 = curNode->vRelPos(-trackData->fHeart-spineHeight, -0.65*spineSize, 0.65*spineSize);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, 0.65*spineSize, -0.65*spineSize);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, 0.65*spineSize, 0.65*spineSize);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, -0.65*spineSize, -0.65*spineSize);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, -0.65*spineSize, 0.65*spineSize);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                if((index+1)%4 == 0)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, -0.65*spineSize);
-                    P2 = P1;
-                    P3 = P1;
-                    P4 = P1;
-                    P5 = P1;
-                    P6 = P1;
-                    P7 = P1;
-                    P8 = P1;
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                break;
-            }
+            crossties += tieChunks[i];
+            crosstieshadows += tieShadowChunks[i];
         }
-        mSec = timer.nsecsElapsed()/1000000.;
-        gloParent->showMessage(QString::number(mSec).append(QString("ms used to build meshes")), 3000);
+
     }
     else // wireframe
     {
@@ -2128,10 +2255,18 @@ void trackMesh::buildMeshes(int fromNode)
 
         for(railNode = 0; railNode < rails.size() && rails[railNode].node < fromNode; ++railNode);
         rails.remove(railNode, rails.size()-railNode);
+        invalidateBuffer(bufferRails, rails.size()*sizeof(tracknode_t));
+
+        // wireframe supports are plain lines, the cached solid ones are dropped
+        rendersupports.clear();
+        supportshadows.clear();
+        supportChunks.clear();
+        invalidateBuffer(bufferSupports, 0);
+        invalidateBuffer(bufferSupportShadows, 0);
 
         railNode = rails.size() ? rails.last().node : 0;
 
-        int i;
+        int i, j;
 
         trackData->getSecNode(railNode, &j, &i);
 
@@ -2140,7 +2275,7 @@ void trackMesh::buildMeshes(int fromNode)
 
         for(; i < trackData->lSections.size(); i++)
         {
-            curSection = trackData->lSections[i];
+            section* curSection = trackData->lSections[i];
             for(; j < curSection->lNodes.size(); ++j)
             {
                 if(i != 0 && j == 1) distFromLastNode = 1.f;
@@ -2169,12 +2304,12 @@ void trackMesh::buildMeshes(int fromNode)
                 glm::vec3 P1 = curSection->supList[j];
                 glm::vec3 P2 = curSection->supList[j+1];
 
-                nextNorm = glm::vec3(0, 0.5, 0);
-                nextNode = 0;
-                nextPos = P1;
-                appendSupportNode(rendersupports);
-                nextPos = P2;
-                appendSupportNode(rendersupports);
+                c.nextNorm = glm::vec3(0, 0.5, 0);
+                c.nextNode = -1;
+                c.nextPos = P1;
+                appendSupportNode(c, rendersupports);
+                c.nextPos = P2;
+                appendSupportNode(c, rendersupports);
                 //createSupport(rendersupports, 12, 0.2f, 0.2f, P1, P2, true);
                 supportsSize += 1;
 
@@ -2186,19 +2321,20 @@ void trackMesh::buildMeshes(int fromNode)
 
         for(railNode = 0; railNode < heartline.size() && heartline[railNode].node < fromNode; ++railNode);
         heartline.remove(railNode, heartline.size()-railNode);
+        invalidateBuffer(bufferHeartline, heartline.size()*sizeof(meshnode_t));
 
         for(int i = 0; i < posList.size(); ++i)
         {
-            j = posList[i];
-            section* curSection = trackData->lSections[secList[i]];
-			curNode = &curSection->lNodes[j];
+            c.secNode = posList[i];
+            c.curSection = trackData->lSections[secList[i]];
+			c.curNode = &c.curSection->lNodes[c.secNode];
 
             heartlineSize += 1;
 
-            nextPos = curNode->vPos;
-            nextNode = trackData->getNumPoints(curSection) + j;
-            if(!heartline.size() || nextNode != heartline.last().node) appendMeshNode(heartline);
-            if(nodeList.isEmpty() || (nodeList.size() && nodeList.last() != nextNode)) nodeList.append(nextNode);
+            c.nextPos = c.curNode->vPos;
+            c.nextNode = trackData->getNumPoints(c.curSection) + c.secNode;
+            if(!heartline.size() || c.nextNode != heartline.last().node) appendMeshNode(c, heartline);
+            if(nodeList.isEmpty() || (nodeList.size() && nodeList.last() != c.nextNode)) nodeList.append(c.nextNode);
         }
 
 
@@ -2206,19 +2342,19 @@ void trackMesh::buildMeshes(int fromNode)
 
         for(int i = 0; i < posList.size(); ++i)
         {
-            j = posList[i];
-            curSection = trackData->lSections[secList[i]];
-			curNode = &curSection->lNodes[j];
+            c.secNode = posList[i];
+            c.curSection = trackData->lSections[secList[i]];
+			c.curNode = &c.curSection->lNodes[c.secNode];
 
-            nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
-            nextNorm = glm::vec3(0, 0.5, 0);
-            nextNode = trackData->getNumPoints(curSection) + j;
+            c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing);
+            c.nextNorm = glm::vec3(0, 0.5, 0);
+            c.nextNode = trackData->getNumPoints(c.curSection) + c.secNode;
 
             //nextPos.y = -trackData->startPos.y;
-            appendTrackNode(rails);
-            nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing);
+            appendTrackNode(c, rails);
+            c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing);
             //nextPos.y = -trackData->startPos.y;
-            appendTrackNode(rails);
+            appendTrackNode(c, rails);
 
             switch(trackData->style)
             {
@@ -2226,26 +2362,26 @@ void trackMesh::buildMeshes(int fromNode)
             case vekoma:
             case bm:
             case triangle:
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
                 //nextPos.y = -trackData->startPos.y;
-                appendTrackNode(rails);
+                appendTrackNode(c, rails);
                 break;
             case box:
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing);
                 //nextPos.y = -trackData->startPos.y;
-                appendTrackNode(rails);
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing);
+                appendTrackNode(c, rails);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing);
                 //nextPos.y = -trackData->startPos.y;
-                appendTrackNode(rails);
+                appendTrackNode(c, rails);
                 break;
             case genericflat:
             case smallflat:
                 break;
             case doublespine:
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
-                appendTrackNode(rails);
-                nextPos = curNode->vRelPos(-trackData->fHeart-0.45f-spineHeight, 0);
-                appendTrackNode(rails);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
+                appendTrackNode(c, rails);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-0.45f-spineHeight, 0);
+                appendTrackNode(c, rails);
                 break;
             }
         }
@@ -2261,9 +2397,11 @@ void trackMesh::buildMeshes(int fromNode)
 
         crossties.remove(iCrosstie, crossties.size()-iCrosstie);
         crosstieshadows.remove(iCrossShadow, crosstieshadows.size()-iCrossShadow);
+        invalidateBuffer(bufferCrossties, crossties.size()*sizeof(tracknode_t));
+        invalidateBuffer(bufferCrosstieShadows, crosstieshadows.size()*sizeof(meshnode_t));
 
 
-        curNode = NULL;
+        c.curNode = NULL;
 
         posList.clear();
         secList.clear();
@@ -2314,241 +2452,241 @@ void trackMesh::buildMeshes(int fromNode)
             break;
         }
 
-        if(crossties.size()) curNode = trackData->getPoint(crossties.last().node);
+        if(crossties.size()) c.curNode = trackData->getPoint(crossties.last().node);
 
         for(int i = 0; i < posList.size(); ++i)
         {
             int index = i+offset;
-            j = posList[i];
-            curSection = trackData->lSections[secList[i]];
-            lastNode = curNode;
-			curNode = &curSection->lNodes[j];
+            c.secNode = posList[i];
+            c.curSection = trackData->lSections[secList[i]];
+            lastNode = c.curNode;
+			c.curNode = &c.curSection->lNodes[c.secNode];
 
-            nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
-            nextNorm = glm::vec3(0, 0.5, 0);
-            nextNode = trackData->getNumPoints(curSection) + j;
+            c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing);
+            c.nextNorm = glm::vec3(0, 0.5, 0);
+            c.nextNode = trackData->getNumPoints(c.curSection) + c.secNode;
 
             switch(trackData->style)
             {
             case generic:
-                nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
-                appendTrackNode(crossties);
-
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing);
-                appendTrackNode(crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
+                appendTrackNode(c, crossties);
+
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing);
+                appendTrackNode(c, crossties);
                 break;
             case genericflat:
-                nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing);
-                appendTrackNode(crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing);
+                appendTrackNode(c, crossties);
 
                 if(index)
                 {
-                    nextPos = lastNode->vRelPos(-trackData->fHeart, -railSpacing+0.1f);
-                    appendTrackNode(crossties);
-                    nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing-0.1f);
-                    appendTrackNode(crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart, -railSpacing+0.1f);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing-0.1f);
+                    appendTrackNode(c, crossties);
                 }
                 break;
             case vekoma:
-                nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing-0.1f);
-                appendTrackNode(crossties);
-
-                nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing-0.1f);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing-0.1f);
-                appendTrackNode(crossties);
-
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing-0.1f);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing+0.1f);
-                appendTrackNode(crossties);
-
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing+0.1f);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing+0.1f);
-                appendTrackNode(crossties);
-
-                nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing+0.1f);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing);
-                appendTrackNode(crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing-0.1f);
+                appendTrackNode(c, crossties);
+
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing-0.1f);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing-0.1f);
+                appendTrackNode(c, crossties);
+
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing-0.1f);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing+0.1f);
+                appendTrackNode(c, crossties);
+
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing+0.1f);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing+0.1f);
+                appendTrackNode(c, crossties);
+
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing+0.1f);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing);
+                appendTrackNode(c, crossties);
                 break;
             case bm:
-                nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing/3);
-                appendTrackNode(crossties);
-
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing/3);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing/3);
-                appendTrackNode(crossties);
-
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing/3);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing);
-                appendTrackNode(crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing/3);
+                appendTrackNode(c, crossties);
+
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing/3);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing/3);
+                appendTrackNode(c, crossties);
+
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing/3);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing);
+                appendTrackNode(c, crossties);
                 break;
             case triangle:
-                nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
-                appendTrackNode(crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
+                appendTrackNode(c, crossties);
 
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing-BOX_INWARD);
-                appendTrackNode(crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing-BOX_INWARD);
+                appendTrackNode(c, crossties);
 
-                nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing);
-                appendTrackNode(crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing);
+                appendTrackNode(c, crossties);
 
                 if(index && index%2)
                 {
-                    nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, 0);
-                    appendTrackNode(crossties);
-
-                    nextPos = curNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, 0);
-                    appendTrackNode(crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, 0);
+                    appendTrackNode(c, crossties);
+
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, 0);
+                    appendTrackNode(c, crossties);
                 }
                 else if(index && index%2 == 0)
                 {
-                    nextPos = lastNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
-                    appendTrackNode(crossties);
-
-                    nextPos = lastNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
-                    appendTrackNode(crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
+                    appendTrackNode(c, crossties);
+
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0);
+                    appendTrackNode(c, crossties);
                 }
 
                 if(index)
                 {
-                    nextPos = lastNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = curNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
-                    appendTrackNode(crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
+                    appendTrackNode(c, crossties);
                 }
                 break;
             case box:
-                nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing+BOX_INWARD);
-                appendTrackNode(crossties);
-
-                nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing-BOX_INWARD);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing-BOX_INWARD);
-                appendTrackNode(crossties);
-
-                nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing);
-                appendTrackNode(crossties);
-
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing);
-                appendTrackNode(crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing+BOX_INWARD);
+                appendTrackNode(c, crossties);
+
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing-BOX_INWARD);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing-BOX_INWARD);
+                appendTrackNode(c, crossties);
+
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing);
+                appendTrackNode(c, crossties);
+
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, railSpacing);
+                appendTrackNode(c, crossties);
 
                 if(index && index%2)
                 {
-                    nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing+BOX_INWARD);
-                    appendTrackNode(crossties);
-
-                    nextPos = curNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, +railSpacing-BOX_INWARD);
-                    appendTrackNode(crossties);
-
-                    nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = lastNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
-                    appendTrackNode(crossties);
-
-                    nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing+BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, +railSpacing-BOX_INWARD);
-                    appendTrackNode(crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing+BOX_INWARD);
+                    appendTrackNode(c, crossties);
+
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, +railSpacing-BOX_INWARD);
+                    appendTrackNode(c, crossties);
+
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
+                    appendTrackNode(c, crossties);
+
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing+BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, +railSpacing-BOX_INWARD);
+                    appendTrackNode(c, crossties);
                 }
                 else if(index && index%2 == 0)
                 {
-                    nextPos = lastNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing+BOX_INWARD);
-                    appendTrackNode(crossties);
-
-                    nextPos = lastNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, +railSpacing-BOX_INWARD);
-                    appendTrackNode(crossties);
-
-                    nextPos = curNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = lastNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
-                    appendTrackNode(crossties);
-
-                    nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, +railSpacing-BOX_INWARD);
-                    appendTrackNode(crossties);
-                    nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing+BOX_INWARD);
-                    appendTrackNode(crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing+BOX_INWARD);
+                    appendTrackNode(c, crossties);
+
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, +railSpacing-BOX_INWARD);
+                    appendTrackNode(c, crossties);
+
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, +railSpacing-BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart, -railSpacing+BOX_INWARD);
+                    appendTrackNode(c, crossties);
+
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, +railSpacing-BOX_INWARD);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = lastNode->vRelPos(-trackData->fHeart-spineHeight, -railSpacing+BOX_INWARD);
+                    appendTrackNode(c, crossties);
                 }
                 break;
             case smallflat:
-                nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
-                appendTrackNode(crossties);
-                nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing);
-                appendTrackNode(crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing);
+                appendTrackNode(c, crossties);
+                c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing);
+                appendTrackNode(c, crossties);
                 break;
             case doublespine:
                 if(index%2 == 0)
                 {
-                    nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
-                    appendTrackNode(crossties);
-                    nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing, 0.f);
-                    appendTrackNode(crossties);
-
-                    nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
-                    appendTrackNode(crossties);
-                    nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.f);
-                    appendTrackNode(crossties);
-
-                    nextPos = curNode->vRelPos(-trackData->fHeart, railSpacing);
-                    appendTrackNode(crossties);
-                    nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.f);
-                    appendTrackNode(crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing, 0.f);
+                    appendTrackNode(c, crossties);
+
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, -railSpacing);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0.f);
+                    appendTrackNode(c, crossties);
+
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart, railSpacing);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0.f);
+                    appendTrackNode(c, crossties);
                 }
                 if((index+3)%4 == 0)
                 {
-                    nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.f);
-                    appendTrackNode(crossties);
-                    nextPos = curNode->vRelPos(-trackData->fHeart-0.45f-spineHeight, 0.f);
-                    appendTrackNode(crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0.f);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-0.45f-spineHeight, 0.f);
+                    appendTrackNode(c, crossties);
                 }
                 if((index+1)%4 == 0)
                 {
-                    nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.f);
-                    appendTrackNode(crossties);
-                    nextPos = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.f);
-                    appendTrackNode(crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0.f);
+                    appendTrackNode(c, crossties);
+                    c.nextPos = c.curNode->vRelPos(-trackData->fHeart-spineHeight, 0.f);
+                    appendTrackNode(c, crossties);
                 }
                 break;
             }
@@ -2556,20 +2694,28 @@ void trackMesh::buildMeshes(int fromNode)
     }
     createIndices();
     updateVertexArrays();
+
+    // counts everything sent for this build, only the buffers behind the first change are uploaded
+    mSec = timer.nsecsElapsed()/1000000.;
+    gloParent->showMessage(QString("%1ms used to build meshes, %2 kB uploaded").arg(mSec).arg(uploadedBytes/1024), 3000);
     return;
 }
 
-void trackMesh::build3ds(const int _sec, QVector<float> *_vertices, QVector<unsigned int> *_indices, QVector<unsigned int> *_borders)
+// all scratch state is local and options/numRails shadow the members, so several sections can be built at once
+void trackMesh::build3ds(const int _sec, const int _quality, QVector<float> *_vertices, QVector<unsigned int> *_indices, QVector<unsigned int> *_borders)
 {
-    posList.clear();
-    secList.clear();
+    QList<int> posList, secList;
+    QList<pipeoption_t> options;
+    int j, numRails;
+    mnode* curNode;
+    section* curSection;
 
     _borders->append(_vertices->size());
     _borders->append(_indices->size());
 
     float crosstieSpacing = 0.f;
     float meshQuality;
-    switch(gloParent->mOptions->meshQuality)
+    switch(_quality)
     {
     case 0:
         meshQuality = 1;
@@ -2742,7 +2888,7 @@ void trackMesh::build3ds(const int _sec, QVector<float> *_vertices, QVector<unsi
         options.append(temp);
     }
 
-    create3dsPipes(_vertices, options);
+    create3dsPipes(_vertices, options, posList, secList);
 
 
     int edgeCount = 0;
@@ -2850,7 +2996,6 @@ void trackMesh::build3ds(const int _sec, QVector<float> *_vertices, QVector<unsi
         curSection = trackData->lSections[secList[i]];
         lastNode = curNode;
 		curNode = &curSection->lNodes[j];
-        nextNode = trackData->getNumPoints(curSection) + j;
 
         glm::vec3 P1, P2, P3, P4, P5, P6, P7, P8;
         float mysign = fabs(spineHeight)/spineHeight;
@@ -3383,51 +3528,141 @@ void trackMesh::build3ds(const int _sec, QVector<float> *_vertices, QVector<unsi
     return;
 }
 
+// the vertices carry their node index, so a selection change only has to find the node ranges
+// the track shader compares against instead of touching the vertex buffers
 void trackMesh::recolorTrack()
 {
-    if(trackData->lSections.size() == 0) return;
-
-    for(int i = 0; i < rails.size(); ++i)
-    {       
-        int node = rails[i].node;
-        int section;
-        trackData->getSecNode(node, &node, &section);
+    selectionRange = glm::vec4(-1.f, -2.f, -1.f, -2.f);
+    section* curSection = trackData->activeSection;
+    if(trackData != gloParent->curTrack() || trackData->getSectionNumber(curSection) == -1) return;
 
-        curSection = trackData->lSections[section];
+    int offset = trackData->getNumPoints(curSection);
+    int last = curSection->lNodes.size()-1;
+    selectionRange.x = offset;
+    selectionRange.y = offset+last;
 
-        rails[i].selected = (trackData == gloParent->curTrack() && curSection == trackData->activeSection) ? (curSection->isInFunction(node, gloParent->selectedFunc) ? 2.f : 1.f) : 0.f;
+    int from, to;
+    curSection->getFunctionRange(gloParent->selectedFunc, from, to);
+    if(from <= last)
+    {
+        selectionRange.z = offset+from;
+        selectionRange.w = offset+to;
     }
+}
+
+// everything in front of the first changed byte is kept on the gpu, buffers grow with some headroom
+// so that extending the track does not reallocate them on every edit
+void trackMesh::invalidateBuffer(int buffer, int bytes)
+{
+    if(bytes < bufferClean[buffer]) bufferClean[buffer] = bytes;
+}
 
-    for(int i = 0; i < crossties.size(); ++i)
+void trackMesh::uploadBuffer(int buffer, GLenum target, const void* data, int bytes)
+{
+    if(bytes > bufferCapacity[buffer])
+    {
+        bufferCapacity[buffer] = bytes + bytes/4;
+        glBufferData(target, bufferCapacity[buffer], NULL, GL_DYNAMIC_DRAW);
+        bufferClean[buffer] = 0;
+    }
+    if(bytes > bufferClean[buffer])
     {
-        int node = crossties[i].node;
-        int section;
-        trackData->getSecNode(node, &node, &section);
+        glBufferSubData(target, bufferClean[buffer], bytes-bufferClean[buffer], (const char*)data+bufferClean[buffer]);
+        uploadedBytes += bytes-bufferClean[buffer];
+    }
+    bufferClean[buffer] = bytes;
+}
 
-        curSection = trackData->lSections[section];
+#define MAX_PIPES 8
 
-        crossties[i].selected = (trackData == gloParent->curTrack() && curSection == trackData->activeSection) ? (curSection->isInFunction(node, gloParent->selectedFunc) ? 2.f : 1.f) : 0.f;
-    }
-    updateVertexArrays();
+// the pipe shader writes the same vertices createPipes() builds straight into the rail buffer with
+// transform feedback, so every shader drawing the rails keeps reading plain tracknode_t vertices.
+// only the rings behind the first changed frame and the end caps are extruded again
+void trackMesh::extrudePipes()
+{
+    int pipeCount = qMin(options.size(), MAX_PIPES);
+    int frameCount = frames.size();
+    int edgeCount = 0;
+    GLint edges[MAX_PIPES];
+    glm::vec4 profile[MAX_PIPES];
+    for(int p = 0; p < pipeCount; ++p)
+    {
+        edges[p] = options[p].edges*(options[p].smooth ? 1 : -1);
+        profile[p] = glm::vec4(options[p].radius, options[p].offset);
+        edgeCount += options[p].edges;
+    }
+    int vertices = frameCount ? 2*pipeCount + edgeCount*frameCount : 0;
+
+    int cleanFrames = bufferClean[bufferFrames]/sizeof(pipeframe_t);
+    int cleanVertices = bufferClean[bufferRails]/sizeof(tracknode_t);
+    cleanFrames = cleanVertices > pipeCount && edgeCount ? qMin(cleanFrames, (cleanVertices-pipeCount)/edgeCount) : 0;
+
+    glBindBuffer(GL_TEXTURE_BUFFER, PipeBuffer[0]);
+    uploadBuffer(bufferFrames, GL_TEXTURE_BUFFER, frames.constData(), frameCount*sizeof(pipeframe_t));
+    if(frameTexture == NULL && frameCount) frameTexture = new myTexture(PipeBuffer[0], GL_RGBA32F);
+
+    int bytes = vertices*sizeof(tracknode_t);
+    glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[0]);
+    if(bytes > bufferCapacity[bufferRails])
+    {
+        bufferCapacity[bufferRails] = bytes + bytes/4;
+        glBufferData(GL_ARRAY_BUFFER, bufferCapacity[bufferRails], NULL, GL_DYNAMIC_DRAW);
+        cleanFrames = 0;
+    }
+    bufferClean[bufferRails] = bytes;
+
+    int first = cleanFrames ? pipeCount + edgeCount*cleanFrames : 0;
+    if(first >= vertices) return;
+
+    myShader* shader = glView->pipeShader;
+    shader->bind();
+    shader->useUniform("frames", frameTexture->getId());
+    shader->useUniform("frameCount", (GLuint)frameCount);
+    shader->useUniform("pipeCount", (GLuint)pipeCount);
+    shader->useUniform("edgeCount", (GLuint)edgeCount);
+    shader->useUniform("edges", pipeCount, edges);
+    shader->useUniform("profile", pipeCount, profile);
+
+    // the pipe vao has no attributes, the shader only needs gl_VertexID
+    glBindVertexArray(PipeObject[0]);
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, TrackBuffer[0], first*sizeof(tracknode_t), (vertices-first)*sizeof(tracknode_t));
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, first, vertices-first);
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+}
+
+static int commonPrefix(const QVector<int>& a, const QVector<int>& b)
+{
+    int n = qMin(a.size(), b.size());
+    const int* pa = a.constData();
+    const int* pb = b.constData();
+    int i = 0;
+    while(i < n && pa[i] == pb[i]) ++i;
+    return i;
 }
 
 void trackMesh::updateVertexArrays()
 {
     if(!glView->legacyMode)
     {
+    if(gpuPipes && !isWireframe) extrudePipes();
+
     glBindVertexArray(TrackObject[0]);
 
     glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[0]);  // Spine
-    glBufferData(GL_ARRAY_BUFFER, rails.size()*sizeof(tracknode_t), rails.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), 0);
-    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(3*sizeof(float)));
-    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(6*sizeof(float)));
-    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(8*sizeof(float)));
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(9*sizeof(float)));
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(10*sizeof(float)));
-    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(11*sizeof(float)));
-    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(12*sizeof(float)));
-    glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(13*sizeof(float)));
+    if(!gpuPipes || isWireframe) uploadBuffer(bufferRails, GL_ARRAY_BUFFER, rails.constData(), rails.size()*sizeof(tracknode_t));
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, pos));
+    glVertexAttribPointer(7, 2, GL_SHORT, GL_TRUE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, normal));
+    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, uv));
+    glVertexAttribPointer(1, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, vel));
+    glVertexAttribPointer(2, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, rollSpeed));
+    glVertexAttribPointer(3, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, yForce));
+    glVertexAttribPointer(4, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, xForce));
+    glVertexAttribPointer(5, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, flexion));
+    glVertexAttribPointer(6, 1, GL_INT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, node));
     glEnableVertexAttribArray(0);
     glEnableVertexAttribArray(1);
     glEnableVertexAttribArray(2);
@@ -3439,22 +3674,22 @@ void trackMesh::updateVertexArrays()
     glEnableVertexAttribArray(8);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, TrackIndices[0]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, pipeIndices.size()*sizeof(int), pipeIndices.data(), GL_STATIC_DRAW);
+    uploadBuffer(bufferRailIndices, GL_ELEMENT_ARRAY_BUFFER, pipeIndices.constData(), pipeIndices.size()*sizeof(int));
 
 
     glBindVertexArray(TrackObject[3]);
 
     glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[3]);  // Crossties
-    glBufferData(GL_ARRAY_BUFFER, crossties.size()*sizeof(tracknode_t), crossties.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), 0);
-    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(3*sizeof(float)));
-    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(6*sizeof(float)));
-    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(8*sizeof(float)));
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(9*sizeof(float)));
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(10*sizeof(float)));
-    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(11*sizeof(float)));
-    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(12*sizeof(float)));
-    glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(13*sizeof(float)));
+    uploadBuffer(bufferCrossties, GL_ARRAY_BUFFER, crossties.constData(), crossties.size()*sizeof(tracknode_t));
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, pos));
+    glVertexAttribPointer(7, 2, GL_SHORT, GL_TRUE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, normal));
+    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, uv));
+    glVertexAttribPointer(1, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, vel));
+    glVertexAttribPointer(2, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, rollSpeed));
+    glVertexAttribPointer(3, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, yForce));
+    glVertexAttribPointer(4, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, xForce));
+    glVertexAttribPointer(5, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, flexion));
+    glVertexAttribPointer(6, 1, GL_INT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, node));
     glEnableVertexAttribArray(0);
     glEnableVertexAttribArray(1);
     glEnableVertexAttribArray(2);
@@ -3469,16 +3704,16 @@ void trackMesh::updateVertexArrays()
     glBindVertexArray(TrackObject[4]);
 
     glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[6]);  // Supports
-    glBufferData(GL_ARRAY_BUFFER, rendersupports.size()*sizeof(tracknode_t), rendersupports.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), 0);
-    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(3*sizeof(float)));
-    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(6*sizeof(float)));
-    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(8*sizeof(float)));
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(9*sizeof(float)));
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(10*sizeof(float)));
-    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(11*sizeof(float)));
-    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(12*sizeof(float)));
-    glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(13*sizeof(float)));
+    uploadBuffer(bufferSupports, GL_ARRAY_BUFFER, rendersupports.constData(), rendersupports.size()*sizeof(tracknode_t));
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, pos));
+    glVertexAttribPointer(7, 2, GL_SHORT, GL_TRUE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, normal));
+    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, uv));
+    glVertexAttribPointer(1, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, vel));
+    glVertexAttribPointer(2, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, rollSpeed));
+    glVertexAttribPointer(3, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, yForce));
+    glVertexAttribPointer(4, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, xForce));
+    glVertexAttribPointer(5, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, flexion));
+    glVertexAttribPointer(6, 1, GL_INT, GL_FALSE, sizeof(tracknode_t), (void*)offsetof(tracknode_t, node));
     glEnableVertexAttribArray(0);
     glEnableVertexAttribArray(1);
     glEnableVertexAttribArray(2);
@@ -3493,31 +3728,31 @@ void trackMesh::updateVertexArrays()
     glBindVertexArray(HeartObject[0]);
 
     glBindBuffer(GL_ARRAY_BUFFER, HeartBuffer[0]);  // Heartline
-    glBufferData(GL_ARRAY_BUFFER, heartline.size()*sizeof(meshnode_t), heartline.data(), GL_STATIC_DRAW);
+    uploadBuffer(bufferHeartline, GL_ARRAY_BUFFER, heartline.constData(), heartline.size()*sizeof(meshnode_t));
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4*sizeof(float), 0);
     glEnableVertexAttribArray(0);
 
     glBindVertexArray(HeartObject[1]);
 
     glBindBuffer(GL_ARRAY_BUFFER, HeartBuffer[1]);  // Rail Shadows
-    glBufferData(GL_ARRAY_BUFFER, railshadows.size()*sizeof(meshnode_t), railshadows.data(), GL_STATIC_DRAW);
+    uploadBuffer(bufferRailShadows, GL_ARRAY_BUFFER, railshadows.constData(), railshadows.size()*sizeof(meshnode_t));
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4*sizeof(float), 0);
     glEnableVertexAttribArray(0);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, TrackIndices[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, shadowIndices.size()*sizeof(int), shadowIndices.data(), GL_STATIC_DRAW);
+    uploadBuffer(bufferShadowIndices, GL_ELEMENT_ARRAY_BUFFER, shadowIndices.constData(), shadowIndices.size()*sizeof(int));
 
     glBindVertexArray(HeartObject[3]);
 
     glBindBuffer(GL_ARRAY_BUFFER, HeartBuffer[3]);  // Shadow Supports
-    glBufferData(GL_ARRAY_BUFFER, supportshadows.size()*sizeof(meshnode_t), supportshadows.data(), GL_STATIC_DRAW);
+    uploadBuffer(bufferSupportShadows, GL_ARRAY_BUFFER, supportshadows.constData(), supportshadows.size()*sizeof(meshnode_t));
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4*sizeof(float), 0);
     glEnableVertexAttribArray(0);
 
     glBindVertexArray(HeartObject[4]);
 
     glBindBuffer(GL_ARRAY_BUFFER, HeartBuffer[4]);  // Shadow Crossties
-    glBufferData(GL_ARRAY_BUFFER, crosstieshadows.size()*sizeof(meshnode_t), crosstieshadows.data(), GL_STATIC_DRAW);
+    uploadBuffer(bufferCrosstieShadows, GL_ARRAY_BUFFER, crosstieshadows.constData(), crosstieshadows.size()*sizeof(meshnode_t));
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4*sizeof(float), 0);
     glEnableVertexAttribArray(0);
 
@@ -3527,6 +3762,12 @@ void trackMesh::updateVertexArrays()
 
 void trackMesh::createIndices()
 {
+    // the previous indices are kept to find out how much of the index buffers is still valid
+    QVector<int> oldPipeIndices = pipeIndices;
+    QVector<int> oldShadowIndices = shadowIndices;
+    pipeIndices.clear();
+    shadowIndices.clear();
+
     if(nodeList.isEmpty()) return;
     glm::vec3 cameraPos = glView->cameraPos;
     int edgeCount = 0;
@@ -3555,7 +3796,6 @@ void trackMesh::createIndices()
 
 
     pipeBorders.clear();
-    pipeIndices.clear();
     pipeBorders.append(0);
     if(isWireframe)
     {
@@ -3570,43 +3810,51 @@ void trackMesh::createIndices()
     }
     else
     {
-        for(int p = 0; p < options.size(); ++p)
+        // strips are laid out node after node and split by restart indices, so a change at the end
+        // of the track only changes the end of the index buffer
+        for(int p = 0, offset = 0; p < options.size(); offset += options[p].edges, ++p)
         {
-            int offset = 0;
-            for(int i = 0; i < p; ++i)
+            int node = renderList.first();
+            for(int e = 0; e < options[p].edges; ++e)
             {
-                offset += options[i].edges;
+                pipeIndices.append(p);
+                pipeIndices.append(options.size() + offset + edgeCount*node + e);
+                pipeIndices.append(options.size() + offset + edgeCount*node + (e+1)%options[p].edges);
+                pipeIndices.append(RESTART_INDEX);
             }
-            pipeIndices.append(p);
-            for(int e = 0; e < options[p].edges; e+=2)
+        }
+        for(int i = 0; i+1 < renderList.size(); ++i)
+        {
+            int node = renderList[i], next = renderList[i+1];
+            for(int p = 0, offset = 0; p < options.size(); offset += options[p].edges, ++p)
             {
-                int e2 = (e+1)%options[p].edges;
-                int e3 = (e+2)%options[p].edges;
-                int i;
-                for(i = 0; i < renderList.size(); ++i)
+                for(int e = 0; e <= options[p].edges; ++e)
                 {
-                    int node = renderList[i];
-                    pipeIndices.append(options.size() + offset + edgeCount*node + e);
-                    pipeIndices.append(options.size() + offset + edgeCount*node + e2);
+                    pipeIndices.append(options.size() + offset + edgeCount*node + e%options[p].edges);
+                    pipeIndices.append(options.size() + offset + edgeCount*next + e%options[p].edges);
                 }
+                pipeIndices.append(RESTART_INDEX);
+            }
+        }
+        for(int p = 0, offset = 0; p < options.size(); offset += options[p].edges, ++p)
+        {
+            int node = renderList.last();
+            for(int e = 0; e < options[p].edges; ++e)
+            {
+                pipeIndices.append(options.size() + offset + edgeCount*node + e);
+                pipeIndices.append(options.size() + offset + edgeCount*node + (e+1)%options[p].edges);
                 pipeIndices.append(options.size() + edgeCount*nodeCount + p);
-                for(i = renderList.size()-1; i >= 0; --i)
-                {
-                    int node = renderList[i];
-                    pipeIndices.append(options.size() + offset + edgeCount*node + e3);
-                    pipeIndices.append(options.size() + offset + edgeCount*node + e2);
-                }
-                pipeIndices.append(p);
+                pipeIndices.append(RESTART_INDEX);
             }
-            pipeBorders.append(pipeIndices.size());
         }
+        pipeBorders.append(pipeIndices.size());
 
-        shadowIndices.clear();
+        // shadows are plain triangles, so they are ordered node after node as well
+        int disp = 4*options.size();
+        int numShadowNodes = disp ? railshadows.size()/disp : 0;
         for(int p = 0; p < options.size(); ++p)
         {
             int offset = 4*p;
-            int disp = 4*options.size();
-            int i = 0, oldI = 0;
             shadowIndices.append(offset+0);
             shadowIndices.append(offset+1);
             shadowIndices.append(offset+3);
@@ -3614,8 +3862,13 @@ void trackMesh::createIndices()
             shadowIndices.append(offset+1);
             shadowIndices.append(offset+2);
             shadowIndices.append(offset+3);
-            for(i = 1; i < railshadows.size()/(4*options.size()); ++i)
+        }
+        for(int i = 1; i < numShadowNodes; ++i)
+        {
+            int oldI = i-1;
+            for(int p = 0; p < options.size(); ++p)
             {
+                int offset = 4*p;
                 shadowIndices.append(i*disp+offset+0);
                 shadowIndices.append(i*disp+offset+1);
                 shadowIndices.append(oldI*disp+offset+0);
@@ -3650,10 +3903,12 @@ void trackMesh::createIndices()
                 shadowIndices.append(i*disp+offset+0);
                 shadowIndices.append(oldI*disp+offset+0);
                 shadowIndices.append(oldI*disp+offset+3);
-
-                oldI = i;
             }
-
+        }
+        int oldI = numShadowNodes > 1 ? numShadowNodes-1 : 0;
+        for(int p = 0; p < options.size(); ++p)
+        {
+            int offset = 4*p;
             shadowIndices.append(oldI*disp+offset+1);
             shadowIndices.append(oldI*disp+offset+0);
             shadowIndices.append(oldI*disp+offset+2);
@@ -3664,6 +3919,9 @@ void trackMesh::createIndices()
         }
     }
 
+    invalidateBuffer(bufferRailIndices, commonPrefix(oldPipeIndices, pipeIndices)*sizeof(int));
+    invalidateBuffer(bufferShadowIndices, commonPrefix(oldShadowIndices, shadowIndices)*sizeof(int));
+
     updateVertexArrays();
     /*if(!glView->legacyMode)
     {
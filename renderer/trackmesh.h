@@ -22,24 +22,63 @@
 //#include "mypanelopengl.h"
 #include "glviewwidget.h"
 
+// separates the strips inside the rail index buffer
+#define RESTART_INDEX (-1)
+
+enum meshBuffer {
+    bufferRails = 0,
+    bufferRailIndices,
+    bufferCrossties,
+    bufferSupports,
+    bufferHeartline,
+    bufferRailShadows,
+    bufferShadowIndices,
+    bufferSupportShadows,
+    bufferCrosstieShadows,
+    bufferFrames,
+    numMeshBuffers
+};
+
+// vertex of the rails, crossties and supports, 40 bytes: the normal is octahedral encoded into two
+// normalized shorts and the values the track is colored by are half floats. uv keeps full floats as v
+// runs along the track, and node stays a full int since tracks pass 65535 nodes after a minute of ride
+// time. The shader reads it as a float, which is exact up to 2^24 nodes
 typedef struct tracknode_s{
     glm::vec3 pos;
-    glm::vec3 normal;
     glm::vec2 uv;
-    float vel;
-    float rollSpeed;
-    float yForce;
-    float xForce;
-    float flexion;
-    float selected;
     int node;
+    qint16 normal[2];
+    quint16 vel;
+    quint16 rollSpeed;
+    quint16 yForce;
+    quint16 xForce;
+    quint16 flexion;
+    quint16 padding;
 } tracknode_t;
 
+glm::vec3 unpackNormal(const qint16* normal);
+
 typedef struct meshnode_s{
     glm::vec3 pos;
     int node;
 } meshnode_t;
 
+// frame of a mesh node the pipe shader extrudes the rail rings from, five vec4 texels
+typedef struct pipeframe_s{
+    glm::vec3 pos;
+    float rollPerMeter;
+    glm::vec3 norm;
+    float length;
+    glm::vec3 lat;
+    float vel;
+    glm::vec3 dir;
+    float rollSpeed;
+    float yForce;
+    float xForce;
+    float flexion;
+    float node;
+} pipeframe_t;
+
 typedef struct pipeoption_s{
     int edges;
     glm::vec2 radius;
@@ -47,6 +86,24 @@ typedef struct pipeoption_s{
     bool smooth;
 } pipeoption_t;
 
+// scratch state of the vertex currently being generated, every thread building a part of the mesh owns one
+typedef struct meshcursor_s{
+    int secNode;
+    int nextNode;
+    glm::vec3 nextPos;
+    glm::vec3 nextNorm;
+    mnode* curNode;
+    section* curSection;
+} meshcursor_t;
+
+// support meshes of one section, rebuilt only when its support list or the ground height changes
+typedef struct supportchunk_s{
+    QList<glm::vec3> supList;
+    float ground;
+    QVector<tracknode_t> vertices;
+    QVector<meshnode_t> shadows;
+} supportchunk_t;
+
 class trackMesh
 {
 public:
@@ -55,34 +112,44 @@ public:
 
     bool isInit;
 
-    int createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &options);
-    int create3dsPipes(QVector<float> *_vertices, QList<pipeoption_t> &options);
+    int createPipes(QVector<tracknode_t> &list, QVector<meshnode_t> &shadowList, const QList<pipeoption_t> &options, const QList<int> &posList, const QList<int> &secList, bool buildRings = true);
+    void createPipeSegment(QVector<tracknode_t> &list, QVector<meshnode_t> &shadowList, const QList<pipeoption_t> &options, const QList<int> &posList, const QList<int> &secList, int from, int to, bool buildRings);
+    void createFrames(const QList<int> &posList, const QList<int> &secList);
+    void extrudePipes();
+    void extrudeRails(QVector<tracknode_t> &list);
+    int create3dsPipes(QVector<float> *_vertices, const QList<pipeoption_t> &options, const QList<int> &posList, const QList<int> &secList);
     void createIndices();
 
-    int createPipe(QVector<tracknode_t> &list, int edges, float radiusy, float radiusx, float y, float x, bool smooth = true);
-    void createBox(QVector<tracknode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r);
-    void createBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r);
-    int createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r);
+    void createBox(meshcursor_t &c, QVector<tracknode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r);
+    void createBox(meshcursor_t &c, QVector<meshnode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r);
+    int createShadowBox(meshcursor_t &c, QVector<meshnode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r);
     void create3dsBox(QVector<float> *_vertices, QVector<unsigned int> *_indices, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r);
 
-    void createQuad(QVector<tracknode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4);
-    void createQuad(QVector<meshnode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4);
+    void createQuad(meshcursor_t &c, QVector<tracknode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4);
+    void createQuad(meshcursor_t &c, QVector<meshnode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4);
     void create3dsQuad(QVector<float> *_vertices, QVector<unsigned int> *_indices, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4);
-    int createShadowTriangle(QVector<meshnode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3);
+    int createShadowTriangle(meshcursor_t &c, QVector<meshnode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3);
 
-    void createSupport(QVector<tracknode_t> &list, int edges, float radiusy, float radiusx, glm::vec3 P1, glm::vec3 P2, bool smooth);
+    void createSupport(meshcursor_t &c, QVector<tracknode_t> &list, QVector<meshnode_t> &shadowList, int edges, float radiusy, float radiusx, glm::vec3 P1, glm::vec3 P2, bool smooth);
+
+    void createCrosstie(meshcursor_t &c, QVector<tracknode_t> &list, QVector<meshnode_t> &shadowList, mnode* lastNode, int index, float railSpacing, float railWidth, float spineHeight, float spineSize);
 
     void buildMeshes(int fromNode);
-    void build3ds(const int _sec, QVector<float> * _vertices, QVector<unsigned int> *_indices, QVector<unsigned int> *_borders);
+    void build3ds(const int _sec, const int _quality, QVector<float> * _vertices, QVector<unsigned int> *_indices, QVector<unsigned int> *_borders);
     void updateVertexArrays();
 
-    void appendTrackNode(QVector<tracknode_t> &list, float _u = 0.f, float _v = 0.f);
-    void append3dsNode(QVector<float> *_vertices);
-    void appendSupportNode(QVector<tracknode_t> &list, float _u = 0.f, float _v = 0.f);
-    void appendMeshNode(QVector<meshnode_t> &list);
+    void appendTrackNode(meshcursor_t &c, QVector<tracknode_t> &list, float _u = 0.f, float _v = 0.f);
+    void appendSupportNode(meshcursor_t &c, QVector<tracknode_t> &list, float _u = 0.f, float _v = 0.f);
+    void appendMeshNode(meshcursor_t &c, QVector<meshnode_t> &list);
 
     void recolorTrack(void);
 
+    // first and last node of the active section and of the selected transition, highlighted by the track shader
+    glm::vec4 selectionRange;
+
+    void invalidateBuffer(int buffer, int bytes);
+    void uploadBuffer(int buffer, GLenum target, const void* data, int bytes);
+
     QVector<tracknode_t> rails;
     QList<int> nodeList;
     QVector<int> pipeIndices, shadowIndices;
@@ -98,12 +165,22 @@ public:
 
     QList<pipeoption_t> options;
 
-    QList<int> posList;
-    QList<int> secList;
+    // the solid rails are extruded on the gpu from one frame per mesh node, rails stays empty then
+    bool gpuPipes;
+    QVector<pipeframe_t> frames;
+    myTexture* frameTexture;
+
+    QList<supportchunk_t> supportChunks;
+
+    // bytes reserved on the gpu and bytes at the front of each buffer that are still up to date
+    int bufferCapacity[numMeshBuffers];
+    int bufferClean[numMeshBuffers];
+    int uploadedBytes;
 
     GLuint TrackBuffer[7], TrackObject[5], TrackIndices[5];
     GLuint HeartBuffer[5], HeartObject[5], HeartIndices[5];
     GLuint ShadowBuffer[1], ShadowObject[1];
+    GLuint PipeBuffer[1], PipeObject[1];
 
     track* trackData;
 
@@ -112,13 +189,6 @@ public:
     bool isWireframe;
 
     void init();
-private:
-    int j;
-    int nextNode;
-    glm::vec3 nextPos;
-    glm::vec3 nextNorm;
-    mnode* curNode;
-    section* curSection;
 };
 
 #endif // TRACKMESH_H
@@ -8,14 +8,22 @@ uniform mat4 modelMatrix;
 uniform mat4 anchorBase;
 uniform vec3 eyePos;
 
-in vec3 aNormal;
+in vec2 aNormal;
 out vec3 bNormal;
 
+// octahedral normals, see packNormal() in trackmesh.cpp
+vec3 decodeNormal(vec2 oct)
+{
+    vec3 n = vec3(oct, 1.0 - abs(oct.x) - abs(oct.y));
+    if(n.z < 0.0) n.xy = (1.0 - abs(n.yx))*vec2(oct.x >= 0.0 ? 1.0 : -1.0, oct.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
 void main(void)
 {
     bPosition = anchorBase * vec4(aPosition, 1);
     gl_Position = projectionMatrix * modelMatrix * bPosition;
     bPosition -= vec4(eyePos, 0);
     screenPos = gl_Position;
-    bNormal = vec3(anchorBase * vec4(aNormal, 0));
+    bNormal = vec3(anchorBase * vec4(decodeNormal(aNormal), 0));
 }
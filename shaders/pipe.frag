@@ -0,0 +1,10 @@
+#version 140
+
+// the pipe shader only runs with the rasterizer discarded, nothing is ever drawn
+
+out vec4 oFragColor;
+
+void main(void)
+{
+    oFragColor = vec4(0.0);
+}
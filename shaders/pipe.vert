@@ -0,0 +1,113 @@
+#version 140
+
+// extrudes the rails and spines around the frames of the mesh nodes, one vertex per gl_VertexID
+// in the layout trackMesh::createPipes() uses: the start caps, the rings node after node, the end caps.
+// the outputs are captured into the rail buffer and match tracknode_t
+
+uniform samplerBuffer frames;
+uniform int frameCount;
+uniform int pipeCount;
+uniform int edgeCount;
+uniform int edges[8];       // negative for pipes with hard edges
+uniform vec4 profile[8];    // radius, offset
+
+out vec3 tPosition;
+out vec2 tUv;
+flat out int tNode;
+flat out uint tNormal;
+flat out uint tVelRoll;
+flat out uint tForces;
+flat out uint tFlexion;
+
+const float PI = 3.14159265358979;
+
+// the same rounding and clamping as toHalf() in trackmesh.cpp
+uint packHalf(float value)
+{
+    uint signBit = value < 0.0 ? 0x8000u : 0u;
+    value = abs(value);
+    if(value < 6.103515625e-05) return signBit;
+    if(value >= 65504.0) return signBit | 0x7bffu;
+    int exponent = int(floor(log2(value)));
+    float mantissa = value/exp2(float(exponent));
+    if(mantissa < 1.0) { --exponent; mantissa *= 2.0; }
+    else if(mantissa >= 2.0) { ++exponent; mantissa *= 0.5; }
+    uint bits = (uint(exponent+15) << 10u) + uint(floor((mantissa-1.0)*1024.0+0.5));
+    return signBit | min(bits, 0x7bffu);
+}
+
+// the same octahedral encoding as packNormal() in trackmesh.cpp, two normalized shorts
+uint packNormal(vec3 normal)
+{
+    vec2 oct = normal.xy/(abs(normal.x) + abs(normal.y) + abs(normal.z));
+    if(normal.z < 0.0) oct = (1.0 - abs(oct.yx))*vec2(oct.x >= 0.0 ? 1.0 : -1.0, oct.y >= 0.0 ? 1.0 : -1.0);
+    ivec2 n = ivec2(floor(clamp(oct, -1.0, 1.0)*32767.0+0.5));
+    return uint(n.x & 0xffff) | (uint(n.y & 0xffff) << 16u);
+}
+
+void main(void)
+{
+    int vertex = gl_VertexID;
+    int pipe = 0, edge = 0, index = 0;
+    bool cap = true;
+    if(vertex < pipeCount) {
+        pipe = vertex;
+    } else if(vertex >= pipeCount+edgeCount*frameCount) {
+        index = frameCount-1;
+        pipe = vertex-pipeCount-edgeCount*frameCount;
+    } else {
+        cap = false;
+        index = (vertex-pipeCount)/edgeCount;
+        edge = vertex-pipeCount-index*edgeCount;
+        while(edge >= abs(edges[pipe])) {
+            edge -= abs(edges[pipe]);
+            ++pipe;
+        }
+    }
+
+    vec4 f0 = texelFetch(frames, 5*index);
+    vec4 f1 = texelFetch(frames, 5*index+1);
+    vec4 f2 = texelFetch(frames, 5*index+2);
+    vec4 f3 = texelFetch(frames, 5*index+3);
+    vec4 f4 = texelFetch(frames, 5*index+4);
+    vec3 norm = f1.xyz;
+    vec3 lat = f2.xyz;
+    vec3 dir = f3.xyz;
+    float roll = f0.w;
+
+    vec2 radius = profile[pipe].xy;
+    vec2 offset = profile[pipe].zw;
+
+    // mnode::vLatHeart(-offset.y) and mnode::vRelPos(offset.y, offset.x)
+    vec3 latHeart = normalize(lat + dir*roll*offset.y);
+    vec3 center = f0.xyz - offset.y*norm + offset.x*latHeart;
+
+    vec3 normal;
+    if(cap) {
+        // mnode::vDirHeart(-offset.y), pointing away from the pipe
+        normal = normalize(dir - lat*roll*offset.y)*(vertex < pipeCount ? -1.0 : 1.0);
+        tPosition = center;
+        tUv = vec2(0.0, f1.w);
+    } else {
+        int count = abs(edges[pipe]);
+        bool isSmooth = edges[pipe] > 0;
+        float angle = isSmooth ? float(edge)*360.0/float(count) - 180.0/float(count) : float(edge/2)*720.0/float(count) - 360.0/float(count);
+        float a = angle*PI/180.0;
+        vec3 offsetNorm = -(radius.y*cos(a))*norm + (radius.x*sin(a))*latHeart;
+        if(isSmooth) {
+            normal = normalize(offsetNorm);
+        } else {
+            float b = a + float((edge%2)*2-1)*PI/4.0;
+            normal = normalize(-(radius.y*cos(b))*norm + (radius.x*sin(b))*latHeart);
+        }
+        tPosition = center + offsetNorm;
+        tUv = vec2(0.5*(radius.x+radius.y)/0.3*abs(angle-180.0+180.0/float(count))/180.0, f1.w);
+    }
+
+    tNode = int(f4.w);
+    tNormal = packNormal(normal);
+    tVelRoll = packHalf(f2.w) | (packHalf(f3.w) << 16u);
+    tForces = packHalf(f4.x) | (packHalf(f4.y) << 16u);
+    tFlexion = packHalf(f4.z);
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+}
@@ -10,16 +10,17 @@ uniform vec3 eyePos;
 uniform vec3 defaultColor;
 uniform vec3 sectionColor;
 uniform vec3 transitionColor;
+uniform vec4 selectionRange;
 
 in vec2 aUv;
 out vec2 bUv;
 
 out vec4 screenCoord;
 
-in vec3 aNormal;
+in vec2 aNormal;
 out vec3 bNormal;
 
-in float aselected;
+in float aNode;
 in float aVel;
 in float aRoll;
 in float aNForce;
@@ -29,14 +30,21 @@ out vec3 color;
 
 uniform int colorMode;
 
+// octahedral normals, see packNormal() in trackmesh.cpp
+vec3 decodeNormal(vec2 oct)
+{
+    vec3 n = vec3(oct, 1.0 - abs(oct.x) - abs(oct.y));
+    if(n.z < 0.0) n.xy = (1.0 - abs(n.yx))*vec2(oct.x >= 0.0 ? 1.0 : -1.0, oct.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
 
 vec3 getColor()
 {
     switch(colorMode) {
         case 0: // nothing
-            if(aselected < 0.5) return defaultColor;
-            else if(aselected < 1.5) return sectionColor;
-            else return transitionColor;
+            if(aNode >= selectionRange.z-0.5 && aNode <= selectionRange.w+0.5) return transitionColor;
+            else if(aNode >= selectionRange.x-0.5 && aNode <= selectionRange.y+0.5) return sectionColor;
+            else return defaultColor;
         case 1: // velocity
             if(aVel > 60.)
             return vec3(1., 0., 1.);
@@ -125,8 +133,7 @@ void main(void)
     bPosition = anchorBase * vec4(aPosition, 1);
     gl_Position = projectionMatrix * modelMatrix * bPosition;
     bPosition -= vec4(eyePos, 0);
-    bNormal = vec3(anchorBase * vec4(aNormal, 0));
-    if(length(bNormal) < 0.5) bNormal = vec3(0, 1, 0);
+    bNormal = vec3(anchorBase * vec4(decodeNormal(aNormal), 0));
     bUv = aUv;
     screenCoord = gl_Position;
 }
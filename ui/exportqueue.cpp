@@ -0,0 +1,282 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "exportqueue.h"
+#include "exportfuncs.h"
+#include "track.h"
+#include "nodeexport.h"
+#include "mainwindow.h"
+#include <QtConcurrent>
+#include <QFile>
+#include <QTimer>
+#include <QStatusBar>
+#include <QProgressBar>
+#include <QToolButton>
+#include <fstream>
+#include <cstdio>
+
+using namespace std;
+
+extern MainWindow* gloParent;
+
+exportJob::exportJob(enum exportType _type, track* _track, QString _fileName)
+{
+    type = _type;
+    trackData = _track;
+    fileName = _fileName;
+    fPerNode = 2.f;
+    fRollThresh = 0.f;
+    fTolerance = 0.01f;
+    fRollTolerance = 1.f;
+    noHeartLine = false;
+    fromIndex = 0;
+    toIndex = 0;
+    backupSerial = 0;
+}
+
+exportJob::~exportJob()
+{
+    delete trackData;
+}
+
+// writes to a .part file next to the target, which only replaces the target once complete
+QString exportJob::run()
+{
+    // the autosave is quick, so it goes first instead of waiting for the export. It shares the
+    // lock of the timer autosave, so only one of them writes the .bak at a time
+    if(!backupName.isEmpty()) {
+        backupResult = gloParent->writeBackup(backupSerial, backupName, backup);
+    }
+
+    if(progress.canceled.load()) return QString("Export to ").append(fileName).append(" canceled");
+
+    QString partName = fileName + QString(".part");
+    QByteArray cFile = partName.toLocal8Bit();
+
+    if(type == exportNL2) {
+        FILE* fout = fopen(cFile.constData(), "w");
+        if(fout == NULL) {
+            return QString("Error: Could not write to ").append(fileName);
+        }
+
+        fprintf(fout, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+        fprintf(fout, "<root>\n");
+        fprintf(fout, "\t<element>\n");
+        fprintf(fout, "\t\t<description>FVD++ Export Data</description>\n");
+
+        trackData->exportNL2Track(fout, fPerNode, fromIndex, toIndex, &progress);
+
+        fprintf(fout, "\t</element>\n");
+        fprintf(fout, "</root>\n");
+        fclose(fout);
+    } else if(type == exportNodeBinary || type == exportNodeCSV) {
+        FILE* fout = fopen(cFile.constData(), type == exportNodeCSV ? "w" : "wb");
+        if(fout == NULL) {
+            return QString("Error: Could not write to ").append(fileName);
+        }
+
+        if(noHeartLine) {
+            trackData->fHeart = 0.f;
+        }
+        int iNodes = exportNodeData(fout, trackData, fromIndex, toIndex, type == exportNodeCSV, &progress);
+        fclose(fout);
+
+        if(iNodes < 0 && !progress.canceled.load()) {
+            QFile::remove(partName);
+            return QString("Error: Could not write to ").append(fileName);
+        }
+    } else {
+        fstream* fout = new fstream(cFile.constData(), ios::out | ios::binary);
+        if(!fout->is_open()) {
+            delete fout;
+            return QString("Error: Could not write to ").append(fileName);
+        }
+
+        writeBytes(fout, (const char*)"MELE", 4);
+        writeNulls(fout, 4); // will be replaced with length of data
+        writeNulls(fout, 64);
+        writeNulls(fout, 4); // will be replaced with No of NL beziers
+
+        if(noHeartLine) {
+            trackData->fHeart = 0.f;
+        }
+
+        int iNodes;
+        if(type == exportNL) {
+            iNodes = trackData->exportTrack4(fout, fPerNode, fromIndex, toIndex, fRollThresh, &progress);
+        } else if(type == exportNLAdaptive) {
+            iNodes = trackData->exportTrackAdaptive(fout, fTolerance, fRollTolerance, fromIndex, toIndex, fRollThresh, &progress);
+        } else {
+            iNodes = trackData->exportTrack3(fout, fPerNode, fromIndex, toIndex, fRollThresh, &progress);
+        }
+
+        // a canceled export returns -1 and the part file is dropped below
+        if(iNodes >= 0) {
+            int iDataLength = iNodes*50+132;
+
+            writeNulls(fout, 69);
+
+            fout->seekp(4);
+            writeBytes(fout, (const char*)&iDataLength, 4); // replaced with length of data
+            fout->seekp(72);
+            writeBytes(fout, (const char*)&iNodes, 4); // replaced with no of NL beziers
+        }
+
+        fout->close();
+        delete fout;
+    }
+
+    if(progress.canceled.load()) {
+        QFile::remove(partName);
+        return QString("Export to ").append(fileName).append(" canceled");
+    }
+
+    // rename does not overwrite, so the old file is moved aside and only dropped once the new one is in place
+    QString oldName = fileName + QString(".old");
+    bool replace = QFile::exists(fileName);
+    if(replace) {
+        QFile::remove(oldName);
+        if(!QFile::rename(fileName, oldName)) {
+            QFile::remove(partName);
+            return QString("Error: Could not write to ").append(fileName);
+        }
+    }
+    if(!QFile::rename(partName, fileName)) {
+        if(replace) QFile::rename(oldName, fileName);
+        QFile::remove(partName);
+        return QString("Error: Could not write to ").append(fileName);
+    }
+    if(replace) QFile::remove(oldName);
+    return QString("Export to ").append(fileName).append(" successful!");
+}
+
+exportQueue::exportQueue(QStatusBar* _statusBar)
+{
+    statusBar = _statusBar;
+    queued = 0;
+    done = 0;
+
+    progressBar = new QProgressBar(statusBar);
+    progressBar->setMaximumWidth(150);
+    progressBar->setMaximumHeight(16);
+    progressBar->setTextVisible(false);
+    progressBar->hide();
+    statusBar->addPermanentWidget(progressBar);
+
+    cancelButton = new QToolButton(statusBar);
+    cancelButton->setText(QString("Cancel Export"));
+    cancelButton->setAutoRaise(true);
+    cancelButton->hide();
+    statusBar->addPermanentWidget(cancelButton);
+
+    progressTimer = new QTimer(this);
+    progressTimer->setInterval(100);
+
+    connect(cancelButton, SIGNAL(clicked()), this, SLOT(onCancelClicked()));
+    connect(progressTimer, SIGNAL(timeout()), this, SLOT(updateProgress()));
+}
+
+exportQueue::~exportQueue()
+{
+    cancelAll();
+    for(int i = 0; i < watchers.size(); ++i) {
+        watchers[i]->waitForFinished();
+        delete watchers[i];
+        delete jobs[i];
+    }
+}
+
+// the job is run on the global thread pool, so several exports proceed side by side
+void exportQueue::enqueue(exportJob* _job)
+{
+    QFutureWatcher<QString>* watcher = new QFutureWatcher<QString>();
+    connect(watcher, SIGNAL(finished()), this, SLOT(onJobFinished()));
+
+    jobs.append(_job);
+    watchers.append(watcher);
+    ++queued;
+    cancelButton->setEnabled(true);
+    updateProgress();
+
+    watcher->setFuture(QtConcurrent::run(&exportQueue::runJob, _job));
+}
+
+void exportQueue::cancelAll()
+{
+    for(int i = 0; i < jobs.size(); ++i) {
+        jobs[i]->progress.canceled.store(1);
+    }
+}
+
+QString exportQueue::runJob(exportJob* _job)
+{
+    return _job->run();
+}
+
+void exportQueue::onJobFinished()
+{
+    QFutureWatcher<QString>* watcher = static_cast<QFutureWatcher<QString>*>(sender());
+    int index = watchers.indexOf(watcher);
+    if(index == -1) return;
+
+    statusBar->showMessage(watcher->result(), 5000);
+
+    exportJob* job = jobs.takeAt(index);
+    if(!job->backupName.isEmpty()) {
+        gloParent->backupFinished(job->backupResult);
+    }
+
+    // the snapshot owns tree items, so it is released on the gui thread
+    delete job;
+    watchers.removeAt(index);
+    watcher->deleteLater();
+
+    ++done;
+    updateProgress();
+}
+
+void exportQueue::onCancelClicked()
+{
+    cancelAll();
+    cancelButton->setEnabled(false);
+}
+
+void exportQueue::updateProgress()
+{
+    if(jobs.isEmpty()) {
+        queued = 0;
+        done = 0;
+        progressBar->hide();
+        cancelButton->hide();
+        progressTimer->stop();
+        return;
+    }
+
+    // finished jobs count in full, running ones by the steps their exporter reported
+    qint64 value = (qint64)done*1000;
+    for(int i = 0; i < jobs.size(); ++i) {
+        qint64 total = jobs[i]->progress.total.load();
+        if(total > 0) value += qMin((qint64)jobs[i]->progress.done.load()*1000/total, (qint64)1000);
+    }
+    progressBar->setRange(0, queued*1000);
+    progressBar->setValue((int)value);
+    progressBar->setToolTip(QString().number(jobs.size()).append(" export(s) running"));
+    progressBar->show();
+    cancelButton->show();
+    if(!progressTimer->isActive()) progressTimer->start();
+}
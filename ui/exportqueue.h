@@ -0,0 +1,98 @@
+#ifndef EXPORTQUEUE_H
+#define EXPORTQUEUE_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QFutureWatcher>
+#include "exportfuncs.h"
+#include "projectfile.h"
+
+class track;
+class QStatusBar;
+class QProgressBar;
+class QToolButton;
+class QTimer;
+
+enum exportType {
+    exportNL2 = 0,
+    exportNL,
+    exportNLLegacy,
+    exportNLAdaptive,
+    exportNodeBinary,
+    exportNodeCSV
+};
+
+// one queued export, owns a snapshot of the track so the user can keep editing meanwhile,
+// and the autosave taken along with it
+class exportJob
+{
+public:
+    exportJob(enum exportType _type, track* _track, QString _fileName);
+    ~exportJob();
+    QString run();
+
+    enum exportType type;
+    track* trackData;
+    QString fileName;
+    float fPerNode;
+    float fRollThresh;
+    float fTolerance;
+    float fRollTolerance;
+    bool noHeartLine;
+    int fromIndex;
+    int toIndex;
+    QString backupName;
+    QList<chunkBlock_t> backup;
+    int backupSerial;
+    QString backupResult;
+    exportprogress_t progress;
+};
+
+// runs export jobs on the thread pool and shows their progress in the status bar
+class exportQueue : public QObject
+{
+    Q_OBJECT
+public:
+    exportQueue(QStatusBar* _statusBar);
+    ~exportQueue();
+    void enqueue(exportJob* _job);
+    void cancelAll();
+
+private slots:
+    void onJobFinished();
+    void onCancelClicked();
+    void updateProgress();
+
+private:
+    static QString runJob(exportJob* _job);
+
+    QList<exportJob*> jobs;
+    QList<QFutureWatcher<QString>*> watchers;
+    QStatusBar* statusBar;
+    QProgressBar* progressBar;
+    QToolButton* cancelButton;
+    QTimer* progressTimer;
+    int queued;
+    int done;
+};
+
+#endif // EXPORTQUEUE_H
@@ -48,10 +48,9 @@ exportUi::exportUi(QWidget *parent, projectWidget* _project): QDialog(parent), u
     ui->setupUi(this);
 
 #ifdef Q_OS_MAC
-    this->setFixedSize(435, 300);
+    this->setFixedSize(435, 360);
 #endif
 
-    this->cFile = NULL;
     this->project = _project;
     this->fPerNode = 2.0f;
 
@@ -95,126 +94,52 @@ exportUi::exportUi(QWidget *parent, projectWidget* _project): QDialog(parent), u
 
 void exportUi::doExport()
 {
-    this->fPerNode = ui->segmentLengthBox->value();
-    float fRollThresh = sin(ui->relThresBox->value()*F_PI/180.f);
-
-    track* tTrack = project->trackList[curTrackIndex]->trackData;
-
-    if (!fileName.isEmpty()) {
-        this->cFile = fileName.toLocal8Bit().data();
-        fstream* fout = new fstream(this->cFile, ios::out | ios::binary);
-
-        if(fout == NULL) {
-            lenAssert(0 && "File Stream is NULL");
-            return;
-        }
-
-        writeBytes(fout, (const char*)"MELE", 4);
-        writeNulls(fout, 4); // will be replaced with length of data
-        writeNulls(fout, 64);
-        writeNulls(fout, 4); // will be replaced with No of NL beziers
-
-        float oldHeartLine = tTrack->fHeart;
-        if(ui->noHeartLineBox->isChecked())
-        {
-            tTrack->fHeart = 0.f;
-        }
-        int iNodes = tTrack->exportTrack4(fout, this->fPerNode, curFromIndex, curToIndex+curFromIndex, fRollThresh);
-
-        tTrack->fHeart = oldHeartLine;
-
-        int iDataLength = iNodes*50+132;
-
-        writeNulls(fout, 69);
-
-        fout->seekp(4);
-        writeBytes(fout, (const char*)&iDataLength, 4); // replaced with length of data
-        fout->seekp(72);
-        writeBytes(fout, (const char*)&iNodes, 4); // replaced with no of NL beziers
-
-        fout->close();
-        delete fout;
-        gloParent->backupSave();
-        gloParent->displayStatusMessage(QString("Export to ").append(fileName).append(" successful!"));
-    } else {
-        lenAssert(0 && "no FileName");
-        return;
-    }
+    queueExport(exportNL);
 }
 
 void exportUi::doExport2()
 {
-    this->fPerNode = ui->segmentLengthBox->value();
-    float fRollThresh = sin(ui->relThresBox->value()*F_PI/180.f);
-
-    track* tTrack = project->trackList[curTrackIndex]->trackData;
-
-    if (!fileName.isEmpty()) {
-        this->cFile = fileName.toLocal8Bit().data();
-        fstream* fout = new fstream(this->cFile, ios::out | ios::binary);
-
-        if(fout == NULL) {
-            lenAssert(0 && "File Stream is NULL");
-            return;
-        }
-
-        writeBytes(fout, (const char*)"MELE", 4);
-        writeNulls(fout, 4); // will be replaced with length of data
-        writeNulls(fout, 64);
-        writeNulls(fout, 4); // will be replaced with No of NL beziers
-
-        float oldHeartLine = tTrack->fHeart;
-        if(ui->noHeartLineBox->isChecked()) {
-            tTrack->fHeart = 0.f;
-        }
-        int iNodes = tTrack->exportTrack3(fout, this->fPerNode, curFromIndex, curToIndex+curFromIndex, fRollThresh);
-
-        tTrack->fHeart = oldHeartLine;
-
-        int iDataLength = iNodes*50+132;
-
-        writeNulls(fout, 69);
-
-        fout->seekp(4);
-        writeBytes(fout, (const char*)&iDataLength, 4); // replaced with length of data
-        fout->seekp(72);
-        writeBytes(fout, (const char*)&iNodes, 4); // replaced with no of NL beziers
-
-        fout->close();
-        delete fout;
-        gloParent->backupSave();
-        gloParent->displayStatusMessage(QString("Export to ").append(fileName).append(" successful!"));
-    } else {
-        lenAssert(0 && "no FileName");
-        return;
-    }
+    queueExport(exportNLLegacy);
 }
 
 void exportUi::doNL2Export()
 {
-    fPerNode = ui->segmentLengthBox->value();
+    queueExport(exportNL2);
+}
 
-    track* tTrack = project->trackList[curTrackIndex]->trackData;
+void exportUi::doAdaptiveExport()
+{
+    queueExport(exportNLAdaptive);
+}
 
-    if (!fileName.isEmpty()) {
-        this->cFile = fileName.toLocal8Bit().data();
-        FILE* fout = fopen(cFile, "w");
+void exportUi::doNodeExport(bool csv)
+{
+    queueExport(csv ? exportNodeCSV : exportNodeBinary);
+}
 
-        fprintf(fout, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
-        fprintf(fout, "<root>\n");
-        fprintf(fout, "\t<element>\n");
-        fprintf(fout, "\t\t<description>FVD++ Export Data</description>\n");
+// hands a snapshot of the selected track to the export queue, the file is written in the background
+void exportUi::queueExport(enum exportType type)
+{
+    // the file dialog was canceled
+    if(fileName.isEmpty() || gloParent->loading) return;
 
-        tTrack->exportNL2Track(fout, fPerNode, curFromIndex, curFromIndex+curToIndex);
+    track* tTrack = project->trackList[curTrackIndex]->trackData;
 
-        fprintf(fout, "\t</element>\n");
-        fprintf(fout, "</root>\n");
-        gloParent->backupSave();
-        gloParent->displayStatusMessage(QString("Export to ").append(fileName).append(" successful!"));
-        fclose(fout);
-    } else {
-        return;
-    }
+    exportJob* job = new exportJob(type, tTrack->snapshot(), fileName);
+    job->fPerNode = ui->segmentLengthBox->value();
+    job->fRollThresh = sin(ui->relThresBox->value()*F_PI/180.f);
+    job->fTolerance = ui->toleranceBox->value()/100.f;
+    job->fRollTolerance = ui->rollToleranceBox->value();
+    job->noHeartLine = type != exportNL2 && ui->noHeartLineBox->isChecked();
+    job->fromIndex = curFromIndex;
+    job->toIndex = curToIndex+curFromIndex;
+
+    fPerNode = job->fPerNode;
+
+    // the job writes the autosave as well, so nothing but the snapshot is taken here
+    gloParent->backupSnapshot(job->backupName, job->backup, job->backupSerial);
+    gloParent->mExportQueue->enqueue(job);
+    gloParent->displayStatusMessage(QString("Exporting to ").append(fileName).append("..."));
 }
 
 void exportUi::doFastExport()
@@ -229,6 +154,13 @@ void exportUi::doFastExport()
     case 2:
         doExport2();
         break;
+    case 3:
+        doAdaptiveExport();
+        break;
+    case 4:
+    case 5:
+        doNodeExport(ui->exportTypeBox->currentIndex() == 5);
+        break;
     }
 }
 
@@ -237,6 +169,10 @@ void exportUi::on_buttonBox_accepted()
     QString filter;
     if(ui->exportTypeBox->currentIndex() == 0) {
         filter = QString("NL Element (*.nl2elem)");
+    } else if(ui->exportTypeBox->currentIndex() == 4) {
+        filter = QString("FVD Node Data (*.fvdn)");
+    } else if(ui->exportTypeBox->currentIndex() == 5) {
+        filter = QString("CSV Node Data (*.csv)");
     } else {
         filter = QString("NL Element (*.nlelem)");
     }
@@ -252,6 +188,13 @@ void exportUi::on_buttonBox_accepted()
     case 2:
         doExport2();
         break;
+    case 3:
+        doAdaptiveExport();
+        break;
+    case 4:
+    case 5:
+        doNodeExport(ui->exportTypeBox->currentIndex() == 5);
+        break;
     default:
         lenAssert(0 && "unknown exporter type");
         break;
@@ -270,11 +213,32 @@ void exportUi::on_exportTypeBox_currentIndexChanged(int index)
     case 0:
         ui->relThresBox->setDisabled(true);
         ui->noHeartLineBox->setDisabled(true);
+        ui->segmentLengthBox->setEnabled(true);
+        ui->toleranceBox->setDisabled(true);
+        ui->rollToleranceBox->setDisabled(true);
         break;
     case 1:
     case 2:
         ui->relThresBox->setEnabled(true);
         ui->noHeartLineBox->setEnabled(true);
+        ui->segmentLengthBox->setEnabled(true);
+        ui->toleranceBox->setDisabled(true);
+        ui->rollToleranceBox->setDisabled(true);
+        break;
+    case 3:
+        ui->relThresBox->setEnabled(true);
+        ui->noHeartLineBox->setEnabled(true);
+        ui->segmentLengthBox->setDisabled(true);
+        ui->toleranceBox->setEnabled(true);
+        ui->rollToleranceBox->setEnabled(true);
+        break;
+    case 4:
+    case 5:
+        ui->relThresBox->setDisabled(true);
+        ui->noHeartLineBox->setEnabled(true);
+        ui->segmentLengthBox->setDisabled(true);
+        ui->toleranceBox->setDisabled(true);
+        ui->rollToleranceBox->setDisabled(true);
         break;
     default:
         lenAssert(0 && "unknown exporter type");
@@ -23,6 +23,7 @@
 
 #include "track.h"
 #include "projectwidget.h"
+#include "exportqueue.h"
 #include <QString>
 
 namespace Ui {
@@ -40,6 +41,8 @@ public:
     void doExport();
     void doExport2();
     void doNL2Export();
+    void doAdaptiveExport();
+    void doNodeExport(bool csv);
     void doFastExport();
     bool updateBoxes();
 
@@ -57,8 +60,9 @@ private slots:
     void on_exportTypeBox_currentIndexChanged(int index);
 
 private:
+    void queueExport(enum exportType type);
+
     Ui::Exportui *ui;
-    const char* cFile;
     projectWidget* project;
     float fPerNode;
     bool phantomChanges;
@@ -53,6 +53,23 @@ importUi::importUi(QWidget *parent, QString _fileName) :
 
     legacymode = false;
 
+    fin.seekg(0);
+    if(readString(&fin, 3) == "FVD" && readString(&fin, 5) == CHUNK_VERSION && readToc(fin, toc)) {
+        int count = numTracks(toc);
+        for(; id < count; ++id) {
+            QList<chunk_t> chunks = trackChunks(toc, id);
+            const chunk_t* header = findChunk(chunks, "TRKH");
+            if(header == NULL || !seekChunk(fin, *header)) break;
+            posList.append(id);
+            int namelength = readInt(&fin);
+            QString name = QString(readString(&fin, namelength).c_str());
+            trackList.append(new trackHandler(name, id));
+            ui->treeWidget->addTopLevelItem(trackList[id]->listItem);
+        }
+        length = 0; // no need to scan for track tags
+    }
+    fin.clear();
+
     for(int i = 0; i < length; ++i) {
         fin.seekg(i);
         string check = readString(&fin, 3);
@@ -104,11 +121,14 @@ void importUi::on_buttonBox_accepted()
             }
             --i;
         } else if(posList.size()) {
-            fin.seekg(posList[i]);
-            if(legacymode) {
+            if(toc.size()) {
+                trackList[i]->trackData->loadTrack(fin, trackChunks(toc, posList[i]), trackList[i]->trackWidgetItem);
+            } else if(legacymode) {
+                fin.seekg(posList[i]);
                 trackList[i]->trackData->legacyLoadTrack(fin, trackList[i]->trackWidgetItem);
 
             } else {
+                fin.seekg(posList[i]);
                 trackList[i]->trackData->loadTrack(fin, trackList[i]->trackWidgetItem);
             }
             ui->treeWidget->takeTopLevelItem(0);
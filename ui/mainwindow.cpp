@@ -27,14 +27,18 @@
 #include "conversionpanel.h"
 #include "graphwidget.h"
 #include <sstream>
+#include <cstdio>
 #include "trackwidget.h"
 #include <QTimer>
+#include <QtConcurrent>
 #include "undohandler.h"
 #include "undoaction.h"
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QCloseEvent>
 #include "objectexporter.h"
+#include "nodecache.h"
+#include "exportqueue.h"
 
 MainWindow* gloParent;
 glViewWidget* glView;
@@ -52,6 +56,8 @@ MainWindow::MainWindow(QWidget *parent) :
     mOptions->setWindowFlags(mOptions->windowFlags() & (~Qt::WindowMinimizeButtonHint));
     mOptions->setWindowFlags(mOptions->windowFlags() & (~Qt::WindowContextHelpButtonHint));
 
+    mNodeCache = new nodeCache((qint64)mOptions->nodeCacheSize*1024*1024, mOptions->nodeCacheCompress);
+
 #ifdef Q_OS_MAC
     mOptions->setWindowModality(Qt::WindowModal);
     mOptions->setWindowFlags((windowFlags() & ~Qt::WindowType_Mask) | Qt::Sheet);
@@ -115,6 +121,9 @@ MainWindow::MainWindow(QWidget *parent) :
 
     setUndoButtons();
     undoChanges = false;
+    loading = false;
+    backupSerial = 0;
+    backupWritten = 0;
 
     QTabBar *tabBar = ui->tabChooser->findChild<QTabBar*>();
     #ifndef Q_OS_MAC // on Win / Unix
@@ -132,15 +141,22 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(timer, SIGNAL(timeout()), this, SLOT(showCurInfoPanel()));
 	timer->start(10);
 
+    connect(&backupWatcher, SIGNAL(finished()), this, SLOT(onBackupSaved()));
+
     QTimer *autosave = new QTimer(this);
     connect(autosave, SIGNAL(timeout()), this, SLOT(doAutoSave()));
     autosave->start(1000*60);
 
     connect(this, SIGNAL(emitMessage(QString,int)), ui->statusBar, SLOT(showMessage(QString,int)));
+
+    mExportQueue = new exportQueue(ui->statusBar);
 }
 
 MainWindow::~MainWindow()
 {
+    delete mExportQueue;
+    backupWatcher.waitForFinished();
+    delete mNodeCache;
     delete ui;
     exit(0);
 }
@@ -168,6 +184,9 @@ QList<trackHandler*> MainWindow::getTrackList()
 
 void MainWindow::on_actionExportAs_triggered()
 {
+    if(loading) {
+        return;
+    }
     exportScreen->updateBoxes();
     exportScreen->show();
 }
@@ -176,6 +195,7 @@ void MainWindow::on_actionNew_triggered()
 {
     currentFileName.clear();
     this->setWindowTitle(QString("FVD++ - unsaved Work"));
+    mNodeCache->clear();
     ui->projectTab->init();
 }
 
@@ -186,6 +206,7 @@ void MainWindow::addProject(QString fileName) {
 void MainWindow::loadProject(QString fileName)
 {
     currentFileName.clear();
+    mNodeCache->clear();
 
     saver* gott = new saver(fileName, ui->projectTab, this);
     QString output = gott->doLoad();
@@ -211,6 +232,45 @@ void MainWindow::loadProject(QString fileName)
     this->setWindowTitle(QString("FVD++ - " + currentFileName));
 }
 
+// headless node data export, loads the project without dialogs and returns a process exit code
+// runs without ever showing the window, so the project is loaded without textures, meshes or
+// dialogs. Results go straight to stdout and stderr instead of through the message handler.
+// returns 0 on success, 1 if the project could not be loaded, 2 for an unknown track
+// and 3 if the export failed
+int MainWindow::exportNodes(QString fileName, QString exportName, int trackIndex, bool csv)
+{
+    saver* gott = new saver(fileName, ui->projectTab, this);
+    QString output = gott->doLoad();
+    delete gott;
+
+    if(output.contains("Error:")) {
+        fprintf(stderr, "%s\n", qPrintable(output));
+        return 1;
+    }
+    if(output.contains("Warning:")) {
+        fprintf(stderr, "%s\n", qPrintable(output));
+    }
+
+    QList<trackHandler*> tracks = getTrackList();
+    if(trackIndex < 0 || trackIndex >= tracks.size() || tracks[trackIndex]->trackData->lSections.isEmpty()) {
+        fprintf(stderr, "Error: project has no track %d to export\n", trackIndex+1);
+        return 2;
+    }
+
+    track* tTrack = tracks[trackIndex]->trackData;
+    exportJob job(csv ? exportNodeCSV : exportNodeBinary, tTrack->snapshot(), exportName);
+    job.fromIndex = 0;
+    job.toIndex = tTrack->lSections.size()-1;
+
+    output = job.run();
+    if(output.contains("Error:")) {
+        fprintf(stderr, "%s\n", qPrintable(output));
+        return 3;
+    }
+    fprintf(stdout, "%s\n", qPrintable(output));
+    return 0;
+}
+
 #ifdef Q_OS_MAC
 void MainWindow::on_actionLoad_triggered(QString fileName)
 {
@@ -275,14 +335,63 @@ void MainWindow::on_actionSave_triggered()
 
 void MainWindow::backupSave()
 {
-    if(currentFileName.isEmpty()) {
+    QString fileName;
+    QList<chunkBlock_t> blocks;
+    int serial;
+    if(backupSnapshot(fileName, blocks, serial)) {
+        backupWatcher.setFuture(QtConcurrent::run(this, &MainWindow::writeBackup, serial, fileName, blocks));
+    }
+}
+
+// only edited sections are serialized here, the file is put together on a worker thread.
+// returns false if there is nothing to autosave
+bool MainWindow::backupSnapshot(QString& fileName, QList<chunkBlock_t>& blocks, int& serial)
+{
+    if(loading || currentFileName.isEmpty() || backupWatcher.isRunning()) {
+        return false;
+    }
+    QString name = QString().append(currentFileName).append(".bak");
+
+    if(name == backupFileName && !ui->projectTab->needsBackup()) {
+        return false; // nothing changed since the last autosave
+    }
+    backupFileName = name;
+
+    fileName = name;
+    blocks = ui->projectTab->backupChunks();
+    serial = ++backupSerial;
+    return true;
+}
+
+// called on worker threads, writes one snapshot at a time and drops snapshots older than the
+// one on disk. Returns an empty string for a dropped snapshot
+QString MainWindow::writeBackup(int serial, QString fileName, QList<chunkBlock_t> blocks)
+{
+    QMutexLocker locker(&backupMutex);
+    if(serial < backupWritten) {
+        return QString();
+    }
+    backupWritten = serial;
+    return saver::writeBlocks(fileName, blocks);
+}
+
+void MainWindow::onBackupSaved()
+{
+    backupFinished(backupWatcher.result());
+}
+
+void MainWindow::backupFinished(QString output)
+{
+    if(output.isEmpty()) {
+        return;
+    }
+    if(output.contains("Error:")) {
+        ui->projectTab->unsavedChanges = true;
+        showMessage(output);
         return;
     }
-    saver* gott = new saver(QString().append(currentFileName).append(".bak"), ui->projectTab, this);
-    gott->doSave();
-    delete gott;
     this->setWindowTitle(QString("FVD++ - " + currentFileName));
-    showMessage(QString("Executed autosave to ").append(currentFileName).append(".bak"));
+    showMessage(QString("Executed autosave to ").append(backupFileName));
 }
 
 void MainWindow::on_actionSave_As_triggered()
@@ -599,6 +708,7 @@ QString MainWindow::getCurrentFileName() {
 
 void MainWindow::openTab(trackHandler* _track)
 {
+    _track->trackData->materialize();
     this->setUpdatesEnabled(false);
     _track->trackWidgetItem->on_sectionListWidget_itemSelectionChanged();
     if(_track->tabId == -1) {
@@ -706,12 +816,18 @@ void MainWindow::showAll()
 
 void MainWindow::on_actionExport_Model_As_triggered()
 {
+    if(loading) {
+        return;
+    }
     mObjectExporter->update();
     mObjectExporter->show();
 }
 
 void MainWindow::on_actionExport_triggered()
 {
+    if(loading) {
+        return;
+    }
     if(exportScreen->updateBoxes()) {
         exportScreen->doFastExport();
     } else {
@@ -31,6 +31,8 @@
 
 #include <fstream>
 #include <QStyledItemDelegate>
+#include <QFutureWatcher>
+#include <QMutex>
 
 
 // some defines
@@ -66,6 +68,8 @@
 class exportUi;
 class undoHandler;
 class optionsMenu;
+class nodeCache;
+class exportQueue;
 class conversionPanel;
 class graphWidget;
 class trackHandler;
@@ -84,6 +88,9 @@ public:
     ~MainWindow();
 
     void backupSave();
+    bool backupSnapshot(QString& fileName, QList<chunkBlock_t>& blocks, int& serial);
+    QString writeBackup(int serial, QString fileName, QList<chunkBlock_t> blocks);
+    void backupFinished(QString output);
     void setUndoButtons();
     void updateBoxes();
     void displayStatusMessage(QString message);
@@ -102,6 +109,7 @@ public:
     void showAll();
     void addProject(QString fileName);
     void loadProject(QString fileName);
+    int exportNodes(QString fileName, QString exportName, int trackIndex, bool csv);
 
     void updateProjectWidget();
 
@@ -112,11 +120,14 @@ public:
     subfunc* selectedFunc;
     QTreeWidgetItem* selectedSection;
     optionsMenu* mOptions;
+    nodeCache* mNodeCache;
+    exportQueue* mExportQueue;
     graphWidget* mGraphWidget;
 
     projectWidget* project;
 
     bool undoChanges;
+    bool loading; // tracks are integrated on the thread pool, nothing may read their nodes
 
 signals:
     void emitMessage(QString msg, int msec = 5000);
@@ -169,6 +180,8 @@ public slots:
 
     void doAutoSave();
 
+    void onBackupSaved();
+
     void showMessage(QString msg, int msec = 5000);
 
 private slots:
@@ -183,6 +196,11 @@ private:
 
     bool phantomChanges;
     QString     currentFileName;
+    QFutureWatcher<QString> backupWatcher;
+    QString     backupFileName;
+    QMutex      backupMutex;    // the timer autosave and export jobs write the same .bak
+    int         backupSerial;   // taken on the gui thread for every snapshot
+    int         backupWritten;  // guarded by backupMutex
     exportUi* exportScreen;
     conversionPanel* mConversion;
     objectExporter* mObjectExporter;
@@ -25,9 +25,12 @@
 #include <string.h>
 #include <math.h>
 #include <QFileDialog>
+#include "parallel.h"
 
 #include "mainwindow.h"
+#include "optionsmenu.h"
 #include "trackmesh.h"
+#include "meshexporter.h"
 
 extern MainWindow* gloParent;
 
@@ -68,19 +71,83 @@ bool objectExporter::update()
     }
 }
 
+// builds the 3ds meshes of one section straight into lib3ds arrays, lib3ds meshes are plain
+// allocations until they are inserted into the file, so sections can be built concurrently
+static void buildSectionMeshes(trackMesh* mesh, int quality, int section, QList<Lib3dsMesh*>& meshes)
+{
+    QVector<float> vertices;
+    QVector<unsigned int> indices;
+    QVector<unsigned int> borders;
+    mesh->build3ds(section, quality, &vertices, &indices, &borders);
+
+    for(int subIndex = 0; subIndex < borders.size()-2; subIndex += 2) {
+        int fromVIndex = borders[subIndex]/3;
+        int toVIndex = borders[subIndex+2]/3;
+        int fromIIndex = borders[subIndex+1]/3;
+        int toIIndex = borders[subIndex+3]/3;
+
+        QString name = QString::number(section).append(QString("_").append(QString::number(subIndex/2)));
+        Lib3dsMesh* subMesh = lib3ds_mesh_new(name.toLocal8Bit().constData());
+
+        // swaps into the z-up system of 3ds on the way in
+        lib3ds_mesh_resize_vertices(subMesh, toVIndex-fromVIndex, 1, 0);
+        const float* src = vertices.constData() + 3*fromVIndex;
+        for(int i = 0; i < toVIndex-fromVIndex; ++i) {
+            subMesh->vertices[i][0] = src[3*i+0];
+            subMesh->vertices[i][1] = -src[3*i+2];
+            subMesh->vertices[i][2] = src[3*i+1];
+            subMesh->texcos[i][0] = 0.f;
+            subMesh->texcos[i][1] = 0.f;
+        }
+
+        lib3ds_mesh_resize_faces(subMesh, toIIndex-fromIIndex);
+        const unsigned int* face = indices.constData() + 3*fromIIndex;
+        for(int i = 0; i < toIIndex-fromIIndex; ++i) {
+            for(int j = 0; j < 3; ++j) {
+                subMesh->faces[i].index[j] = face[3*i+j]-fromVIndex;
+            }
+            subMesh->faces[i].material = 0;
+        }
+        meshes.append(subMesh);
+    }
+}
+
+struct sectionMeshBuilder {
+    trackMesh* mesh;
+    int quality;
+    QList<Lib3dsMesh*>* results;
+
+    void operator()(int, int from, int to) const {
+        for(int section = from; section < to; ++section) {
+            buildSectionMeshes(mesh, quality, section, results[section]);
+        }
+    }
+};
+
 // TODO: Build own exporter class
 void objectExporter::on_buttonBox_accepted()
 {
-    QString fileName = QFileDialog::getSaveFileName(gloParent, "Save 3ds Object", ".", "3D Object (*.3ds)", 0, 0);
+    if(gloParent->loading) return;
+
+    QString selectedFilter;
+    QString fileName = QFileDialog::getSaveFileName(gloParent, "Save 3D Object", ".", "3D Object (*.3ds);;Binary glTF (*.glb);;Stanford Polygon (*.ply)", &selectedFilter, 0);
+    if(fileName.isEmpty()) return;
 
     QList<trackHandler*> trackList = gloParent->getTrackList();
     trackHandler* curTrack = trackList[ui->trackBox->currentIndex()];
+    curTrack->trackData->materialize();
 
-    trackMesh* mesh = curTrack->mMesh;
-
-    QVector<float> *vertices = new QVector<float>();
-    QVector<unsigned int> *indices = new QVector<unsigned int>();
-    QVector<unsigned int> *borders = new QVector<unsigned int>();
+    // glb and ply take the indexed render geometry as it is, 3ds needs its own meshes below
+    if(selectedFilter.contains("glb") || fileName.endsWith(".glb", Qt::CaseInsensitive)) {
+        meshExporter exporter(curTrack->mMesh);
+        gloParent->displayStatusMessage(exporter.saveGlb(fileName, curTrack->trackColors[0], curTrack->supportColor));
+        return;
+    }
+    if(selectedFilter.contains("ply") || fileName.endsWith(".ply", Qt::CaseInsensitive)) {
+        meshExporter exporter(curTrack->mMesh);
+        gloParent->displayStatusMessage(exporter.savePly(fileName));
+        return;
+    }
 
     Lib3dsFile *file = lib3ds_file_new();
     file->frames = 360;
@@ -94,50 +161,23 @@ void objectExporter::on_buttonBox_accepted()
     }
 
     {
-        for(int section = 0; section < curTrack->trackData->lSections.size(); ++section) {
-            vertices->clear();
-            indices->clear();
-            borders->clear();
-            mesh->build3ds(section, vertices, indices, borders);
-
-            float* fvertices = new float[vertices->size()];
-            for(int i = 0; i < vertices->size()/3; ++i) {
-                fvertices[3*i+0] = vertices->at(3*i+0);
-                fvertices[3*i+1] = -vertices->at(3*i+2);
-                fvertices[3*i+2] = vertices->at(3*i+1);
-
-                //exportScreen->doFastExport();
-            }
-            for(int subIndex = 0; subIndex < borders->size()-2; subIndex+= 2) {
-                int fromVIndex = borders->at(subIndex)/3;
-                int toVIndex = borders->at(subIndex+2)/3;
-                int fromIIndex = borders->at(subIndex+1)/3;
-                int toIIndex = borders->at(subIndex+3)/3;
-
-                int i, j;
-                QString name = QString::number(section).append(QString("_").append(QString::number(subIndex/2)));
-                Lib3dsMesh *mesh = lib3ds_mesh_new(name.toLocal8Bit().data());
-                Lib3dsMeshInstanceNode *inst;
+        int numSections = curTrack->trackData->lSections.size();
+        QVector<QList<Lib3dsMesh*> > meshes(numSections);
+
+        sectionMeshBuilder builder;
+        builder.mesh = curTrack->mMesh;
+        builder.quality = gloParent->mOptions->meshQuality;
+        builder.results = meshes.data();
+        parallelChunks(numSections, 1, builder);
+
+        // the file itself is not thread safe, meshes are inserted in section order
+        for(int section = 0; section < numSections; ++section) {
+            for(int i = 0; i < meshes[section].size(); ++i) {
+                Lib3dsMesh* mesh = meshes[section][i];
                 lib3ds_file_insert_mesh(file, mesh, -1);
-
-                lib3ds_mesh_resize_vertices(mesh, toVIndex-fromVIndex, 1, 0);
-                for (i = 0; i < toVIndex-fromVIndex; ++i) {
-                    lib3ds_vector_copy(mesh->vertices[i], &fvertices[(i+fromVIndex)*3]);
-                    mesh->texcos[i][0] = 0.f;
-                    mesh->texcos[i][1] = 0.f;
-                }
-
-                lib3ds_mesh_resize_faces(mesh, toIIndex-fromIIndex);
-                for (i = 0; i < toIIndex-fromIIndex; ++i) {
-                    for (j = 0; j < 3; ++j) {
-                        mesh->faces[i].index[j] = indices->at(3*(i+fromIIndex)+j)-fromVIndex;
-                        mesh->faces[i].material = 0;
-                    }
-                }
-                inst = lib3ds_node_new_mesh_instance(mesh, name.toLocal8Bit().data(), NULL, NULL, NULL);
+                Lib3dsMeshInstanceNode* inst = lib3ds_node_new_mesh_instance(mesh, mesh->name, NULL, NULL, NULL);
                 lib3ds_file_append_node(file, (Lib3dsNode*)inst, NULL);
             }
-            delete[] fvertices;
         }
     }
 
@@ -172,7 +212,4 @@ void objectExporter::on_buttonBox_accepted()
          qDebug("ERROR: Saving 3ds file failed!\n");
     }
     lib3ds_file_free(file);
-
-    delete indices;
-    delete vertices;
 }
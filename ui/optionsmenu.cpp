@@ -25,6 +25,7 @@
 #include "glviewwidget.h"
 #include "mainwindow.h"
 #include "trackmesh.h"
+#include "nodecache.h"
 
 extern MainWindow* gloParent;
 extern glViewWidget* glView;
@@ -34,6 +35,10 @@ optionsMenu::optionsMenu(QWidget *parent) :
     ui(new Ui::optionsMenu)
 {
     maxUndoChanges = 50000;
+    nodeCacheSize = 256;
+    nodeCacheCompress = false;
+    projectNodeCache = true;
+    pointListTolerance = 0.f;
     phantomChanges = false;
 
 #ifdef Q_OS_MAC
@@ -144,6 +149,10 @@ optionsMenu::optionsMenu(QWidget *parent) :
     ui->fovSlider->setValue(fov*10);
     ui->shadowModeBox->setCurrentIndex(shadowQuality);
     ui->meshQualityBox->setCurrentIndex(meshQuality);
+    ui->nodeCacheBox->setValue(nodeCacheSize);
+    ui->nodeCacheCompressBox->setChecked(nodeCacheCompress);
+    ui->projectNodeCacheBox->setChecked(projectNodeCache);
+    ui->pointListToleranceBox->setValue(pointListTolerance);
     phantomChanges = false;
     this->ui->measureBox->setCurrentIndex(measures);
 #ifndef Q_OS_MAC // on Win / Unix
@@ -534,6 +543,8 @@ void optionsMenu::onYawColor3_received()
 void optionsMenu::on_buttonBox_accepted()
 {
     saveToOptionsFile();
+    gloParent->mNodeCache->setBudget((qint64)nodeCacheSize*1024*1024);
+    gloParent->mNodeCache->compressCold = nodeCacheCompress;
     gloParent->updateInfoPanel();
 }
 
@@ -572,6 +583,10 @@ void optionsMenu::saveToOptionsFile()   // Ercan: Config file Erstellung hier
     fout << "nSelYawBack " << yawColor[1].red() << " " << yawColor[1].green() << " " << yawColor[1].blue() << " " << yawColor[1].alpha() << "\n";
     fout << "selYawLine " << yawColor[2].red() << " " << yawColor[2].green() << " " << yawColor[2].blue() << " " << yawColor[2].alpha() << "\n";
     fout << "selYawBack " << yawColor[3].red() << " " << yawColor[3].green() << " " << yawColor[3].blue() << " " << yawColor[3].alpha() << "\n";
+    fout << "nodeCacheSize " << nodeCacheSize << "\n";
+    fout << "nodeCacheCompress " << nodeCacheCompress << "\n";
+    fout << "projectNodeCache " << projectNodeCache << "\n";
+    fout << "pointListTolerance " << pointListTolerance << "\n";
 
     fout.close();
 }
@@ -901,6 +916,28 @@ bool optionsMenu::loadFromOptionsFile()   // Ercan: Config file Auslesen hier
     yawColor[3].setAlpha(QString(input).toInt(&ok));
     if(!ok) return false;
 
+    // optional, older options files end here
+    fin >> input;
+    if(fin >> input) {
+        int value = QString(input).toInt(&ok);
+        if(ok) nodeCacheSize = value;
+    }
+    fin >> input;
+    if(fin >> input) {
+        int value = QString(input).toInt(&ok);
+        if(ok) nodeCacheCompress = value;
+    }
+    fin >> input;
+    if(fin >> input) {
+        int value = QString(input).toInt(&ok);
+        if(ok) projectNodeCache = value;
+    }
+    fin >> input;
+    if(fin >> input) {
+        float value = QString(input).toFloat(&ok);
+        if(ok) pointListTolerance = value;
+    }
+
     fin.close();
     return true;
 }
@@ -977,6 +1014,27 @@ void optionsMenu::on_meshQualityBox_currentIndexChanged(int index)
     QList<trackHandler*> TL = gloParent->getTrackList();
     for(int i = 0; i < TL.size(); ++i)
     {
-        TL[i]->mMesh->buildMeshes(0);
+        // tracks that are still loading get their meshes once they are published
+        if(TL[i]->trackData->materialized) TL[i]->mMesh->buildMeshes(0);
     }
 }
+
+void optionsMenu::on_nodeCacheBox_valueChanged(int arg1)
+{
+    nodeCacheSize = arg1;
+}
+
+void optionsMenu::on_nodeCacheCompressBox_stateChanged(int arg1)
+{
+    nodeCacheCompress = arg1;
+}
+
+void optionsMenu::on_projectNodeCacheBox_stateChanged(int arg1)
+{
+    projectNodeCache = arg1;
+}
+
+void optionsMenu::on_pointListToleranceBox_valueChanged(double arg1)
+{
+    pointListTolerance = arg1;
+}
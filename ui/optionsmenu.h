@@ -62,6 +62,10 @@ public:
 
 
     int maxUndoChanges;
+    int nodeCacheSize;      // MB, 0 disables the node cache
+    bool nodeCacheCompress;
+    bool projectNodeCache;  // store computed nodes in project files
+    float pointListTolerance;   // degrees, imported point lists keep every point at 0
     int measures;
     int glPolicy;
     QColor rollColor[4];
@@ -141,6 +145,14 @@ private slots:
 
     void on_meshQualityBox_currentIndexChanged(int index);
 
+    void on_nodeCacheBox_valueChanged(int arg1);
+
+    void on_nodeCacheCompressBox_stateChanged(int arg1);
+
+    void on_projectNodeCacheBox_stateChanged(int arg1);
+
+    void on_pointListToleranceBox_valueChanged(double arg1);
+
 private:
     Ui::optionsMenu *ui;
 
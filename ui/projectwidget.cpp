@@ -21,6 +21,7 @@
 #include <QtCore>
 #include "trackhandler.h"
 #include "exportfuncs.h"
+#include "projectfile.h"
 #include "importui.h"
 #include "undohandler.h"
 #include "nolimitsimporter.h"
@@ -30,6 +31,8 @@
 #include "trackproperties.h"
 #include "lenassert.h"
 #include "trackwidget.h"
+#include "trackloader.h"
+#include "optionsmenu.h"
 #include <QMenu>
 #include <QFileDialog>
 #include <QMessageBox>
@@ -49,6 +52,7 @@ projectWidget::projectWidget(QWidget *parent) :
     ui->setupUi(this);
     texPath = QString(":/background.png");
     ui->texEdit->setText(texPath);
+    unsavedChanges = true;
 
 
     ui->trackListWidget->setItemDelegateForColumn(0, new NoEditDelegate(this));
@@ -240,7 +244,7 @@ void projectWidget::importPointList()
         newEmptyTrack();
         trackHandler* newTrack = trackList.back();
         noLimitsImporter* importer = new noLimitsImporter(newTrack, fileName);
-        importer->importAsTxt();
+        importer->importAsTxt(gloParent->mOptions->pointListTolerance);
         delete importer;
     }
 }
@@ -259,6 +263,9 @@ void projectWidget::appendTracks(QList<trackHandler *> &_list)
         trackList[i]->changeID(i+1);
         ++i;
     }
+
+    trackLoader loader(_list, gloParent);
+    loader.run();
 }
 
 void projectWidget::on_deleteButton_released()
@@ -272,6 +279,7 @@ void projectWidget::on_deleteButton_released()
                 break;
             }
         }
+        unsavedChanges = true;
         while(i < trackList.size()) {
             trackList[i]->changeID(trackList[i]->getID()-1);
             ++i;
@@ -317,11 +325,13 @@ void projectWidget::on_trackListWidget_itemChanged(QTreeWidgetItem *item, int co
         return;
     case 1:
         trackList[index]->trackData->name = item->text(1);
+        unsavedChanges = true;
         if(trackList[index]->trackWidgetItem) gloParent->renameTab(trackList[index]);
         return;
     case 2:
         if(item->checkState(2) == Qt::Checked) {
             trackList[index]->trackData->drawTrack = true;
+            trackList[index]->trackData->materialize();
         } else {
             trackList[index]->trackData->drawTrack = false;
         }
@@ -355,27 +365,60 @@ bool projectWidget::areYouSure()
     }
 }
 
-QString projectWidget::saveProject(std::fstream& file)
+QString projectWidget::saveProject(std::ostream& file, bool withNodes)
 {
     file << "FVD";
-    file << "v0.77";
-
-    int namelength = texPath.length();
-    std::string stdName = texPath.toStdString();
-
-    writeBytes(&file, (const char*)&namelength, sizeof(int));
-    file << stdName;
+    file << CHUNK_VERSION;
 
+    chunkWriter writer(&file);
+    saveTexture(writer);
 
     for(int i = 0; i < this->trackList.size(); ++i) {
         trackList[i]->trackWidgetItem->writeNames();
-        trackList[i]->trackData->saveTrack(file, trackList[i]->trackWidgetItem);
+        trackList[i]->trackData->saveTrack(writer, i, trackList[i]->trackWidgetItem, withNodes);
     }
 
-    file << "EOP";
+    writer.finish();
     return QString("Project Saved!");
 }
 
+// the project without nodes in blocks for saver::writeBlocks(), the texture path first and then one block per track
+QList<chunkBlock_t> projectWidget::backupChunks()
+{
+    QList<chunkBlock_t> blocks;
+
+    std::stringstream stream;
+    chunkWriter writer(&stream, false);
+    saveTexture(writer);
+    blocks.append(makeBlock(stream, writer.toc));
+
+    for(int i = 0; i < this->trackList.size(); ++i) {
+        blocks.append(trackList[i]->trackData->backupChunks(i, trackList[i]->trackWidgetItem));
+    }
+    unsavedChanges = false;
+    return blocks;
+}
+
+bool projectWidget::needsBackup()
+{
+    if(unsavedChanges) return true;
+    for(int i = 0; i < this->trackList.size(); ++i) {
+        if(trackList[i]->trackData->unsavedChanges) return true;
+    }
+    return false;
+}
+
+void projectWidget::saveTexture(chunkWriter& writer)
+{
+    int namelength = texPath.length();
+    std::string stdName = texPath.toStdString();
+
+    writer.beginChunk("TEXP");
+    writeBytes(writer.file, (const char*)&namelength, sizeof(int));
+    *writer.file << stdName;
+    writer.endChunk();
+}
+
 QString projectWidget::loadProject(std::fstream& file)
 {
     int errType = -1;
@@ -387,21 +430,34 @@ QString projectWidget::loadProject(std::fstream& file)
         legacy = 1;
     } else if(temp == "v0.77") {
         legacy = 0;
+    } else if(temp == CHUNK_VERSION) {
+        legacy = 2;
     } else {
         legacy = -1;
     }
 
     this->cleanUp();
-    if(legacy > -1) { // supported versions
-        int namelength = readInt(&file);
-        texPath = QString(readString(&file, namelength).c_str());
+    if(legacy == 2) {
+        QList<chunk_t> toc;
+        const chunk_t* texChunk = NULL;
+        if(!readToc(file, toc) || (texChunk = findChunk(toc, "TEXP")) == NULL || !seekChunk(file, *texChunk)) {
+            errType = 11;
+        } else {
+            errType = loadTexture(file);
 
-        if(!glView->loadGroundTexture(texPath)) { // error while Loading
-            texPath = QString(":/background.png");
-            glView->loadGroundTexture(texPath);
-            errType = 1;
+            int count = numTracks(toc);
+            for(int i = 0; i < count; ++i) {
+                newEmptyTrack();
+                QString result = trackList[i]->trackData->loadTrack(file, trackChunks(toc, i), trackList[i]->trackWidgetItem);
+                if(result.startsWith("Error")) {
+                    errType = 11;
+                    break;
+                }
+                finishTrack(trackList[i]);
+            }
         }
-        ui->texEdit->setText(texPath);
+    } else if(legacy > -1) { // supported versions
+        errType = loadTexture(file);
 
         int i = 0;
         while(1) {
@@ -411,20 +467,12 @@ QString projectWidget::loadProject(std::fstream& file)
                 if(legacy == 1) {
                     trackList[i]->trackData->legacyLoadTrack(file, trackList[i]->trackWidgetItem);
                     errType = 0;
+                    trackList[i]->listItem->setText(1, trackList[i]->trackData->name);
+                    trackList[i]->mUndoHandler->clearActions();
                 } else {
                     trackList[i]->trackData->loadTrack(file, trackList[i]->trackWidgetItem);
-
-                    trackWidget* _widget = trackList[i]->trackWidgetItem;
-                    if(!_widget->smoothScreen) {
-                        _widget->smoothScreen = new smoothUi(trackList[i], gloParent);
-                        trackList[i]->trackData->smoother = _widget->smoothScreen;
-                    }
-
-                    _widget->smoothScreen->updateUi();
-                    _widget->smoothScreen->applyRollSmooth();
+                    finishTrack(trackList[i]);
                 }
-                trackList[i]->listItem->setText(1, trackList[i]->trackData->name);
-                trackList[i]->mUndoHandler->clearActions();
             }
             else if(temp == "EOP") {
                 break;
@@ -438,11 +486,17 @@ QString projectWidget::loadProject(std::fstream& file)
         errType = 10;
     }
 
+    // hidden tracks are integrated once they are shown, opened or exported
     for(int i = 0; i < trackList.size(); ++i) {
         if(trackList[i]->trackData->drawTrack == false) {
             trackList[i]->listItem->setCheckState(2, Qt::Unchecked);
         }
     }
+    // headless loads show no progress dialog, the exported track is integrated on demand
+    if(errType < 10 && glView->hasContext()) {
+        trackLoader loader(trackList, gloParent);
+        if(!loader.run() && errType == -1) errType = 2;
+    }
 
     switch(errType) {
     case -1:
@@ -451,6 +505,8 @@ QString projectWidget::loadProject(std::fstream& file)
         return QString("Warning: Loaded old File Version. Please save to convert to new File version!");
     case 1:
         return QString("Warning: Could Not find corresponding texture. Loaded default texture instead.");
+    case 2:
+        return QString("Warning: Loading canceled. Remaining tracks were hidden and are computed once they are shown.");
     case 10:
         this->cleanUp();
         return QString("Error: Unsupported File Version!");
@@ -461,6 +517,37 @@ QString projectWidget::loadProject(std::fstream& file)
     return QString();
 }
 
+int projectWidget::loadTexture(std::fstream& file)
+{
+    int namelength = readInt(&file);
+    texPath = QString(readString(&file, namelength).c_str());
+
+    int errType = -1;
+    if(!glView->hasContext()) { // headless, the texture is only kept for saving
+        ui->texEdit->setText(texPath);
+        return errType;
+    }
+    if(!glView->loadGroundTexture(texPath)) { // error while Loading
+        texPath = QString(":/background.png");
+        glView->loadGroundTexture(texPath);
+        errType = 1;
+    }
+    ui->texEdit->setText(texPath);
+    return errType;
+}
+
+void projectWidget::finishTrack(trackHandler* _track)
+{
+    trackWidget* _widget = _track->trackWidgetItem;
+    if(!_widget->smoothScreen) {
+        _widget->smoothScreen = new smoothUi(_track, gloParent);
+        _track->trackData->smoother = _widget->smoothScreen;
+    }
+
+    _track->listItem->setText(1, _track->trackData->name);
+    _track->mUndoHandler->clearActions();
+}
+
 void projectWidget::on_texChooser_released()
 {
 #ifdef Q_OS_MAC
@@ -485,6 +572,7 @@ void projectWidget::on_texChooser_released()
         if(fileName.endsWith(".png")) {
             texPath = relPath;
             ui->texEdit->setText(texPath);
+            unsavedChanges = true;
             glView->loadGroundTexture(texPath);
         } else {
             QMessageBox::warning(this, tr("Application"),
@@ -20,6 +20,7 @@
 */
 
 #include <QWidget>
+#include "projectfile.h"
 
 class trackHandler;
 class QTreeWidgetItem;
@@ -36,7 +37,9 @@ class projectWidget : public QWidget
     
 public:
     explicit projectWidget(QWidget *parent = 0);
-    QString saveProject(std::fstream& file);
+    QString saveProject(std::ostream& file, bool withNodes = true);
+    QList<chunkBlock_t> backupChunks();
+    bool needsBackup();
     QString loadProject(std::fstream& file);
     ~projectWidget();
     void init();
@@ -47,6 +50,7 @@ public:
     QList<trackHandler*> trackList;
     trackHandler* selTrack;
     QString texPath;
+    bool unsavedChanges;    // tracks removed or renamed or texture changed since the last autosave
 
 
 public slots:
@@ -87,6 +91,9 @@ private:
     bool phantomChanges;
     Ui::projectWidget *ui;
     int getTrack(QTreeWidgetItem *item);
+    int loadTexture(std::fstream& file);
+    void saveTexture(chunkWriter& writer);
+    void finishTrack(trackHandler* _track);
     bool areYouSure();
     TrackProperties* properties;
 };
@@ -115,6 +115,7 @@ void smoothUi::applyRollSmooth(int fromNode)
     }
     m_widget->redrawGraphs();
     m_track->hasChanged = true;
+    m_track->unsavedChanges = true;
     return;
 }
 
@@ -0,0 +1,105 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "trackloader.h"
+#include "trackhandler.h"
+#include "track.h"
+#include "mainwindow.h"
+#include <QtConcurrent>
+#include <QProgressDialog>
+#include <QTreeWidgetItem>
+
+extern MainWindow* gloParent;
+extern glViewWidget* glView;
+
+trackLoader::trackLoader(QList<trackHandler*> _tracks, QWidget* _parent)
+{
+    for(int i = 0; i < _tracks.size(); ++i) {
+        if(_tracks[i]->trackData->drawTrack && !_tracks[i]->trackData->materialized) {
+            pending.append(_tracks[i]);
+        }
+    }
+
+    progress = new QProgressDialog(QString("Computing Tracks..."), QString("Cancel"), 0, pending.size(), _parent);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(500);
+
+    connect(&watcher, SIGNAL(resultReadyAt(int)), this, SLOT(onResultReady(int)));
+    connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+    connect(progress, SIGNAL(canceled()), this, SLOT(onCanceled()));
+}
+
+trackLoader::~trackLoader()
+{
+    delete progress;
+}
+
+// returns false if the user canceled before every track was published
+bool trackLoader::run()
+{
+    if(pending.isEmpty()) return true;
+
+    // keep the renderer away from tracks that are still being integrated
+    for(int i = 0; i < pending.size(); ++i) {
+        pending[i]->trackData->drawTrack = false;
+    }
+
+    // the project is fully parsed here, so finished tracks can be drawn right away
+    bool paintMode = glView->paintMode;
+    glView->paintMode = true;
+
+    // the nested loop keeps the timers running, autosave and exports check this and skip
+    gloParent->loading = true;
+
+    progress->setValue(0);
+    watcher.setFuture(QtConcurrent::mapped(pending, &trackLoader::integrate));
+    loop.exec();
+    watcher.waitForFinished();
+    progress->setValue(pending.size());
+
+    gloParent->loading = false;
+    glView->paintMode = paintMode;
+
+    // canceled tracks are hidden and get integrated once they are shown again
+    for(int i = 0; i < pending.size(); ++i) {
+        if(published.contains(pending[i])) continue;
+        pending[i]->trackData->drawTrack = true;
+        pending[i]->listItem->setCheckState(2, Qt::Unchecked);
+    }
+    return published.size() == pending.size();
+}
+
+void trackLoader::onResultReady(int index)
+{
+    trackHandler* cur = watcher.resultAt(index);
+    cur->trackData->publish();
+    cur->trackData->drawTrack = true;
+    published.append(cur);
+    progress->setValue(published.size());
+}
+
+void trackLoader::onCanceled()
+{
+    watcher.cancel();
+}
+
+trackHandler* trackLoader::integrate(trackHandler* _track)
+{
+    _track->trackData->integrate();
+    return _track;
+}
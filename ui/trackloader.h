@@ -0,0 +1,54 @@
+#ifndef TRACKLOADER_H
+#define TRACKLOADER_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QObject>
+#include <QList>
+#include <QFutureWatcher>
+#include <QEventLoop>
+
+class trackHandler;
+class QProgressDialog;
+
+// integrates loaded tracks on the thread pool and publishes every track to the
+// ui and renderer as soon as its nodes are done
+class trackLoader : public QObject
+{
+    Q_OBJECT
+public:
+    trackLoader(QList<trackHandler*> _tracks, QWidget* _parent);
+    ~trackLoader();
+    bool run();
+
+private slots:
+    void onResultReady(int index);
+    void onCanceled();
+
+private:
+    static trackHandler* integrate(trackHandler* _track);
+
+    QList<trackHandler*> pending;
+    QList<trackHandler*> published;
+    QFutureWatcher<trackHandler*> watcher;
+    QProgressDialog* progress;
+    QEventLoop loop;
+};
+
+#endif // TRACKLOADER_H
@@ -1271,7 +1271,10 @@ void trackWidget::on_sectionListWidget_itemChanged(QTreeWidgetItem *item, int co
     Q_UNUSED(item);
     if(phantomChanges) return;
 
-    if(column == 1) writeNames();
+    if(column == 1) {
+        writeNames();
+        inTrack->trackData->unsavedChanges = true;
+    }
 }
 
 void trackWidget::update()